@@ -0,0 +1,203 @@
+#include "BatchRunner.hpp"
+
+#include <random>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <utility>
+
+namespace wotmin2d {
+
+namespace {
+
+// Returns the lowest and highest coordinate along an arena side of the given
+// length at which a circle of the radius is still inside the arena.
+std::pair<int, int> centerRange(unsigned int side, float radius) {
+    int margin = static_cast<int>(radius) + 1;
+    return std::make_pair(margin, static_cast<int>(side) - margin - 1);
+}
+
+// Returns the end of the range farther from the coordinate.
+int fartherEnd(const std::pair<int, int>& range, int coordinate) {
+    if (coordinate - range.first < range.second - coordinate) {
+        return range.second;
+    }
+    return range.first;
+}
+
+}
+
+// Returns whether two blobs of up to the maximum radius can be placed apart
+// from each other wherever the first one is put. The corner of the second
+// blob's center range that is farthest from the first blob is at least half
+// the diagonal of the range away, and the range only grows for smaller blobs.
+bool BatchRunner::fitsArena(const Settings& settings) {
+    std::pair<int, int> x = centerRange(settings.arena_width,
+                                        settings.max_radius);
+    std::pair<int, int> y = centerRange(settings.arena_height,
+                                        settings.max_radius);
+    if (x.second < x.first || y.second < y.first) {
+        return false;
+    }
+    float half_diagonal = std::hypot(static_cast<float>(x.second - x.first),
+                                     static_cast<float>(y.second - y.first))
+                          / 2.0f;
+    return half_diagonal > 2.0f * settings.max_radius + 2.0f;
+}
+
+BatchRunner::BatchRunner(const Settings& settings) :
+    settings(settings) {
+    assert(settings.min_radius > 0.0f
+           && settings.min_radius <= settings.max_radius);
+    assert(fitsArena(settings) && "Blobs don't fit the arena.");
+    assert(settings.retarget_interval > 0);
+}
+
+const BatchRunner::Settings& BatchRunner::getSettings() const {
+    return settings;
+}
+
+// Places two circular blobs of random radius at random positions where they
+// don't overlap. If none of the random positions for the second blob fit, it
+// is put in the corner farthest from the first one, which fitsArena()
+// guarantees is far enough, so blobs are never shrunk below the minimum
+// radius.
+Scenario BatchRunner::makeScenario(std::uint64_t trial) const {
+    std::seed_seq seed{static_cast<std::uint32_t>(settings.seed),
+                       static_cast<std::uint32_t>(settings.seed >> 32),
+                       static_cast<std::uint32_t>(trial),
+                       static_cast<std::uint32_t>(trial >> 32)};
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<float> radius_distribution(
+        settings.min_radius, settings.max_radius);
+    auto randomCenter = [&](float radius) {
+        std::pair<int, int> x_range = centerRange(settings.arena_width,
+                                                  radius);
+        std::pair<int, int> y_range = centerRange(settings.arena_height,
+                                                  radius);
+        std::uniform_int_distribution<int> x(x_range.first, x_range.second);
+        std::uniform_int_distribution<int> y(y_range.first, y_range.second);
+        return IntVector(x(generator), y(generator));
+    };
+    float radius_0 = radius_distribution(generator);
+    float radius_1 = radius_distribution(generator);
+    float min_distance = radius_0 + radius_1 + 2.0f;
+    IntVector center_0 = randomCenter(radius_0);
+    IntVector center_1 = randomCenter(radius_1);
+    float distance = static_cast<FloatVector>(center_1 - center_0).norm();
+    for (int i = 0; i < 100 && distance <= min_distance; i++) {
+        center_1 = randomCenter(radius_1);
+        distance = static_cast<FloatVector>(center_1 - center_0).norm();
+    }
+    if (distance <= min_distance) {
+        center_1 = IntVector(
+            fartherEnd(centerRange(settings.arena_width, radius_1),
+                       center_0.getX()),
+            fartherEnd(centerRange(settings.arena_height, radius_1),
+                       center_0.getY()));
+        assert(static_cast<FloatVector>(center_1 - center_0).norm()
+                   > min_distance
+               && "No room for the second blob.");
+    }
+    Scenario scenario(settings.arena_width, settings.arena_height);
+    scenario.addCircle(0, center_0, radius_0);
+    scenario.addCircle(1, center_1, radius_1);
+    return scenario;
+}
+
+BatchStatistics::BatchStatistics(
+    const std::vector<BatchRunner::TrialResult>& results) :
+    trial_count(results.size()),
+    decided_count(0),
+    decision_ticks_sum(0),
+    min_decision_ticks(0),
+    max_decision_ticks(0),
+    wins(),
+    survivors_sum(),
+    lost_sum() {
+    for (const BatchRunner::TrialResult& result: results) {
+        for (const auto& id_count: result.initial_particles) {
+            std::size_t survivors
+                = result.surviving_particles.at(id_count.first);
+            survivors_sum[id_count.first] += survivors;
+            lost_sum[id_count.first] += id_count.second - survivors;
+            if (result.decided && survivors > 0) {
+                wins[id_count.first]++;
+            }
+        }
+        if (!result.decided) {
+            continue;
+        }
+        if (decided_count == 0) {
+            min_decision_ticks = result.ticks;
+            max_decision_ticks = result.ticks;
+        }
+        decided_count++;
+        decision_ticks_sum += result.ticks;
+        min_decision_ticks = std::min(min_decision_ticks, result.ticks);
+        max_decision_ticks = std::max(max_decision_ticks, result.ticks);
+    }
+}
+
+std::size_t BatchStatistics::getTrialCount() const {
+    return trial_count;
+}
+
+// Returns the number of trials that ended with at most one blob left, the
+// others hit the tick limit.
+std::size_t BatchStatistics::getDecidedCount() const {
+    return decided_count;
+}
+
+std::size_t BatchStatistics::getWins(PlayerId player) const {
+    auto iter = wins.find(player);
+    return iter == wins.end() ? 0 : iter->second;
+}
+
+double BatchStatistics::getMeanDecisionTicks() const {
+    if (decided_count == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(decision_ticks_sum) / decided_count;
+}
+
+std::uint64_t BatchStatistics::getMinDecisionTicks() const {
+    return min_decision_ticks;
+}
+
+std::uint64_t BatchStatistics::getMaxDecisionTicks() const {
+    return max_decision_ticks;
+}
+
+double BatchStatistics::getMeanSurvivors(PlayerId player) const {
+    auto iter = survivors_sum.find(player);
+    if (trial_count == 0 || iter == survivors_sum.end()) {
+        return 0.0;
+    }
+    return static_cast<double>(iter->second) / trial_count;
+}
+
+double BatchStatistics::getMeanLost(PlayerId player) const {
+    auto iter = lost_sum.find(player);
+    if (trial_count == 0 || iter == lost_sum.end()) {
+        return 0.0;
+    }
+    return static_cast<double>(iter->second) / trial_count;
+}
+
+void BatchStatistics::print(std::ostream& stream) const {
+    stream << "Trials: " << trial_count << ", decided: " << decided_count
+           << "\n";
+    stream << "Ticks to decision: mean " << getMeanDecisionTicks()
+           << ", min " << min_decision_ticks << ", max "
+           << max_decision_ticks << "\n";
+    for (const auto& id_sum: survivors_sum) {
+        stream << "  player " << static_cast<unsigned int>(id_sum.first)
+               << ": wins " << getWins(id_sum.first)
+               << ", mean survivors " << getMeanSurvivors(id_sum.first)
+               << ", mean lost " << getMeanLost(id_sum.first) << "\n";
+    }
+    stream.flush();
+}
+
+}
@@ -0,0 +1,107 @@
+#ifndef BATCHRUNNER_HPP
+#define BATCHRUNNER_HPP
+
+#include "game/State.hpp"
+#include "game/Particle.hpp"
+#include "game/Blob.hpp"
+#include "Config.hpp"
+#include "game/Vector.hpp"
+#include "io/Scenario.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <chrono>
+#include <map>
+#include <vector>
+#include <ostream>
+#include <thread>
+#include <exception>
+#include <atomic>
+#include <algorithm>
+#include <utility>
+#include <cassert>
+
+namespace wotmin2d {
+
+/**
+ * Runs many independent battles without a screen, each between two blobs of
+ * random size and position whose targets are scripted to follow the enemy,
+ * and collects how they ended. Battles are distributed over several threads,
+ * each with its own State.
+ *
+ * Every trial is derived from the seed and its number only, so the results
+ * don't depend on the number of threads and a single interesting trial can be
+ * rerun on its own. Running the same batch with different config policies (see
+ * BasicParticle) compares them on identical battles.
+ */
+class BatchRunner {
+    public:
+    using PlayerId = State<>::PlayerId;
+    struct Settings {
+        unsigned int arena_width = 100;
+        unsigned int arena_height = 100;
+        float min_radius = 5.0f;
+        float max_radius = 15.0f;
+        float target_pressure = 20.0f;
+        // Targets are moved to the enemy every this many ticks.
+        std::uint64_t retarget_interval = 20;
+        // Battles still undecided after this many ticks count as a draw.
+        std::uint64_t max_ticks = 2000;
+        std::chrono::milliseconds tick_duration{50};
+        std::uint64_t seed = 0;
+    };
+    struct TrialResult {
+        std::uint64_t trial;
+        // Ticks until at most one blob was left, or max_ticks.
+        std::uint64_t ticks;
+        bool decided;
+        std::map<PlayerId, std::size_t> initial_particles;
+        std::map<PlayerId, std::size_t> surviving_particles;
+    };
+    static bool fitsArena(const Settings& settings);
+    BatchRunner(const Settings& settings);
+    const Settings& getSettings() const;
+    Scenario makeScenario(std::uint64_t trial) const;
+    template<class C = Config>
+    TrialResult runTrial(std::uint64_t trial) const;
+    template<class C = Config>
+    std::vector<TrialResult> run(std::size_t trial_count,
+                                 unsigned int thread_count) const;
+    private:
+    template<class S>
+    void retarget(S& state) const;
+    Settings settings;
+};
+
+/**
+ * Outcome statistics over the trials of a batch.
+ */
+class BatchStatistics {
+    public:
+    using PlayerId = BatchRunner::PlayerId;
+    BatchStatistics(const std::vector<BatchRunner::TrialResult>& results);
+    std::size_t getTrialCount() const;
+    std::size_t getDecidedCount() const;
+    std::size_t getWins(PlayerId player) const;
+    double getMeanDecisionTicks() const;
+    std::uint64_t getMinDecisionTicks() const;
+    std::uint64_t getMaxDecisionTicks() const;
+    double getMeanSurvivors(PlayerId player) const;
+    double getMeanLost(PlayerId player) const;
+    void print(std::ostream& stream) const;
+    private:
+    std::size_t trial_count;
+    std::size_t decided_count;
+    std::uint64_t decision_ticks_sum;
+    std::uint64_t min_decision_ticks;
+    std::uint64_t max_decision_ticks;
+    std::map<PlayerId, std::size_t> wins;
+    std::map<PlayerId, std::size_t> survivors_sum;
+    std::map<PlayerId, std::size_t> lost_sum;
+};
+
+}
+
+#include "BatchRunner.tpp"
+
+#endif
@@ -0,0 +1,116 @@
+namespace wotmin2d {
+
+template<class C>
+BatchRunner::TrialResult BatchRunner::runTrial(std::uint64_t trial) const {
+    using P = BasicParticle<C>;
+    State<P> state(settings.arena_width, settings.arena_height);
+    makeScenario(trial).populate(state);
+    TrialResult result;
+    result.trial = trial;
+    result.ticks = 0;
+    result.decided = false;
+    for (const auto& id_blob: state.getBlobs()) {
+        result.initial_particles[id_blob.first]
+            = id_blob.second.getParticles().size();
+    }
+    while (result.ticks < settings.max_ticks) {
+        if (result.ticks % settings.retarget_interval == 0) {
+            retarget(state);
+        }
+        state.advance(settings.tick_duration);
+        result.ticks++;
+        std::size_t alive = std::count_if(
+            state.getBlobs().begin(), state.getBlobs().end(),
+            [](const std::pair<const PlayerId, Blob<P>>& id_blob) {
+                return !id_blob.second.getParticles().empty();
+            });
+        if (alive <= 1) {
+            result.decided = true;
+            break;
+        }
+    }
+    for (const auto& id_blob: state.getBlobs()) {
+        result.surviving_particles[id_blob.first]
+            = id_blob.second.getParticles().size();
+    }
+    return result;
+}
+
+// Runs the trials 0 to trial_count - 1. Threads take the next trial that
+// hasn't been started, so a few long battles don't hold up the others. If a
+// trial throws, the other threads stop taking trials and the exception is
+// rethrown once all of them are done.
+template<class C>
+std::vector<BatchRunner::TrialResult> BatchRunner::run(
+    std::size_t trial_count, unsigned int thread_count) const
+{
+    assert(thread_count > 0);
+    std::vector<TrialResult> results(trial_count);
+    std::vector<std::exception_ptr> errors(thread_count);
+    std::atomic<std::size_t> next_trial(0);
+    auto work = [&](unsigned int thread_index) {
+        try {
+            for (std::size_t trial = next_trial++; trial < trial_count;
+                 trial = next_trial++) {
+                results[trial] = runTrial<C>(trial);
+            }
+        } catch (...) {
+            errors[thread_index] = std::current_exception();
+            next_trial = trial_count;
+        }
+    };
+    std::vector<std::thread> threads;
+    for (unsigned int i = 1; i < thread_count; i++) {
+        threads.emplace_back(work, i);
+    }
+    work(0);
+    for (std::thread& thread: threads) {
+        thread.join();
+    }
+    for (const std::exception_ptr& error: errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+    return results;
+}
+
+// Sets the target of each blob to the center of the largest other blob.
+template<class S>
+void BatchRunner::retarget(S& state) const {
+    std::map<PlayerId, IntVector> centers;
+    for (const auto& id_blob: state.getBlobs()) {
+        const auto& particles = id_blob.second.getParticles();
+        if (particles.empty()) {
+            continue;
+        }
+        long sum_x = 0;
+        long sum_y = 0;
+        for (const auto* particle: particles) {
+            sum_x += particle->getPosition().getX();
+            sum_y += particle->getPosition().getY();
+        }
+        long count = static_cast<long>(particles.size());
+        centers.emplace(id_blob.first,
+                        IntVector(static_cast<int>(sum_x / count),
+                                  static_cast<int>(sum_y / count)));
+    }
+    for (const auto& id_center: centers) {
+        const std::pair<const PlayerId, IntVector>* enemy = nullptr;
+        std::size_t enemy_size = 0;
+        for (const auto& other: centers) {
+            std::size_t size
+                = state.getBlobs().at(other.first).getParticles().size();
+            if (other.first != id_center.first && size > enemy_size) {
+                enemy = &other;
+                enemy_size = size;
+            }
+        }
+        if (enemy != nullptr) {
+            state.setBlobTarget(id_center.first, enemy->second,
+                                settings.target_pressure);
+        }
+    }
+}
+
+}
@@ -2,73 +2,501 @@
 
 namespace wotmin2d {
 
-const std::chrono::milliseconds Battle::frame_time
+// 20 ticks per second.
+const std::chrono::milliseconds Battle::default_tick_duration
     = std::chrono::milliseconds(50);
+// About 60 frames per second.
+const std::chrono::milliseconds Battle::default_render_interval
+    = std::chrono::milliseconds(16);
+// A quarter of a second at the default tick rate.
+const unsigned int Battle::max_catch_up_ticks = 5;
+const std::string Battle::snapshot_path = "battle.snapshot";
+// Every 30 seconds.
+const std::uint64_t Battle::keyframe_interval = 600;
+// Every 5 seconds, for the last 2.5 minutes.
+const std::size_t Battle::checkpoint_count = 30;
+const std::uint64_t Battle::checkpoint_interval = 100;
+// Far more than anyone can click or scroll during a tick.
+const std::size_t Battle::input_queue_capacity = 256;
 
+Battle::Battle(const Scenario& scenario, unsigned int display_width,
+               unsigned int display_height, bool headless) :
+    Battle(scenario.getArenaWidth(), scenario.getArenaHeight(), display_width,
+           display_height, headless) {
+    scenario.populate(state);
+    prepareState();
+}
+
+Battle::Battle(const StateSnapshot& snapshot, unsigned int display_width,
+               unsigned int display_height, bool headless) :
+    Battle(snapshot.getArenaWidth(), snapshot.getArenaHeight(), display_width,
+           display_height, headless) {
+    state.restore(snapshot);
+    prepareState();
+}
+
+// Sets up an empty battle, the public constructors fill the state.
 Battle::Battle(unsigned int arena_width, unsigned int arena_height,
-               unsigned int display_width, unsigned int display_height) :
-    screen(arena_width, arena_height, display_width, display_height),
+               unsigned int display_width, unsigned int display_height,
+               bool headless) :
+    screen(arena_width, arena_height, display_width, display_height,
+           headless),
     state(arena_width, arena_height),
     input_parser(),
-    running(true) {
-    state.emplaceBlob(0, IntVector(20, 20), 10.0f);
-    state.emplaceBlob(1, IntVector(80, 80), 10.0f);
+    input(),
+    running(true),
+    tick(0),
+    tick_limit(0),
+    tick_duration(default_tick_duration),
+    timestep(default_tick_duration, default_render_interval,
+             max_catch_up_ticks),
+    render_timestep(default_tick_duration, default_render_interval,
+                    max_catch_up_ticks),
+    render_buffer(),
+    render_history(),
+    capture_workers(std::max(std::thread::hardware_concurrency(), 1u)),
+    viewport_buffer(),
+    render_viewport(screen.getViewport()),
+    density_tracking(false),
+    screen_memory(screen.getMemoryUsage()),
+    debug_layers(0),
+    debug_buffer(),
+    performance(),
+    performance_buffer(),
+    show_hud(false),
+    pending_input(input_queue_capacity),
+    input_latency(),
+    draw_time(),
+    simulation_error(),
+    recorder(),
+    keyframe(),
+    streamer(),
+    checkpoints(checkpoint_count, checkpoint_interval) {}
+
+// Turns on what the battle needs from the blobs of the state once they are
+// there.
+void Battle::prepareState() {
+    updateDensityTracking();
+    // Lets render snapshots fill only the tiles that changed.
+    state.setChangeLogging(true);
+}
+
+// Only zoomed out snapshots are shaded from the density pyramids (see
+// RenderSnapshot), so the blobs count their particles in them only then. The
+// pyramids take memory in proportion to the arena, and starting to count
+// again goes through all particles once.
+void Battle::updateDensityTracking() {
+    bool zoomed_out = render_viewport.getZoom() < 0;
+    if (zoomed_out != density_tracking) {
+        state.setDensityTracking(zoomed_out);
+        density_tracking = zoomed_out;
+    }
+}
+
+// Sets how much simulated time a tick covers and how often the screen is
+// drawn. Recordings of the battle must have been started with the same tick
+// duration.
+void Battle::setTiming(std::chrono::milliseconds tick_duration,
+                       std::chrono::milliseconds render_interval) {
+    this->tick_duration = tick_duration;
+    timestep = FixedTimestep(tick_duration, render_interval,
+                             max_catch_up_ticks);
+    render_timestep = FixedTimestep(tick_duration, render_interval,
+                                    max_catch_up_ticks);
+}
+
+std::chrono::milliseconds Battle::getTickDuration() const {
+    return tick_duration;
+}
+
+// Records all commands executed from now on. The recording must have been
+// started with the scenario of this battle.
+void Battle::record(std::unique_ptr<RecordingWriter> recorder) {
+    this->recorder = std::move(recorder);
+}
+
+// Writes the changes to all particles during each tick from now on to a delta
+// stream at the given path.
+void Battle::stream(const std::string& path) {
+    state.snapshot(keyframe);
+    streamer.reset(new DeltaStreamWriter(path, keyframe));
+    state.setChangeLogging(true);
+}
+
+// Writes every frame drawn from now on as a PPM image, see FrameWriter.
+void Battle::exportFrames(const std::string& path_prefix) {
+    screen.exportFrames(std::unique_ptr<FrameWriter>(
+        new FrameWriter(path_prefix)));
+}
+
+// Publishes every frame drawn from now on to a ring in POSIX shared memory
+// with the given name, see FrameRingWriter.
+void Battle::publishFrames(const std::string& name) {
+    const Viewport& viewport = screen.getViewport();
+    screen.publishFrames(std::unique_ptr<FrameRingWriter>(
+        new FrameRingWriter(name, viewport.getViewWidth(),
+                            viewport.getViewHeight())));
+}
+
+// Makes the battle stop by itself after the given tick, e.g. to benchmark or
+// export a headless battle. 0 means never.
+void Battle::setTickLimit(std::uint64_t tick_limit) {
+    this->tick_limit = tick_limit;
 }
 
+// Runs the battle until it's stopped. The simulation runs on its own thread
+// (see simulate()), this one handles input and draws the latest published
+// tick at its own rate. Exceptions on either thread stop both and are thrown
+// from here.
 void Battle::start() {
-    // TODO Check whether high_resolution_clock is steady. If not, weird
-    // behavior could happen if the system time is adjusted.
-    using std::chrono::high_resolution_clock;
-    using time_point = high_resolution_clock::time_point;
-    while (running) {
-        time_point start_time = high_resolution_clock::now();
-        state.advance(frame_time);
-        screen.draw(state);
-        std::vector<std::unique_ptr<InputAction>> input
-            = input_parser.parseInput();
-        handleInput(input);
-        time_point end_time = high_resolution_clock::now();
-        if (end_time < start_time + frame_time) {
-            // Wait some time so that the new frame begins after the right time.
-            std::chrono::nanoseconds sleep_time = (start_time + frame_time)
-                                                  - end_time;
-            std::this_thread::sleep_for(sleep_time);
+    using Clock = FixedTimestep::Clock;
+    if (checkpoints.getSize() == 0) {
+        checkpoints.save(tick, state);
+    }
+    publish();
+    std::thread simulation(&Battle::simulate, this);
+    try {
+        render_timestep.start(Clock::now());
+        float tick_seconds
+            = std::chrono::duration<float>(tick_duration).count();
+        while (running) {
+            input_parser.parseInput(input);
+            handleInput(input);
+            Clock::time_point now = Clock::now();
+            if (render_timestep.isRenderDue(now)) {
+                PerformanceSnapshot shown_performance;
+                render_buffer.update();
+                const RenderSnapshot& snapshot = render_buffer.getFront();
+                float interpolation
+                    = std::chrono::duration<float>(now - snapshot.getTime())
+                          .count() / tick_seconds;
+                const DebugSnapshot* debug = nullptr;
+                if (debug_layers != 0) {
+                    debug_buffer.update();
+                    debug = &debug_buffer.getFront();
+                }
+                const PerformanceSnapshot* hud = nullptr;
+                if (show_hud) {
+                    performance_buffer.update();
+                    shown_performance = performance_buffer.getFront();
+                    shown_performance.draw_time = draw_time.getMean();
+                    shown_performance.skipped_renders
+                        = render_timestep.getSkippedRenders();
+                    hud = &shown_performance;
+                }
+                screen.draw(snapshot, std::min(interpolation, 1.0f), debug,
+                            hud);
+                Clock::time_point drawn = Clock::now();
+                draw_time.add(drawn - now);
+                render_timestep.rendered(drawn);
+            }
+            std::this_thread::sleep_until(render_timestep.getNextRender());
+        }
+    } catch (...) {
+        stop();
+        simulation.join();
+        throw;
+    }
+    simulation.join();
+    if (simulation_error != nullptr) {
+        std::rethrow_exception(simulation_error);
+    }
+    if (input_latency.getCount() > 0) {
+        std::cout << "Input latency: " << input_latency << std::endl;
+    }
+    if (draw_time.getCount() > 0) {
+        std::cout << "Draw time: " << draw_time << std::endl;
+    }
+    try {
+        screen.flushFrames();
+    } catch (const IoException& e) {
+        std::cerr << e.what() << std::endl;
+    }
+    if (streamer != nullptr) {
+        try {
+            streamer->flush();
+        } catch (const IoException& e) {
+            std::cerr << e.what() << std::endl;
+        }
+    }
+    if (recorder != nullptr) {
+        try {
+            recorder->finish(tick);
+        } catch (const IoException& e) {
+            std::cerr << e.what() << std::endl;
         }
     }
 }
 
+// The simulation thread. Ticks happen at a fixed rate in real time (see
+// FixedTimestep), input that arrived in the meantime is executed after them.
+void Battle::simulate() {
+    using Clock = FixedTimestep::Clock;
+    try {
+        timestep.start(Clock::now());
+        std::uint64_t reported_dropped_ticks = 0;
+        while (running) {
+            unsigned int ticks = timestep.advance(Clock::now());
+            for (unsigned int i = 0; i < ticks && running; i++) {
+                step();
+            }
+            if (timestep.getDroppedTicks() > reported_dropped_ticks) {
+                std::cerr << "Simulation can't keep up, skipped "
+                          << timestep.getDroppedTicks()
+                             - reported_dropped_ticks
+                          << " ticks." << std::endl;
+                reported_dropped_ticks = timestep.getDroppedTicks();
+            }
+            performance.dropped_ticks = timestep.getDroppedTicks();
+            bool had_input = executePendingInput();
+            bool viewport_moved = viewport_buffer.update();
+            if (viewport_moved) {
+                render_viewport = viewport_buffer.getFront();
+                updateDensityTracking();
+            }
+            if (ticks > 0 || had_input || viewport_moved) {
+                publish();
+            }
+            std::this_thread::sleep_until(timestep.getNextTick());
+        }
+    } catch (...) {
+        simulation_error = std::current_exception();
+        stop();
+    }
+}
+
+// Advances the state by one tick and writes whatever the tick needs written.
+// A tick that takes longer than the time it covers counts as an overrun.
+void Battle::step() {
+    using Clock = FixedTimestep::Clock;
+    Clock::time_point start = Clock::now();
+    state.advance(tick_duration);
+    tick++;
+    Clock::time_point advanced = Clock::now();
+    if (streamer != nullptr) {
+        writeChanges();
+    }
+    if (recorder != nullptr && tick % keyframe_interval == 0) {
+        writeKeyframe();
+    }
+    if (checkpoints.isDue(tick)) {
+        checkpoints.save(tick, state);
+    }
+    Clock::time_point end = Clock::now();
+    performance.profile = state.getProfile();
+    performance.output = end - advanced;
+    if (end - start > tick_duration) {
+        performance.tick_overruns++;
+    }
+    if (tick == tick_limit) {
+        stop();
+    }
+}
+
+// Stops the battle. May be called from any thread.
 void Battle::stop() {
     running = false;
 }
 
-void Battle::handleInput(std::vector<std::unique_ptr<InputAction>>& actions) {
-    for (std::unique_ptr<InputAction>& action: actions) {
-        if (dynamic_cast<ExitAction*>(action.get())) {
+void Battle::reportMemoryUsage(std::ostream& stream) const {
+    MemoryUsage total;
+    stream << "Memory usage:\n";
+    for (const auto& id_usage: state.getMemoryUsage()) {
+        stream << "  blob " << static_cast<unsigned int>(id_usage.first)
+               << ": " << id_usage.second << "\n";
+        total += id_usage.second;
+    }
+    stream << "  all blobs: " << total << "\n";
+    stream << "  checkpoints: " << checkpoints.getMemoryUsage() << " bytes\n";
+    stream << "  screen: " << screen_memory << " bytes"
+           << std::endl;
+}
+
+void Battle::saveSnapshot(const std::string& path) const {
+    StateSnapshot snapshot;
+    state.snapshot(snapshot);
+    SnapshotFile::save(snapshot, path);
+}
+
+// Rewinds the battle to the last checkpoint before the current tick. Recordings
+// and delta streams can't go back in time, so rewinding is refused while the
+// battle is written to one. Returns whether the battle was rewound.
+bool Battle::rewind() {
+    if (recorder != nullptr || streamer != nullptr) {
+        std::cerr << "Can't rewind while recording." << std::endl;
+        return false;
+    }
+    if (tick == 0) {
+        return false;
+    }
+    std::uint64_t checkpoint_tick = tick - 1;
+    if (!checkpoints.rewind(checkpoint_tick, state)) {
+        return false;
+    }
+    tick = checkpoint_tick;
+    return true;
+}
+
+// Publishes what the screen needs to draw the current tick, the debug layers
+// if any are shown, and the performance of the tick. Called by the simulation
+// thread (and before it starts).
+void Battle::publish() {
+    using Clock = FixedTimestep::Clock;
+    Clock::time_point start = Clock::now();
+    render_buffer.getBack().capture(state, render_viewport, tick, start,
+                                    render_history, &capture_workers);
+    render_buffer.publish();
+    unsigned int layers = debug_layers;
+    if (layers != 0) {
+        debug_buffer.getBack().capture(state, render_viewport, layers, tick);
+        debug_buffer.publish();
+    }
+    performance.capture = Clock::now() - start;
+    performance.tick = tick;
+    performance.tick_duration = tick_duration;
+    performance.countParticles(state);
+    performance_buffer.getBack() = performance;
+    performance_buffer.publish();
+}
+
+// Called by the main thread. Exiting and moving the viewport are handled right
+// away, screen coordinates are turned into arena coordinates here since only
+// this thread may use the screen, and everything else is passed on to the
+// simulation thread.
+void Battle::handleInput(const std::vector<InputAction>& actions) {
+    for (const InputAction& action: actions) {
+        switch (action.getType()) {
+        case InputAction::Type::exit:
             stop();
-        } else if (dynamic_cast<ParticleSelectionAction*>(action.get())) {
-            ParticleSelectionAction& select
-                = *(dynamic_cast<ParticleSelectionAction*>(action.get()));
-            selectParticles(select.getCoordinate());
-        } else if (dynamic_cast<TargetSettingAction*>(action.get())) {
-            TargetSettingAction& set
-                = *(dynamic_cast<TargetSettingAction*>(action.get()));
-            setTarget(set.getCoordinate());
-        } else if (dynamic_cast<SelectionSizeChangeAction*>(action.get())) {
-            SelectionSizeChangeAction& size_change
-                = *(dynamic_cast<SelectionSizeChangeAction*>(action.get()));
-            state.changeSelectionRadius(size_change.getDifference());
+            break;
+        case InputAction::Type::pan:
+        case InputAction::Type::zoom:
+            moveViewport(action);
+            break;
+        case InputAction::Type::toggle_layer:
+            debug_layers ^= action.getLayer();
+            break;
+        case InputAction::Type::toggle_hud:
+            show_hud = !show_hud;
+            break;
+        case InputAction::Type::select_particles:
+        case InputAction::Type::set_target:
+            enqueue(action.withCoordinate(
+                screen.sdlToArenaCoordinates(action.getCoordinate())));
+            break;
+        default:
+            enqueue(action);
+            break;
         }
     }
 }
 
-void Battle::selectParticles(const IntVector& coordinate) {
-    IntVector position = screen.sdlToArenaCoordinates(coordinate);
-    state.selectParticles(position);
+void Battle::moveViewport(const InputAction& action) {
+    Viewport viewport = screen.getViewport();
+    if (action.getType() == InputAction::Type::pan) {
+        viewport.pan(action.getCoordinate());
+    } else {
+        viewport.zoom(action.getSteps(), action.getCoordinate());
+    }
+    screen.setViewport(viewport);
+    viewport_buffer.getBack() = viewport;
+    viewport_buffer.publish();
 }
 
-void Battle::setTarget(const IntVector& coordinate) {
-    IntVector position = screen.sdlToArenaCoordinates(coordinate);
-    state.setTarget(0, position);
+// If the simulation thread has fallen so far behind that the queue is full,
+// the input is dropped.
+void Battle::enqueue(const InputAction& action) {
+    InputAction copy = action;
+    if (!pending_input.push(std::move(copy))) {
+        std::cerr << "Too much input, ignoring some." << std::endl;
+    }
+}
+
+// Called by the simulation thread. Returns whether there was any input.
+bool Battle::executePendingInput() {
+    bool had_input = false;
+    InputAction action;
+    while (pending_input.pop(action)) {
+        had_input = true;
+        execute(action);
+        input_latency.add(FixedTimestep::Clock::now() - action.getTime());
+    }
+    return had_input;
+}
+
+void Battle::execute(const InputAction& action) {
+    switch (action.getType()) {
+    case InputAction::Type::memory_report:
+        reportMemoryUsage(std::cout);
+        break;
+    case InputAction::Type::snapshot:
+        try {
+            saveSnapshot(snapshot_path);
+            std::cout << "Saved snapshot to " << snapshot_path << std::endl;
+        } catch (const IoException& e) {
+            std::cerr << e.what() << std::endl;
+        }
+        break;
+    case InputAction::Type::rewind:
+        if (rewind()) {
+            std::cout << "Rewound to tick " << tick << std::endl;
+        }
+        break;
+    case InputAction::Type::select_particles:
+        execute(Command::selectParticles(action.getCoordinate()));
+        break;
+    case InputAction::Type::set_target:
+        execute(Command::setTarget(0, action.getCoordinate()));
+        break;
+    case InputAction::Type::change_selection_size:
+        execute(Command::changeSelectionRadius(action.getDifference()));
+        break;
+    case InputAction::Type::none:
+    case InputAction::Type::exit:
+    case InputAction::Type::pan:
+    case InputAction::Type::zoom:
+    case InputAction::Type::toggle_layer:
+    case InputAction::Type::toggle_hud:
+        break;
+    }
+}
+
+// Executes the command and records it, if the battle is being recorded. If
+// writing fails, the battle continues without recording.
+void Battle::execute(const Command& command) {
+    state.execute(command);
+    if (recorder == nullptr) {
+        return;
+    }
+    try {
+        recorder->write(tick, command);
+    } catch (const IoException& e) {
+        std::cerr << e.what() << " Recording stopped." << std::endl;
+        recorder.reset();
+    }
+}
+
+// Writes the current state to the recording so replays can start from here.
+// The snapshot is kept to reuse its memory for the next keyframe.
+void Battle::writeKeyframe() {
+    state.snapshot(keyframe);
+    try {
+        recorder->writeKeyframe(tick, keyframe);
+    } catch (const IoException& e) {
+        std::cerr << e.what() << " Recording stopped." << std::endl;
+        recorder.reset();
+    }
+}
+
+// Writes the changes of the last tick to the delta stream. If writing fails,
+// the battle continues without streaming.
+void Battle::writeChanges() {
+    try {
+        streamer->writeTick(tick, state);
+    } catch (const IoException& e) {
+        std::cerr << e.what() << " Streaming stopped." << std::endl;
+        streamer.reset();
+    }
 }
 
 }
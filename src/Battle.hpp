@@ -3,32 +3,142 @@
 
 #include "game/State.hpp"
 #include "display/Screen.hpp"
+#include "display/RenderSnapshot.hpp"
+#include "display/DebugSnapshot.hpp"
+#include "display/PerformanceSnapshot.hpp"
 #include "input/InputParser.hpp"
 #include "input/InputAction.hpp"
+#include "io/Scenario.hpp"
+#include "io/SnapshotFile.hpp"
+#include "io/IoException.hpp"
+#include "io/Recording.hpp"
+#include "io/DeltaStream.hpp"
+#include "game/Command.hpp"
+#include "game/CheckpointRing.hpp"
+#include "FixedTimestep.hpp"
+#include "TripleBuffer.hpp"
+#include "SpscQueue.hpp"
+#include "LatencyStatistics.hpp"
+#include "WorkerPool.hpp"
 
+#include <algorithm>
 #include <cstdint>
+#include <cstddef>
 #include <chrono>
 #include <thread>
+#include <atomic>
+#include <exception>
 #include <vector>
 #include <memory>
+#include <ostream>
+#include <iostream>
+#include <string>
 
 namespace wotmin2d {
 
+/**
+ * A battle played on screen. The state is advanced on a simulation thread at a
+ * fixed tick rate, while the main thread handles input and draws. After each
+ * tick the simulation thread publishes a render snapshot through a triple
+ * buffer, so drawing (however slow) never holds up a tick and ticking never
+ * holds up drawing. Input goes the other way through a lock-free queue and is
+ * executed at the next tick boundary.
+ *
+ * The simulation thread also measures how long each tick takes (see
+ * TickProfile) and publishes that with the snapshots, for the performance
+ * overlay the main thread shows on request.
+ */
 class Battle {
     public:
-    Battle(unsigned int arena_width, unsigned int arena_height,
-           unsigned int display_width, unsigned int display_height);
+    Battle(const Scenario& scenario, unsigned int display_width,
+           unsigned int display_height, bool headless = false);
+    Battle(const StateSnapshot& snapshot, unsigned int display_width,
+           unsigned int display_height, bool headless = false);
+    void setTiming(std::chrono::milliseconds tick_duration,
+                   std::chrono::milliseconds render_interval);
+    std::chrono::milliseconds getTickDuration() const;
+    void record(std::unique_ptr<RecordingWriter> recorder);
+    void stream(const std::string& path);
+    void exportFrames(const std::string& path_prefix);
+    void publishFrames(const std::string& name);
+    void setTickLimit(std::uint64_t tick_limit);
     void start();
     void stop();
-    const static std::chrono::milliseconds frame_time;
+    void reportMemoryUsage(std::ostream& stream) const;
+    void saveSnapshot(const std::string& path) const;
+    bool rewind();
+    const static std::chrono::milliseconds default_tick_duration;
+    const static std::chrono::milliseconds default_render_interval;
+    const static unsigned int max_catch_up_ticks;
+    const static std::string snapshot_path;
+    const static std::uint64_t keyframe_interval;
+    const static std::size_t checkpoint_count;
+    const static std::uint64_t checkpoint_interval;
+    const static std::size_t input_queue_capacity;
     private:
-    void handleInput(std::vector<std::unique_ptr<InputAction>>& actions);
-    void selectParticles(const IntVector& coordinate);
-    void setTarget(const IntVector& coordinate);
+    Battle(unsigned int arena_width, unsigned int arena_height,
+           unsigned int display_width, unsigned int display_height,
+           bool headless);
+    void prepareState();
+    void updateDensityTracking();
+    void simulate();
+    void step();
+    void publish();
+    void handleInput(const std::vector<InputAction>& actions);
+    void enqueue(const InputAction& action);
+    void moveViewport(const InputAction& action);
+    bool executePendingInput();
+    void execute(const InputAction& action);
+    void execute(const Command& command);
+    void writeKeyframe();
+    void writeChanges();
     Screen screen;
     State<> state;
     InputParser input_parser;
-    bool running;
+    // Reused by the main thread for each batch of input.
+    std::vector<InputAction> input;
+    std::atomic<bool> running;
+    std::uint64_t tick;
+    // Stop after this tick, unless it's 0.
+    std::uint64_t tick_limit;
+    std::chrono::milliseconds tick_duration;
+    // Only the ticks are taken from this one, by the simulation thread.
+    FixedTimestep timestep;
+    // Only the renders are taken from this one, by the main thread.
+    FixedTimestep render_timestep;
+    TripleBuffer<RenderSnapshot> render_buffer;
+    RenderSnapshot::History render_history;
+    // Captures are split over all cores, the simulation waits for them anyway.
+    // The threads are started once and wait between captures.
+    WorkerPool capture_workers;
+    // The main thread publishes the viewport whenever it changes, the
+    // simulation thread captures snapshots through the latest one.
+    TripleBuffer<Viewport> viewport_buffer;
+    Viewport render_viewport;
+    // Whether the blobs count their particles in density pyramids, which
+    // they only do while render_viewport is zoomed out.
+    bool density_tracking;
+    std::size_t screen_memory;
+    // The debug layers that are shown, toggled by the main thread. The
+    // simulation thread only captures debug snapshots while there are any.
+    std::atomic<unsigned int> debug_layers;
+    TripleBuffer<DebugSnapshot> debug_buffer;
+    // Filled in by the simulation thread over each tick and published with
+    // the render snapshot. The overlay is only drawn while shown.
+    PerformanceSnapshot performance;
+    TripleBuffer<PerformanceSnapshot> performance_buffer;
+    bool show_hud;
+    // Input for the simulation thread, in arena coordinates.
+    SpscQueue<InputAction> pending_input;
+    // From input events to the tick boundary at which they were executed.
+    LatencyStatistics input_latency;
+    // How long the main thread takes to draw a frame.
+    LatencyStatistics draw_time;
+    std::exception_ptr simulation_error;
+    std::unique_ptr<RecordingWriter> recorder;
+    StateSnapshot keyframe;
+    std::unique_ptr<DeltaStreamWriter> streamer;
+    CheckpointRing checkpoints;
 };
 
 }
@@ -0,0 +1,107 @@
+#include "FixedTimestep.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace wotmin2d {
+
+FixedTimestep::FixedTimestep(Clock::duration tick_duration,
+                             Clock::duration render_interval,
+                             unsigned int max_catch_up_ticks) :
+    tick_duration(tick_duration),
+    render_interval(render_interval),
+    max_catch_up_ticks(max_catch_up_ticks),
+    last_time(),
+    next_render(),
+    accumulator(Clock::duration::zero()),
+    dropped_ticks(0),
+    skipped_renders(0) {
+    assert(tick_duration > Clock::duration::zero());
+    assert(render_interval > Clock::duration::zero());
+    assert(max_catch_up_ticks > 0);
+}
+
+// Starts counting time. The first tick is due one tick duration later, the
+// first render immediately.
+void FixedTimestep::start(Clock::time_point now) {
+    last_time = now;
+    next_render = now;
+    accumulator = Clock::duration::zero();
+}
+
+// Adds the time since the last call and returns how many ticks to simulate
+// now.
+unsigned int FixedTimestep::advance(Clock::time_point now) {
+    if (now > last_time) {
+        accumulator += now - last_time;
+        last_time = now;
+    }
+    std::uint64_t due = accumulator / tick_duration;
+    std::uint64_t ticks = std::min<std::uint64_t>(due, max_catch_up_ticks);
+    accumulator -= ticks * tick_duration;
+    std::uint64_t backlog = due - ticks;
+    if (backlog > max_catch_up_ticks) {
+        std::uint64_t dropped = backlog - max_catch_up_ticks;
+        accumulator -= dropped * tick_duration;
+        dropped_ticks += dropped;
+    }
+    return static_cast<unsigned int>(ticks);
+}
+
+bool FixedTimestep::isRenderDue(Clock::time_point now) const {
+    return now >= next_render;
+}
+
+// Schedules the next render. If rendering fell behind by more than an
+// interval, the missed renders are skipped.
+void FixedTimestep::rendered(Clock::time_point now) {
+    next_render += render_interval;
+    if (next_render <= now) {
+        skipped_renders += (now - next_render) / render_interval + 1;
+        next_render = now + render_interval;
+    }
+}
+
+// Returns how far (in [0, 1)) real time has progressed from the last tick
+// towards the next one, when no ticks are overdue. A renderer can use it to
+// blend the last two ticks.
+float FixedTimestep::getInterpolation() const {
+    float fraction = std::chrono::duration<float>(accumulator).count()
+                     / std::chrono::duration<float>(tick_duration).count();
+    return std::min(fraction, 1.0f);
+}
+
+FixedTimestep::Clock::time_point FixedTimestep::getNextTick() const {
+    return last_time + (tick_duration - accumulator);
+}
+
+FixedTimestep::Clock::time_point FixedTimestep::getNextRender() const {
+    return next_render;
+}
+
+// Returns when the next tick or render is due, whichever comes first.
+FixedTimestep::Clock::time_point FixedTimestep::getNextWakeUp() const {
+    return std::min(getNextTick(), getNextRender());
+}
+
+FixedTimestep::Clock::duration FixedTimestep::getTickDuration() const {
+    return tick_duration;
+}
+
+FixedTimestep::Clock::duration FixedTimestep::getRenderInterval() const {
+    return render_interval;
+}
+
+// Returns the number of ticks that weren't simulated because the simulation
+// couldn't keep up.
+std::uint64_t FixedTimestep::getDroppedTicks() const {
+    return dropped_ticks;
+}
+
+// Returns the number of renders that were skipped because rendering took
+// longer than the interval.
+std::uint64_t FixedTimestep::getSkippedRenders() const {
+    return skipped_renders;
+}
+
+}
@@ -0,0 +1,57 @@
+#ifndef FIXEDTIMESTEP_HPP
+#define FIXEDTIMESTEP_HPP
+
+#include <chrono>
+#include <cstdint>
+
+namespace wotmin2d {
+
+/**
+ * Decides when to simulate and when to render in a loop that simulates at a
+ * fixed tick rate and renders at its own rate. Elapsed real time (from a
+ * steady clock, so adjusting the system time doesn't matter) is accumulated
+ * and paid out in whole ticks, so simulation time doesn't drift when frames
+ * take longer than planned.
+ *
+ * After a slow frame, the ticks that are due are simulated in a burst of at
+ * most max_catch_up_ticks. A backlog of up to that many more ticks is carried
+ * over to the next frames; anything beyond is dropped, i.e. the simulation
+ * slows down instead of trying to catch up forever. Renders that are late are
+ * skipped rather than queued.
+ *
+ * When simulating and rendering happen on different threads, each thread uses
+ * its own timestep and only the tick or render half of it.
+ */
+class FixedTimestep {
+    public:
+    using Clock = std::chrono::steady_clock;
+    FixedTimestep(Clock::duration tick_duration,
+                  Clock::duration render_interval,
+                  unsigned int max_catch_up_ticks);
+    void start(Clock::time_point now);
+    unsigned int advance(Clock::time_point now);
+    bool isRenderDue(Clock::time_point now) const;
+    void rendered(Clock::time_point now);
+    float getInterpolation() const;
+    Clock::time_point getNextTick() const;
+    Clock::time_point getNextRender() const;
+    Clock::time_point getNextWakeUp() const;
+    Clock::duration getTickDuration() const;
+    Clock::duration getRenderInterval() const;
+    std::uint64_t getDroppedTicks() const;
+    std::uint64_t getSkippedRenders() const;
+    private:
+    Clock::duration tick_duration;
+    Clock::duration render_interval;
+    unsigned int max_catch_up_ticks;
+    Clock::time_point last_time;
+    Clock::time_point next_render;
+    // Real time that passed but hasn't been simulated yet.
+    Clock::duration accumulator;
+    std::uint64_t dropped_ticks;
+    std::uint64_t skipped_renders;
+};
+
+}
+
+#endif
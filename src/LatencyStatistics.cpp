@@ -0,0 +1,49 @@
+#include "LatencyStatistics.hpp"
+
+#include <algorithm>
+
+namespace wotmin2d {
+
+LatencyStatistics::LatencyStatistics() :
+    count(0),
+    total(Duration::zero()),
+    max(Duration::zero()) {}
+
+// Negative latencies (from clocks that disagree slightly) count as zero.
+void LatencyStatistics::add(Duration latency) {
+    latency = std::max(latency, Duration::zero());
+    count++;
+    total += latency;
+    max = std::max(max, latency);
+}
+
+void LatencyStatistics::clear() {
+    *this = LatencyStatistics();
+}
+
+std::uint64_t LatencyStatistics::getCount() const {
+    return count;
+}
+
+// Returns zero if nothing was added.
+LatencyStatistics::Duration LatencyStatistics::getMean() const {
+    if (count == 0) {
+        return Duration::zero();
+    }
+    return total / count;
+}
+
+LatencyStatistics::Duration LatencyStatistics::getMax() const {
+    return max;
+}
+
+std::ostream& operator<<(std::ostream& stream,
+                         const LatencyStatistics& statistics) {
+    using Milliseconds = std::chrono::duration<double, std::milli>;
+    return stream << statistics.getCount() << " samples, mean "
+                  << Milliseconds(statistics.getMean()).count()
+                  << " ms, max " << Milliseconds(statistics.getMax()).count()
+                  << " ms";
+}
+
+}
@@ -0,0 +1,34 @@
+#ifndef LATENCYSTATISTICS_HPP
+#define LATENCYSTATISTICS_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+namespace wotmin2d {
+
+/**
+ * Count, mean and maximum of a series of latencies, e.g. from an input event
+ * to the tick at which it took effect.
+ */
+class LatencyStatistics {
+    public:
+    using Duration = std::chrono::steady_clock::duration;
+    LatencyStatistics();
+    void add(Duration latency);
+    void clear();
+    std::uint64_t getCount() const;
+    Duration getMean() const;
+    Duration getMax() const;
+    private:
+    std::uint64_t count;
+    Duration total;
+    Duration max;
+};
+
+std::ostream& operator<<(std::ostream& stream,
+                         const LatencyStatistics& statistics);
+
+}
+
+#endif
@@ -0,0 +1,88 @@
+#include "Replay.hpp"
+
+namespace wotmin2d {
+
+Replay::Replay(const Recording& recording) :
+    recording(recording),
+    state(recording.getScenario().getArenaWidth(),
+          recording.getScenario().getArenaHeight()),
+    tick(0),
+    event_offset(recording.getEventsOffset()),
+    initial_state(),
+    keyframe() {
+    recording.getScenario().populate(state);
+    state.snapshot(initial_state);
+    executeCommands();
+}
+
+// Advances the state by one tick and executes the commands of the new tick.
+// Returns false without doing anything if the recording has ended.
+bool Replay::step() {
+    if (isFinished()) {
+        return false;
+    }
+    state.advance(recording.getTickDuration());
+    tick++;
+    executeCommands();
+    return true;
+}
+
+void Replay::run() {
+    while (step());
+}
+
+void Replay::runUntil(std::uint64_t tick) {
+    while (this->tick < tick && step());
+}
+
+// Moves to the given tick, or the end of the recording if it's earlier. The
+// state is restored from the last keyframe before the tick, unless simulating
+// from the current tick is shorter.
+void Replay::seek(std::uint64_t tick) {
+    const std::vector<Recording::Keyframe>& keyframes
+        = recording.getKeyframes();
+    auto after = std::upper_bound(
+        keyframes.begin(), keyframes.end(), tick,
+        [](std::uint64_t t, const Recording::Keyframe& keyframe) {
+            return t < keyframe.first;
+        });
+    if (after != keyframes.begin()) {
+        const Recording::Keyframe& before = *(after - 1);
+        if (before.first > this->tick || tick < this->tick) {
+            recording.readKeyframe(before, keyframe);
+            state.restore(keyframe);
+            this->tick = before.first;
+            event_offset = before.second;
+            executeCommands();
+        }
+    } else if (tick < this->tick) {
+        state.restore(initial_state);
+        this->tick = 0;
+        event_offset = recording.getEventsOffset();
+        executeCommands();
+    }
+    runUntil(tick);
+}
+
+std::uint64_t Replay::getTick() const {
+    return tick;
+}
+
+bool Replay::isFinished() const {
+    return tick >= recording.getTickCount();
+}
+
+const State<>& Replay::getState() const {
+    return state;
+}
+
+void Replay::executeCommands() {
+    Recording::Event event(0, Command::selectParticles(IntVector(0, 0)));
+    std::size_t next_offset = event_offset;
+    while (recording.readEvent(next_offset, event) && event.first == tick) {
+        state.execute(event.second);
+        event_offset = next_offset;
+    }
+}
+
+}
@@ -0,0 +1,46 @@
+#ifndef REPLAY_HPP
+#define REPLAY_HPP
+
+#include "game/State.hpp"
+#include "game/Command.hpp"
+#include "game/Snapshot.hpp"
+#include "io/Recording.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+
+namespace wotmin2d {
+
+/**
+ * Re-executes a recorded battle without a screen, as fast as possible. Commands
+ * are executed at the same ticks as in the original battle, so the resulting
+ * states are the same.
+ */
+class Replay {
+    public:
+    Replay(const Recording& recording);
+    Replay(const Replay&) = delete;
+    Replay& operator=(const Replay&) = delete;
+    bool step();
+    void run();
+    void runUntil(std::uint64_t tick);
+    void seek(std::uint64_t tick);
+    std::uint64_t getTick() const;
+    bool isFinished() const;
+    const State<>& getState() const;
+    private:
+    void executeCommands();
+    const Recording& recording;
+    State<> state;
+    std::uint64_t tick;
+    std::size_t event_offset;
+    StateSnapshot initial_state;
+    StateSnapshot keyframe;
+};
+
+}
+
+#endif
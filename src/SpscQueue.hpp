@@ -0,0 +1,40 @@
+#ifndef SPSCQUEUE_HPP
+#define SPSCQUEUE_HPP
+
+#include <vector>
+#include <atomic>
+#include <cstddef>
+#include <cassert>
+#include <utility>
+
+namespace wotmin2d {
+
+/**
+ * A bounded first in, first out queue for exactly one thread pushing and one
+ * thread popping, without locks. Values live in a ring of slots that is
+ * allocated once, so pushing and popping never allocate (unless moving a value
+ * does). Values must be default constructible and move assignable.
+ */
+template<class T>
+class SpscQueue {
+    public:
+    explicit SpscQueue(std::size_t capacity);
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+    bool push(T&& value);
+    bool pop(T& value);
+    std::size_t getCapacity() const;
+    private:
+    std::vector<T> slots;
+    // Free-running counts of pushed and popped values, a slot is the count
+    // modulo the number of slots. Written only by the producer and the
+    // consumer, respectively.
+    std::atomic<std::size_t> pushed;
+    std::atomic<std::size_t> popped;
+};
+
+}
+
+#include "SpscQueue.tpp"
+
+#endif
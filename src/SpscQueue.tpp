@@ -0,0 +1,42 @@
+namespace wotmin2d {
+
+template<class T>
+SpscQueue<T>::SpscQueue(std::size_t capacity) :
+    slots(capacity),
+    pushed(0),
+    popped(0) {
+    assert(capacity > 0);
+}
+
+// Adds the value at the end of the queue. Returns false (and leaves the value
+// alone) if the queue is full. Called by the producer.
+template<class T>
+bool SpscQueue<T>::push(T&& value) {
+    std::size_t count = pushed.load(std::memory_order_relaxed);
+    if (count - popped.load(std::memory_order_acquire) == slots.size()) {
+        return false;
+    }
+    slots[count % slots.size()] = std::move(value);
+    pushed.store(count + 1, std::memory_order_release);
+    return true;
+}
+
+// Moves the value at the front of the queue into value. Returns false if the
+// queue is empty. Called by the consumer.
+template<class T>
+bool SpscQueue<T>::pop(T& value) {
+    std::size_t count = popped.load(std::memory_order_relaxed);
+    if (count == pushed.load(std::memory_order_acquire)) {
+        return false;
+    }
+    value = std::move(slots[count % slots.size()]);
+    popped.store(count + 1, std::memory_order_release);
+    return true;
+}
+
+template<class T>
+std::size_t SpscQueue<T>::getCapacity() const {
+    return slots.size();
+}
+
+}
@@ -0,0 +1,48 @@
+#ifndef TRIPLEBUFFER_HPP
+#define TRIPLEBUFFER_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace wotmin2d {
+
+/**
+ * Hands the latest version of a value from one writer thread to one reader
+ * thread without locks and without either thread ever waiting for the other.
+ *
+ * There are three buffers: the writer fills the back buffer, the reader looks
+ * at the front buffer, and the third one holds the most recently published
+ * value. Publishing and updating swap the back or front buffer with the middle
+ * one, so a value the reader hasn't picked up yet is replaced by a newer one
+ * instead of queueing up. The buffers are reused, so values that hold memory
+ * (e.g. vectors) stop allocating once all three have reached their size.
+ */
+template<class T>
+class TripleBuffer {
+    public:
+    TripleBuffer();
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+    T& getBack();
+    void publish();
+    bool update();
+    const T& getFront() const;
+    private:
+    // The middle index is stored together with a flag telling whether it was
+    // published after the reader last updated.
+    constexpr static std::uint8_t index_mask = 0x3;
+    constexpr static std::uint8_t fresh = 0x4;
+    std::array<T, 3> buffers;
+    // Only used by the writer.
+    std::uint8_t back;
+    std::atomic<std::uint8_t> middle;
+    // Only used by the reader.
+    std::uint8_t front;
+};
+
+}
+
+#include "TripleBuffer.tpp"
+
+#endif
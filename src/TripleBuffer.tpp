@@ -0,0 +1,49 @@
+namespace wotmin2d {
+
+template<class T>
+constexpr std::uint8_t TripleBuffer<T>::index_mask;
+
+template<class T>
+constexpr std::uint8_t TripleBuffer<T>::fresh;
+
+template<class T>
+TripleBuffer<T>::TripleBuffer() :
+    buffers(),
+    back(0),
+    middle(1),
+    front(2) {}
+
+// Returns the buffer the writer may fill. It holds whatever was written to it
+// two publishes ago (or a default constructed value).
+template<class T>
+T& TripleBuffer<T>::getBack() {
+    return buffers[back];
+}
+
+// Makes the back buffer the latest value. Called by the writer.
+template<class T>
+void TripleBuffer<T>::publish() {
+    back = middle.exchange(back | fresh, std::memory_order_acq_rel)
+           & index_mask;
+}
+
+// Makes the latest published value the front buffer, if there is one the
+// reader hasn't seen yet. Returns whether the front buffer changed. Called by
+// the reader.
+template<class T>
+bool TripleBuffer<T>::update() {
+    if ((middle.load(std::memory_order_acquire) & fresh) == 0) {
+        return false;
+    }
+    front = middle.exchange(front, std::memory_order_acq_rel) & index_mask;
+    return true;
+}
+
+// Returns the value the reader last picked up with update(), a default
+// constructed value before that.
+template<class T>
+const T& TripleBuffer<T>::getFront() const {
+    return buffers[front];
+}
+
+}
@@ -0,0 +1,105 @@
+#include "WorkerPool.hpp"
+
+#include <cassert>
+
+namespace wotmin2d {
+
+WorkerPool::WorkerPool(unsigned int thread_count) :
+    workers(),
+    mutex(),
+    batch_started(),
+    batch_finished(),
+    task(nullptr),
+    task_count(0),
+    next_task(0),
+    unfinished(0),
+    stopping(false) {
+    for (unsigned int i = 1; i < thread_count; i++) {
+        workers.emplace_back(&WorkerPool::work, this);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    batch_started.notify_all();
+    for (std::thread& worker: workers) {
+        worker.join();
+    }
+}
+
+// Returns the number of threads working on a batch, including the caller.
+unsigned int WorkerPool::getThreadCount() const {
+    return static_cast<unsigned int>(workers.size()) + 1;
+}
+
+// Calls the task with each index in [0, task_count), spread over the threads
+// of the pool, and returns once all calls have returned. Tasks are handed out
+// in order, but may finish in any order.
+void WorkerPool::run(unsigned int task_count, const Task& task) {
+    if (task_count == 0) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        assert(unfinished == 0 && "Batches can't overlap.");
+        this->task = &task;
+        this->task_count = task_count;
+        next_task = 0;
+        unfinished = task_count;
+    }
+    batch_started.notify_all();
+    unsigned int index;
+    while (takeTask(index)) {
+        task(index);
+        finishTask();
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    batch_finished.wait(lock, [this]() { return unfinished == 0; });
+    this->task = nullptr;
+}
+
+void WorkerPool::work() {
+    while (true) {
+        const Task* current;
+        unsigned int index;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            batch_started.wait(lock, [this]() {
+                return stopping || next_task < task_count;
+            });
+            if (stopping) {
+                return;
+            }
+            current = task;
+            index = next_task++;
+        }
+        (*current)(index);
+        finishTask();
+    }
+}
+
+bool WorkerPool::takeTask(unsigned int& index) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (next_task >= task_count) {
+        return false;
+    }
+    index = next_task++;
+    return true;
+}
+
+void WorkerPool::finishTask() {
+    bool finished;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        unfinished--;
+        finished = unfinished == 0;
+    }
+    if (finished) {
+        batch_finished.notify_one();
+    }
+}
+
+}
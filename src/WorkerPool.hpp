@@ -0,0 +1,47 @@
+#ifndef WORKERPOOL_HPP
+#define WORKERPOOL_HPP
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+namespace wotmin2d {
+
+/**
+ * Threads that are started once and then run batches of numbered tasks, so
+ * that work split across threads every tick doesn't start and join threads
+ * every tick. Between batches the workers wait on a condition variable.
+ *
+ * The thread calling run() works on the batch as well, so a pool of n threads
+ * has n - 1 workers, and a pool of one thread runs everything on the caller.
+ */
+class WorkerPool {
+    public:
+    using Task = std::function<void(unsigned int)>;
+    explicit WorkerPool(unsigned int thread_count);
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+    ~WorkerPool();
+    unsigned int getThreadCount() const;
+    void run(unsigned int task_count, const Task& task);
+    private:
+    void work();
+    bool takeTask(unsigned int& index);
+    void finishTask();
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable batch_started;
+    std::condition_variable batch_finished;
+    // The current batch, only valid while unfinished isn't zero.
+    const Task* task;
+    unsigned int task_count;
+    unsigned int next_task;
+    unsigned int unfinished;
+    bool stopping;
+};
+
+}
+
+#endif
@@ -0,0 +1,98 @@
+#include "BatchRunner.hpp"
+#include "Config.hpp"
+
+#include <iostream>
+#include <string>
+#include <stdexcept>
+#include <exception>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <cstdint>
+
+namespace {
+
+void printUsage() {
+    std::cerr << "Usage: WoTMin2DBatch [--trials n] [--threads n] [--seed n]"
+              << " [--max-ticks n]\n"
+              << "                     [--arena width height]"
+              << " [--radius min max]" << std::endl;
+}
+
+void printConfig(std::ostream& stream) {
+    using wotmin2d::Config;
+    stream << "Config: particle_damage " << Config::particle_damage
+           << ", collision_pass_on " << Config::collision_pass_on
+           << ", boost_fraction " << Config::boost_fraction << "\n";
+}
+
+}
+
+// Runs battles between random pairs of blobs without display and prints how
+// they ended. The balance constants in Config are compiled in, they are
+// printed along with the results so that runs of different builds can be
+// told apart.
+int main(int argc, char** argv) {
+    wotmin2d::BatchRunner::Settings settings;
+    std::size_t trial_count = 1000;
+    unsigned int thread_count = std::thread::hardware_concurrency();
+    if (thread_count == 0) {
+        thread_count = 1;
+    }
+    try {
+        for (int arg = 1; arg < argc; arg++) {
+            std::string option(argv[arg]);
+            int remaining = argc - arg - 1;
+            if (option == "--trials" && remaining >= 1) {
+                trial_count = std::stoul(argv[++arg]);
+            } else if (option == "--threads" && remaining >= 1) {
+                thread_count = std::stoul(argv[++arg]);
+            } else if (option == "--seed" && remaining >= 1) {
+                settings.seed = std::stoull(argv[++arg]);
+            } else if (option == "--max-ticks" && remaining >= 1) {
+                settings.max_ticks = std::stoull(argv[++arg]);
+            } else if (option == "--arena" && remaining >= 2) {
+                settings.arena_width = std::stoul(argv[++arg]);
+                settings.arena_height = std::stoul(argv[++arg]);
+            } else if (option == "--radius" && remaining >= 2) {
+                settings.min_radius = std::stof(argv[++arg]);
+                settings.max_radius = std::stof(argv[++arg]);
+            } else {
+                printUsage();
+                return 1;
+            }
+        }
+    } catch (const std::logic_error&) {
+        printUsage();
+        return 1;
+    }
+    if (thread_count == 0 || settings.arena_width == 0
+        || settings.arena_height == 0 || settings.min_radius <= 0.0f
+        || settings.min_radius > settings.max_radius) {
+        printUsage();
+        return 1;
+    }
+    if (!wotmin2d::BatchRunner::fitsArena(settings)) {
+        std::cerr << "Two blobs of radius " << settings.max_radius
+                  << " don't fit apart in an arena of " << settings.arena_width
+                  << "x" << settings.arena_height << "." << std::endl;
+        return 1;
+    }
+
+    using std::chrono::steady_clock;
+    wotmin2d::BatchRunner runner(settings);
+    steady_clock::time_point start_time = steady_clock::now();
+    std::vector<wotmin2d::BatchRunner::TrialResult> results;
+    try {
+        results = runner.run(trial_count, thread_count);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    std::chrono::duration<double> elapsed = steady_clock::now() - start_time;
+    printConfig(std::cout);
+    wotmin2d::BatchStatistics(results).print(std::cout);
+    std::cout << "Ran " << trial_count << " trials on " << thread_count
+              << " threads in " << elapsed.count() << " s." << std::endl;
+    return 0;
+}
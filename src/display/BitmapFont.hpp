@@ -0,0 +1,34 @@
+#ifndef BITMAPFONT_HPP
+#define BITMAPFONT_HPP
+
+#include <array>
+#include <cstdint>
+
+namespace wotmin2d {
+
+/**
+ * A fixed 5 by 7 pixel font for text drawn on screen without any font
+ * library. A glyph is a row of bits for each line from the top, the leftmost
+ * pixel in bit 4. There are glyphs for the printable ASCII characters up to
+ * '_'. Lower case letters are shown as upper case ones and anything else as
+ * '?'.
+ */
+class BitmapFont {
+    public:
+    constexpr static unsigned int glyph_width = 5;
+    constexpr static unsigned int glyph_height = 7;
+    // From the start of one glyph to the next, including the gap.
+    constexpr static unsigned int advance = glyph_width + 1;
+    using Glyph = std::array<std::uint8_t, glyph_height>;
+    static const Glyph& getGlyph(char character);
+    static bool isSet(const Glyph& glyph, unsigned int x, unsigned int y);
+    static unsigned int getWidth(const char* text);
+    private:
+    constexpr static char first = ' ';
+    constexpr static char last = '_';
+    static const std::array<Glyph, last - first + 1> glyphs;
+};
+
+}
+
+#endif
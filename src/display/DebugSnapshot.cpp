@@ -0,0 +1,83 @@
+#include "DebugSnapshot.hpp"
+
+namespace wotmin2d {
+
+constexpr unsigned int DebugSnapshot::pressure_layer;
+constexpr unsigned int DebugSnapshot::strength_layer;
+constexpr unsigned int DebugSnapshot::leadership_layer;
+constexpr unsigned int DebugSnapshot::block_pixels;
+constexpr unsigned int DebugSnapshot::strength_samples;
+constexpr std::size_t DebugSnapshot::max_links;
+
+DebugSnapshot::Block::Block() :
+    pressure(0.0f, 0.0f),
+    strength(0),
+    particles(0) {}
+
+DebugSnapshot::DebugSnapshot() :
+    viewport(),
+    layers(0),
+    block_cells(1),
+    columns(0),
+    rows(0),
+    blocks(),
+    links(),
+    strength_counts(),
+    max_pressure(1.0f),
+    max_strength(1),
+    tick(0) {}
+
+unsigned int DebugSnapshot::getLayers() const {
+    return layers;
+}
+
+const Viewport& DebugSnapshot::getViewport() const {
+    return viewport;
+}
+
+// Returns the side of a block in cells.
+unsigned int DebugSnapshot::getBlockCells() const {
+    return block_cells;
+}
+
+unsigned int DebugSnapshot::getColumns() const {
+    return columns;
+}
+
+unsigned int DebugSnapshot::getRows() const {
+    return rows;
+}
+
+// Blocks are counted from the viewport's origin, rows from the bottom. Without
+// layers there are none.
+const DebugSnapshot::Block& DebugSnapshot::getBlock(unsigned int column,
+                                                    unsigned int row) const {
+    assert(column < columns && row < rows && !blocks.empty());
+    return blocks[static_cast<std::size_t>(row) * columns + column];
+}
+
+const std::vector<DebugSnapshot::Link>& DebugSnapshot::getLinks() const {
+    return links;
+}
+
+// Returns the largest mean pressure of a block, but at least the pressure a
+// particle needs to move, so lines are drawn in proportion to it.
+float DebugSnapshot::getMaxPressure() const {
+    return max_pressure;
+}
+
+// Returns the strength of a particle surrounded by its blob.
+int DebugSnapshot::getMaxStrength() const {
+    return max_strength;
+}
+
+std::uint64_t DebugSnapshot::getTick() const {
+    return tick;
+}
+
+std::size_t DebugSnapshot::getMemoryUsage() const {
+    return blocks.capacity() * sizeof(Block) + links.capacity() * sizeof(Link)
+           + strength_counts.capacity();
+}
+
+}
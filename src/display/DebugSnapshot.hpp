@@ -0,0 +1,92 @@
+#ifndef DEBUGSNAPSHOT_HPP
+#define DEBUGSNAPSHOT_HPP
+
+#include "Viewport.hpp"
+#include "../game/Vector.hpp"
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+#include <algorithm>
+
+namespace wotmin2d {
+
+/**
+ * What the screen needs to draw the debug layers over a tick, captured like a
+ * RenderSnapshot so that drawing them never holds up the simulation. Layers
+ * are bits that can be combined:
+ *
+ * - pressure_layer: the mean pressure of the particles in each block, drawn as
+ *   a line from the block's center.
+ * - strength_layer: the strength of the particles in each block (see
+ *   Blob::getParticleStrength()), drawn as a heat map.
+ * - leadership_layer: links from visible followers to their leaders.
+ *
+ * Blocks are squares of cells that show as about block_pixels pixels, starting
+ * at the viewport's origin, so their number depends on the window, not on the
+ * arena or the zoom. Only the layers asked for are captured, and only for
+ * visible particles. A blob with more particles than there are visible cells
+ * is looked up cell by cell, so zoomed in on a large battle the capture
+ * doesn't go through all of its particles. Computing a particle's strength
+ * means looking at the cells around it, so at most strength_samples particles
+ * per block are looked at, and a block's strength is the highest of them.
+ * Links are captured up to max_links.
+ */
+class DebugSnapshot {
+    public:
+    struct Block {
+        Block();
+        FloatVector pressure;
+        int strength;
+        std::uint32_t particles;
+    };
+    struct Link {
+        IntVector follower;
+        IntVector leader;
+    };
+    constexpr static unsigned int pressure_layer = 1;
+    constexpr static unsigned int strength_layer = 2;
+    constexpr static unsigned int leadership_layer = 4;
+    constexpr static unsigned int block_pixels = 8;
+    constexpr static unsigned int strength_samples = 4;
+    constexpr static std::size_t max_links = 4096;
+    DebugSnapshot();
+    template<class S>
+    void capture(const S& state, const Viewport& viewport, unsigned int layers,
+                 std::uint64_t tick);
+    unsigned int getLayers() const;
+    const Viewport& getViewport() const;
+    unsigned int getBlockCells() const;
+    unsigned int getColumns() const;
+    unsigned int getRows() const;
+    const Block& getBlock(unsigned int column, unsigned int row) const;
+    const std::vector<Link>& getLinks() const;
+    float getMaxPressure() const;
+    int getMaxStrength() const;
+    std::uint64_t getTick() const;
+    std::size_t getMemoryUsage() const;
+    private:
+    template<class B>
+    void putBlob(const B& blob);
+    template<class B, class P>
+    void putParticle(const B& blob, const P& particle);
+    Viewport viewport;
+    unsigned int layers;
+    unsigned int block_cells;
+    unsigned int columns;
+    unsigned int rows;
+    std::vector<Block> blocks;
+    std::vector<Link> links;
+    // How many particles' strength has been computed in each block.
+    std::vector<std::uint8_t> strength_counts;
+    float max_pressure;
+    int max_strength;
+    std::uint64_t tick;
+};
+
+}
+
+#include "DebugSnapshot.tpp"
+
+#endif
@@ -0,0 +1,109 @@
+namespace wotmin2d {
+
+// Fills the snapshot with the given layers from the state at the given tick,
+// as seen through the viewport. Nothing is captured without layers.
+template<class S>
+void DebugSnapshot::capture(const S& state, const Viewport& viewport,
+                            unsigned int layers, std::uint64_t tick) {
+    using Config = typename S::Config;
+    this->viewport = viewport;
+    this->layers = layers;
+    this->tick = tick;
+    block_cells = std::max(1u, block_pixels * viewport.getCellsPerSample()
+                               / viewport.getPixelsPerSample());
+    columns = (viewport.getColumns() * viewport.getCellsPerSample()
+               + block_cells - 1) / block_cells;
+    rows = (viewport.getRows() * viewport.getCellsPerSample() + block_cells - 1)
+           / block_cells;
+    std::size_t block_count = static_cast<std::size_t>(columns) * rows;
+    blocks.assign(layers == 0 ? 0 : block_count, Block());
+    strength_counts.assign((layers & strength_layer) ? block_count : 0, 0);
+    links.clear();
+    int side = 2 * Config::particle_strength_offset + 1;
+    max_strength = side * side;
+    max_pressure = Config::min_directed_movement_pressure;
+    if (layers == 0) {
+        return;
+    }
+    for (const auto& id_blob: state.getBlobs()) {
+        putBlob(id_blob.second);
+    }
+    if ((layers & pressure_layer) == 0) {
+        return;
+    }
+    for (Block& block: blocks) {
+        if (block.particles > 0) {
+            block.pressure /= static_cast<float>(block.particles);
+            max_pressure = std::max(max_pressure, block.pressure.norm());
+        }
+    }
+}
+
+// Puts the blob's visible particles into the blocks. They are found either by
+// looking up each visible cell or by going through all particles, whichever
+// means fewer steps, like in RenderSnapshot::putBlob().
+template<class B>
+void DebugSnapshot::putBlob(const B& blob) {
+    IntVector begin = viewport.getVisibleBegin();
+    IntVector end = viewport.getVisibleEnd();
+    if (end.getX() <= begin.getX() || end.getY() <= begin.getY()) {
+        return;
+    }
+    std::size_t visible_cells
+        = static_cast<std::size_t>(end.getX() - begin.getX())
+          * static_cast<std::size_t>(end.getY() - begin.getY());
+    if (visible_cells < blob.getParticles().size()) {
+        for (int y = begin.getY(); y < end.getY(); y++) {
+            for (int x = begin.getX(); x < end.getX(); x++) {
+                const auto* particle = blob.getParticleAt(IntVector(x, y));
+                if (particle != nullptr) {
+                    putParticle(blob, *particle);
+                }
+            }
+        }
+        return;
+    }
+    for (const auto* particle: blob.getParticles()) {
+        const IntVector& position = particle->getPosition();
+        if (position.getX() >= begin.getX() && position.getX() < end.getX()
+            && position.getY() >= begin.getY()
+            && position.getY() < end.getY()) {
+            putParticle(blob, *particle);
+        }
+    }
+}
+
+// Adds a visible particle to its block.
+template<class B, class P>
+void DebugSnapshot::putParticle(const B& blob, const P& particle) {
+    // The visible part doesn't start before the origin.
+    const IntVector& origin = viewport.getOrigin();
+    const IntVector& position = particle.getPosition();
+    int cells = static_cast<int>(block_cells);
+    std::size_t index
+        = static_cast<std::size_t>((position.getY() - origin.getY()) / cells)
+          * columns
+          + static_cast<std::size_t>((position.getX() - origin.getX())
+                                     / cells);
+    Block& block = blocks[index];
+    block.particles++;
+    if (layers & pressure_layer) {
+        block.pressure += particle.getPressure();
+    }
+    if ((layers & strength_layer)
+        && strength_counts[index] < strength_samples) {
+        strength_counts[index]++;
+        block.strength = std::max(block.strength,
+                                  blob.getParticleStrength(particle));
+    }
+    if (layers & leadership_layer) {
+        for (const auto* leader: particle.getConstLeaders()) {
+            if (links.size() == max_links) {
+                break;
+            }
+            links.push_back({ position, leader->getPosition() });
+        }
+    }
+}
+
+}
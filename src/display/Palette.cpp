@@ -0,0 +1,62 @@
+#include "Palette.hpp"
+
+#include <cmath>
+
+namespace wotmin2d {
+
+constexpr std::size_t Palette::size;
+
+const Palette::Color Palette::background = { 0xff, 0xff, 0xff };
+
+Palette::Palette() :
+    colors() {
+    colors[0] = background;
+    colors[1] = { 0x00, 0x00, 0xff };
+    colors[2] = { 0xff, 0x00, 0x00 };
+    // Stepping by the golden ratio never comes back close to a hue used
+    // before. Start away from the blue and red of the first two players.
+    const float golden_ratio_conjugate = 0.618034f;
+    float hue = 0.3f;
+    for (std::size_t i = 3; i < size; i++) {
+        colors[i] = fromHue(hue);
+        hue = std::fmod(hue + golden_ratio_conjugate, 1.0f);
+    }
+}
+
+const Palette::Color& Palette::getColor(std::uint8_t index) const {
+    return colors[index];
+}
+
+Palette::Color Palette::blend(const Color& from, const Color& to,
+                              float fraction) {
+    Color blended;
+    for (std::size_t i = 0; i < blended.size(); i++) {
+        float channel = from[i] + (to[i] - from[i]) * fraction;
+        blended[i] = static_cast<std::uint8_t>(channel);
+    }
+    return blended;
+}
+
+// Returns a fully saturated, slightly dark color (so it stands out on the
+// background) of the given hue in [0, 1).
+Palette::Color Palette::fromHue(float hue) {
+    const float value = 0.85f;
+    float sector = hue * 6.0f;
+    int sector_index = static_cast<int>(sector) % 6;
+    float rising = value * (sector - std::floor(sector));
+    float falling = value - rising;
+    float red, green, blue;
+    switch (sector_index) {
+    case 0: red = value; green = rising; blue = 0.0f; break;
+    case 1: red = falling; green = value; blue = 0.0f; break;
+    case 2: red = 0.0f; green = value; blue = rising; break;
+    case 3: red = 0.0f; green = falling; blue = value; break;
+    case 4: red = rising; green = 0.0f; blue = value; break;
+    default: red = value; green = 0.0f; blue = falling; break;
+    }
+    return { static_cast<std::uint8_t>(red * 255.0f),
+             static_cast<std::uint8_t>(green * 255.0f),
+             static_cast<std::uint8_t>(blue * 255.0f) };
+}
+
+}
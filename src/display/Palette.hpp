@@ -0,0 +1,31 @@
+#ifndef PALETTE_HPP
+#define PALETTE_HPP
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+namespace wotmin2d {
+
+/**
+ * The color of each value a cell of a RenderSnapshot can hold: the background
+ * for empty cells and one color per player. The first two players are blue and
+ * red, further players get hues spread around the color wheel so that
+ * neighboring ids look different.
+ */
+class Palette {
+    public:
+    using Color = std::array<std::uint8_t, 3>;
+    constexpr static std::size_t size = 256;
+    Palette();
+    const Color& getColor(std::uint8_t index) const;
+    static Color blend(const Color& from, const Color& to, float fraction);
+    const static Color background;
+    private:
+    static Color fromHue(float hue);
+    std::array<Color, size> colors;
+};
+
+}
+
+#endif
@@ -0,0 +1,21 @@
+#include "PerformanceSnapshot.hpp"
+
+namespace wotmin2d {
+
+constexpr std::size_t PerformanceSnapshot::max_players;
+
+PerformanceSnapshot::PerformanceSnapshot() :
+    tick(0),
+    tick_duration(Clock::duration::zero()),
+    profile(),
+    output(Clock::duration::zero()),
+    capture(Clock::duration::zero()),
+    tick_overruns(0),
+    dropped_ticks(0),
+    draw_time(Clock::duration::zero()),
+    skipped_renders(0),
+    player_count(0),
+    players(),
+    particles() {}
+
+}
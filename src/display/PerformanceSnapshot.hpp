@@ -0,0 +1,53 @@
+#ifndef PERFORMANCESNAPSHOT_HPP
+#define PERFORMANCESNAPSHOT_HPP
+
+#include "../game/TickProfile.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+namespace wotmin2d {
+
+/**
+ * What the performance overlay shows: how long the last tick took and where
+ * the time went, how well the simulation and drawing keep up, and how many
+ * particles each player has. It has a fixed size, so it's passed from the
+ * simulation thread through a triple buffer and drawn without allocating. The
+ * main thread fills in how drawing goes before showing it.
+ *
+ * Players are listed by id, at most max_players of them.
+ */
+struct PerformanceSnapshot {
+    using Clock = std::chrono::steady_clock;
+    constexpr static std::size_t max_players = 8;
+    PerformanceSnapshot();
+    template<class S>
+    void countParticles(const S& state);
+    std::uint64_t tick;
+    Clock::duration tick_duration;
+    TickProfile profile;
+    // Writing the delta stream, keyframes and checkpoints after the tick.
+    Clock::duration output;
+    // Capturing the render and debug snapshots of the tick.
+    Clock::duration capture;
+    // Ticks that took longer than the tick duration, and ticks skipped because
+    // the simulation fell too far behind (see FixedTimestep).
+    std::uint64_t tick_overruns;
+    std::uint64_t dropped_ticks;
+    // Filled in by the main thread: the mean time to draw a frame and renders
+    // skipped because drawing fell behind.
+    Clock::duration draw_time;
+    std::uint64_t skipped_renders;
+    std::size_t player_count;
+    std::array<std::uint8_t, max_players> players;
+    std::array<std::size_t, max_players> particles;
+};
+
+}
+
+#include "PerformanceSnapshot.tpp"
+
+#endif
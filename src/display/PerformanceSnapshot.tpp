@@ -0,0 +1,27 @@
+namespace wotmin2d {
+
+// Counts the particles of each player in the state, keeping the players with
+// the lowest ids if there are too many.
+template<class S>
+void PerformanceSnapshot::countParticles(const S& state) {
+    player_count = 0;
+    for (const auto& id_blob: state.getBlobs()) {
+        std::uint8_t player = static_cast<std::uint8_t>(id_blob.first);
+        std::size_t count = id_blob.second.getParticles().size();
+        // Insertion sort, there are only a few players.
+        std::size_t i = player_count;
+        for (; i > 0 && players[i - 1] > player; i--) {
+            if (i < max_players) {
+                players[i] = players[i - 1];
+                particles[i] = particles[i - 1];
+            }
+        }
+        if (i < max_players) {
+            players[i] = player;
+            particles[i] = count;
+            player_count = std::min(player_count + 1, max_players);
+        }
+    }
+}
+
+}
@@ -0,0 +1,240 @@
+#include "RenderSnapshot.hpp"
+
+namespace wotmin2d {
+
+constexpr std::uint8_t RenderSnapshot::empty;
+constexpr unsigned int RenderSnapshot::tile_size;
+constexpr unsigned int RenderSnapshot::shade_levels;
+
+RenderSnapshot::History::History() :
+    viewport(),
+    samples(),
+    shades(),
+    tick(0),
+    blob_sizes(),
+    sequence(0) {}
+
+RenderSnapshot::RenderSnapshot() :
+    viewport(),
+    width(0),
+    height(0),
+    samples(),
+    previous_samples(),
+    shades(),
+    owner_counts(),
+    tile_columns(0),
+    tile_rows(0),
+    dirty_tiles(),
+    band_cells(),
+    band_cell_ends(),
+    tile_row_bands(),
+    selection_radius(0.0f),
+    tick(0),
+    sequence(0),
+    time() {}
+
+const Viewport& RenderSnapshot::getViewport() const {
+    return viewport;
+}
+
+unsigned int RenderSnapshot::getWidth() const {
+    return width;
+}
+
+unsigned int RenderSnapshot::getHeight() const {
+    return height;
+}
+
+std::uint8_t RenderSnapshot::getSample(unsigned int x, unsigned int y) const {
+    assert(x < width && y < height);
+    return samples[static_cast<std::size_t>(y) * width + x];
+}
+
+std::uint8_t RenderSnapshot::getPreviousSample(unsigned int x,
+                                               unsigned int y) const {
+    assert(x < width && y < height);
+    return previous_samples[static_cast<std::size_t>(y) * width + x];
+}
+
+const std::vector<std::uint8_t>& RenderSnapshot::getSamples() const {
+    return samples;
+}
+
+const std::vector<std::uint8_t>& RenderSnapshot::getPreviousSamples() const {
+    return previous_samples;
+}
+
+// Returns whether the samples were read from density pyramids and come with
+// shades.
+bool RenderSnapshot::isShaded() const {
+    return !shades.empty();
+}
+
+// Returns how full of the owner's particles the sample is, from 0 for a few to
+// shade_levels - 1 for all cells. Only for shaded snapshots.
+std::uint8_t RenderSnapshot::getShade(unsigned int x, unsigned int y) const {
+    assert(isShaded());
+    assert(x < width && y < height);
+    return shades[static_cast<std::size_t>(y) * width + x];
+}
+
+const std::vector<std::uint8_t>& RenderSnapshot::getShades() const {
+    return shades;
+}
+
+unsigned int RenderSnapshot::getTileColumns() const {
+    return tile_columns;
+}
+
+unsigned int RenderSnapshot::getTileRows() const {
+    return tile_rows;
+}
+
+// Returns whether any sample of the tile changed since the previous capture.
+// Everything is dirty in the first capture.
+bool RenderSnapshot::isTileDirty(unsigned int column, unsigned int row) const {
+    assert(column < tile_columns && row < tile_rows);
+    return dirty_tiles[row * tile_columns + column];
+}
+
+float RenderSnapshot::getSelectionRadius() const {
+    return selection_radius;
+}
+
+std::uint64_t RenderSnapshot::getTick() const {
+    return tick;
+}
+
+// Returns the number of the capture, starting at 1 for the first. A snapshot
+// directly follows another if its number is one more.
+std::uint64_t RenderSnapshot::getSequence() const {
+    return sequence;
+}
+
+// Returns when the tick was captured, so that a renderer can tell how far
+// real time has progressed towards the next tick.
+RenderSnapshot::Clock::time_point RenderSnapshot::getTime() const {
+    return time;
+}
+
+std::size_t RenderSnapshot::getMemoryUsage() const {
+    std::size_t usage = samples.capacity() + previous_samples.capacity()
+           + shades.capacity()
+           + owner_counts.capacity() * sizeof(std::uint32_t)
+           + dirty_tiles.capacity() / 8;
+    for (const std::vector<IntVector>& cells: band_cells) {
+        usage += cells.capacity() * sizeof(IntVector);
+    }
+    return usage + band_cells.capacity() * sizeof(band_cells[0])
+           + band_cell_ends.capacity() * sizeof(std::size_t)
+           + tile_row_bands.capacity() * sizeof(unsigned int);
+}
+
+// Finds the visible cells [begin, end) covered by the samples in columns
+// [column_begin, column_end) of rows [row_begin, row_end). Returns false if
+// there are none.
+bool RenderSnapshot::getCells(unsigned int column_begin,
+                              unsigned int column_end, unsigned int row_begin,
+                              unsigned int row_end, IntVector& begin,
+                              IntVector& end) const {
+    IntVector visible_begin = viewport.getVisibleBegin();
+    IntVector visible_end = viewport.getVisibleEnd();
+    int cells = static_cast<int>(viewport.getCellsPerSample());
+    const IntVector& origin = viewport.getOrigin();
+    begin = IntVector(
+        std::max(visible_begin.getX(),
+                 origin.getX() + static_cast<int>(column_begin) * cells),
+        std::max(visible_begin.getY(),
+                 origin.getY() + static_cast<int>(row_begin) * cells));
+    end = IntVector(
+        std::min(visible_end.getX(),
+                 origin.getX() + static_cast<int>(column_end) * cells),
+        std::min(visible_end.getY(),
+                 origin.getY() + static_cast<int>(row_end) * cells));
+    return begin.getX() < end.getX() && begin.getY() < end.getY();
+}
+
+// Takes a visible cell.
+void RenderSnapshot::putCell(const IntVector& cell, std::uint8_t owner) {
+    IntVector offset = cell - viewport.getOrigin();
+    int cells = static_cast<int>(viewport.getCellsPerSample());
+    unsigned int x = static_cast<unsigned int>(offset.getX() / cells);
+    unsigned int y = static_cast<unsigned int>(offset.getY() / cells);
+    assert(x < width && y < height);
+    samples[static_cast<std::size_t>(y) * width + x] = owner;
+}
+
+// Marks the tile of the sample covering the cell, if it's visible.
+void RenderSnapshot::markCell(const IntVector& cell) {
+    IntVector begin = viewport.getVisibleBegin();
+    IntVector end = viewport.getVisibleEnd();
+    if (cell.getX() < begin.getX() || cell.getX() >= end.getX()
+        || cell.getY() < begin.getY() || cell.getY() >= end.getY()) {
+        return;
+    }
+    IntVector offset = cell - viewport.getOrigin();
+    int cells = static_cast<int>(viewport.getCellsPerSample());
+    unsigned int x = static_cast<unsigned int>(offset.getX() / cells);
+    unsigned int y = static_cast<unsigned int>(offset.getY() / cells);
+    assert(x < width && y < height);
+    dirty_tiles[(y / tile_size) * tile_columns + x / tile_size] = true;
+}
+
+// Empties the samples in columns [column_begin, column_end) of rows
+// [row_begin, row_end), so that they can be filled again.
+void RenderSnapshot::clearTile(unsigned int column_begin,
+                               unsigned int column_end, unsigned int row_begin,
+                               unsigned int row_end, bool shaded) {
+    for (unsigned int y = row_begin; y < row_end; y++) {
+        std::size_t row = static_cast<std::size_t>(y) * width;
+        std::fill(samples.begin() + row + column_begin,
+                  samples.begin() + row + column_end, empty);
+        if (shaded) {
+            std::fill(shades.begin() + row + column_begin,
+                      shades.begin() + row + column_end, 0);
+            std::fill(owner_counts.begin() + row + column_begin,
+                      owner_counts.begin() + row + column_end, 0);
+        }
+    }
+}
+
+// Takes a count of at least one particle in a block of the given area. Each
+// shade covers an equal part of the possible counts.
+std::uint8_t RenderSnapshot::toShade(std::uint32_t count, unsigned int area) {
+    assert(count > 0 && count <= area);
+    return static_cast<std::uint8_t>(
+        (static_cast<std::uint64_t>(count) * shade_levels - 1) / area);
+}
+
+// Takes the tiles that can have changed as dirty and compares their samples
+// (and shades) to the previous ones a tile row at a time. Tiles that turn out
+// the same are no longer dirty, the others are skipped as soon as a difference
+// is found.
+void RenderSnapshot::findDirtyTiles(
+    const std::vector<std::uint8_t>& previous_shades) {
+    std::vector<bool> changed(tile_columns * tile_rows, false);
+    for (unsigned int y = 0; y < height; y++) {
+        unsigned int row = y / tile_size;
+        std::size_t row_start = static_cast<std::size_t>(y) * width;
+        for (unsigned int column = 0; column < tile_columns; column++) {
+            std::size_t tile = row * tile_columns + column;
+            if (!dirty_tiles[tile] || changed[tile]) {
+                continue;
+            }
+            std::size_t begin = row_start + column * tile_size;
+            std::size_t end = row_start
+                              + std::min(width, (column + 1) * tile_size);
+            if (!std::equal(samples.begin() + begin, samples.begin() + end,
+                            previous_samples.begin() + begin)
+                || (isShaded()
+                    && !std::equal(shades.begin() + begin,
+                                   shades.begin() + end,
+                                   previous_shades.begin() + begin))) {
+                changed[tile] = true;
+            }
+        }
+    }
+    dirty_tiles.swap(changed);
+}
+
+}
@@ -0,0 +1,151 @@
+#ifndef RENDERSNAPSHOT_HPP
+#define RENDERSNAPSHOT_HPP
+
+#include "Viewport.hpp"
+#include "../WorkerPool.hpp"
+#include "../game/Vector.hpp"
+#include "../game/DensityPyramid.hpp"
+#include "../game/ChangeLog.hpp"
+
+#include <chrono>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+#include <algorithm>
+#include <utility>
+
+namespace wotmin2d {
+
+/**
+ * What the screen needs to draw a tick: which player's particle (if any) is
+ * shown in each sample of the viewport (see Viewport), after the tick and
+ * before it, and the selection radius. Unlike the state, a render snapshot is
+ * a plain value, so it can be handed to a thread that draws while the state
+ * keeps advancing. Only the visible part of the arena is captured, so the size
+ * of a snapshot depends on the view, not on the arena.
+ *
+ * Samples are stored in rows starting with the bottom one. A sample holds the
+ * owning player's id plus one, or empty. When a sample covers several cells,
+ * it shows one of the particles in them, unless all blobs count their
+ * particles in a DensityPyramid. Then the snapshot is shaded: samples are read
+ * from the pyramid level that matches the zoom, without looking at particles,
+ * and show the player with the most particles in them together with a shade
+ * telling how full they are.
+ *
+ * The samples are divided into square tiles of tile_size samples (smaller at
+ * the right and top edges), and the snapshot tells which tiles have samples
+ * that changed since the previous capture, so that a screen that drew the
+ * previous capture only needs to redraw those. When capturing tick after tick,
+ * the changes the blobs logged tell which tiles can have changed, and only
+ * those are filled again.
+ */
+class RenderSnapshot {
+    public:
+    using Clock = std::chrono::steady_clock;
+    /**
+     * What whoever captures snapshots needs to remember between captures.
+     * It's kept by the caller since the snapshot that was captured last is
+     * usually a different object (see TripleBuffer).
+     */
+    struct History {
+        History();
+        Viewport viewport;
+        std::vector<std::uint8_t> samples;
+        std::vector<std::uint8_t> shades;
+        std::uint64_t tick;
+        // The owner and particle count of each blob.
+        std::vector<std::pair<std::uint8_t, std::size_t>> blob_sizes;
+        std::uint64_t sequence;
+    };
+    constexpr static std::uint8_t empty = 0;
+    constexpr static unsigned int tile_size = 32;
+    constexpr static unsigned int shade_levels = 16;
+    RenderSnapshot();
+    template<class S>
+    void capture(const S& state, const Viewport& viewport, std::uint64_t tick,
+                 Clock::time_point time, History& history,
+                 WorkerPool* workers = nullptr);
+    const Viewport& getViewport() const;
+    unsigned int getWidth() const;
+    unsigned int getHeight() const;
+    std::uint8_t getSample(unsigned int x, unsigned int y) const;
+    std::uint8_t getPreviousSample(unsigned int x, unsigned int y) const;
+    const std::vector<std::uint8_t>& getSamples() const;
+    const std::vector<std::uint8_t>& getPreviousSamples() const;
+    bool isShaded() const;
+    std::uint8_t getShade(unsigned int x, unsigned int y) const;
+    const std::vector<std::uint8_t>& getShades() const;
+    unsigned int getTileColumns() const;
+    unsigned int getTileRows() const;
+    bool isTileDirty(unsigned int column, unsigned int row) const;
+    float getSelectionRadius() const;
+    std::uint64_t getTick() const;
+    std::uint64_t getSequence() const;
+    Clock::time_point getTime() const;
+    std::size_t getMemoryUsage() const;
+    private:
+    template<class S>
+    bool canShade(const S& state) const;
+    template<class S>
+    bool canUpdate(const S& state, std::uint64_t tick,
+                   const History& history) const;
+    template<class S>
+    void markChangedTiles(const S& state);
+    template<class S>
+    void fillDirtyTiles(const S& state, bool shaded);
+    template<class S>
+    void fillBands(const S& state, bool shaded, WorkerPool* workers);
+    template<class S>
+    void sortIntoBands(const S& state, unsigned int bands);
+    template<class B>
+    bool walksParticles(const B& blob) const;
+    template<class S>
+    void putDensities(const S& state, unsigned int column_begin,
+                      unsigned int column_end, unsigned int row_begin,
+                      unsigned int row_end);
+    template<class B>
+    void putBlob(const B& blob, std::uint8_t owner, unsigned int column_begin,
+                 unsigned int column_end, unsigned int row_begin,
+                 unsigned int row_end);
+    template<class B>
+    void lookUpCells(const B& blob, std::uint8_t owner,
+                     unsigned int column_begin, unsigned int column_end,
+                     unsigned int row_begin, unsigned int row_end);
+    bool getCells(unsigned int column_begin, unsigned int column_end,
+                  unsigned int row_begin, unsigned int row_end,
+                  IntVector& begin, IntVector& end) const;
+    void putCell(const IntVector& cell, std::uint8_t owner);
+    void markCell(const IntVector& cell);
+    void clearTile(unsigned int column_begin, unsigned int column_end,
+                   unsigned int row_begin, unsigned int row_end, bool shaded);
+    static std::uint8_t toShade(std::uint32_t count, unsigned int area);
+    void findDirtyTiles(const std::vector<std::uint8_t>& previous_shades);
+    Viewport viewport;
+    unsigned int width;
+    unsigned int height;
+    std::vector<std::uint8_t> samples;
+    std::vector<std::uint8_t> previous_samples;
+    // Empty unless the snapshot is shaded.
+    std::vector<std::uint8_t> shades;
+    // The particle count of each sample's owner while finding the owners.
+    std::vector<std::uint32_t> owner_counts;
+    unsigned int tile_columns;
+    unsigned int tile_rows;
+    std::vector<bool> dirty_tiles;
+    // The visible cells of walked particles by band, see sortIntoBands().
+    std::vector<std::vector<IntVector>> band_cells;
+    std::vector<std::size_t> band_cell_ends;
+    std::vector<unsigned int> tile_row_bands;
+    float selection_radius;
+    std::uint64_t tick;
+    // Counts captures, so a screen can tell whether it missed one.
+    std::uint64_t sequence;
+    Clock::time_point time;
+};
+
+}
+
+#include "RenderSnapshot.tpp"
+
+#endif
@@ -0,0 +1,394 @@
+namespace wotmin2d {
+
+// Fills the snapshot from the state at the given tick, as seen through the
+// viewport. The samples of the previous capture are taken from the history,
+// which is then updated with this one. If the viewport changed since then,
+// nothing is blended and everything is dirty.
+//
+// If the previous capture was of the tick before and every blob logged its
+// changes since then (see Blob::getChanges()), only the tiles with cells that
+// changed are filled again, the others are copied from the previous capture.
+// Otherwise, the rows of samples are split into as many bands as the workers
+// have threads (but no band smaller than a row of tiles), and each band is
+// filled by its own task. Bands go through the blobs in the same order, so the
+// result doesn't depend on the number of threads.
+template<class S>
+void RenderSnapshot::capture(const S& state, const Viewport& viewport,
+                             std::uint64_t tick, Clock::time_point time,
+                             History& history, WorkerPool* workers) {
+    this->viewport = viewport;
+    width = viewport.getColumns();
+    height = viewport.getRows();
+    tile_columns = (width + tile_size - 1) / tile_size;
+    tile_rows = (height + tile_size - 1) / tile_size;
+    std::size_t sample_count = static_cast<std::size_t>(width) * height;
+    bool shaded = canShade(state);
+    bool continued = history.viewport == viewport
+                     && history.samples.size() == sample_count
+                     && history.shades.size() == (shaded ? sample_count : 0);
+    if (continued && canUpdate(state, tick, history)) {
+        samples.assign(history.samples.begin(), history.samples.end());
+        shades.assign(history.shades.begin(), history.shades.end());
+        owner_counts.resize(shaded ? sample_count : 0);
+        markChangedTiles(state);
+        fillDirtyTiles(state, shaded);
+    } else {
+        samples.assign(sample_count, empty);
+        if (shaded) {
+            owner_counts.assign(sample_count, 0);
+            shades.assign(sample_count, 0);
+        } else {
+            shades.clear();
+        }
+        fillBands(state, shaded, workers);
+        dirty_tiles.assign(tile_columns * tile_rows, true);
+    }
+    if (continued) {
+        previous_samples.assign(history.samples.begin(),
+                                history.samples.end());
+        findDirtyTiles(history.shades);
+    } else {
+        previous_samples.assign(samples.begin(), samples.end());
+    }
+    history.viewport = viewport;
+    history.samples.assign(samples.begin(), samples.end());
+    history.shades.assign(shades.begin(), shades.end());
+    history.tick = tick;
+    history.blob_sizes.clear();
+    for (const auto& id_blob: state.getBlobs()) {
+        history.blob_sizes.emplace_back(
+            static_cast<std::uint8_t>(id_blob.first + 1),
+            id_blob.second.getParticles().size());
+    }
+    history.sequence++;
+    selection_radius = state.getSelectionRadius();
+    this->tick = tick;
+    sequence = history.sequence;
+    this->time = time;
+}
+
+// Returns whether the changes logged by the blobs are all that happened since
+// the previous capture: it was of the tick before, the blobs are the same, all
+// of their logs are complete, and each lost exactly the particles logged as
+// dead. A restore leaves the logs incomplete (see ChangeLog), particles added
+// outside a tick (like by a scenario) fail the last check.
+template<class S>
+bool RenderSnapshot::canUpdate(const S& state, std::uint64_t tick,
+                               const History& history) const {
+    if (history.sequence == 0 || tick != history.tick + 1
+        || state.getBlobs().size() != history.blob_sizes.size()) {
+        return false;
+    }
+    auto previous = history.blob_sizes.begin();
+    for (const auto& id_blob: state.getBlobs()) {
+        const ChangeLog& changes = id_blob.second.getChanges();
+        if (!changes.isComplete()
+            || previous->first != id_blob.first + 1) {
+            return false;
+        }
+        std::size_t deaths = std::count_if(
+            changes.getChanges().begin(), changes.getChanges().end(),
+            [](const ChangeLog::Change& change) {
+                return change.getType() == ChangeLog::Change::Type::death;
+            });
+        if (id_blob.second.getParticles().size() + deaths
+            != previous->second) {
+            return false;
+        }
+        ++previous;
+    }
+    return true;
+}
+
+// Marks the tiles with samples covering a cell that a particle left, entered
+// or died in. Damage doesn't change what is shown.
+template<class S>
+void RenderSnapshot::markChangedTiles(const S& state) {
+    dirty_tiles.assign(tile_columns * tile_rows, false);
+    for (const auto& id_blob: state.getBlobs()) {
+        for (const ChangeLog::Change& change:
+             id_blob.second.getChanges().getChanges()) {
+            switch (change.getType()) {
+            case ChangeLog::Change::Type::move:
+                markCell(change.getPosition());
+                markCell(change.getPosition()
+                         + change.getDirection().vector());
+                break;
+            case ChangeLog::Change::Type::death:
+                markCell(change.getPosition());
+                break;
+            case ChangeLog::Change::Type::damage:
+                break;
+            }
+        }
+    }
+}
+
+// Empties the samples of the marked tiles and fills them again from all blobs,
+// in the same order as a full capture.
+template<class S>
+void RenderSnapshot::fillDirtyTiles(const S& state, bool shaded) {
+    for (unsigned int row = 0; row < tile_rows; row++) {
+        for (unsigned int column = 0; column < tile_columns; column++) {
+            if (!dirty_tiles[row * tile_columns + column]) {
+                continue;
+            }
+            unsigned int x_begin = column * tile_size;
+            unsigned int x_end = std::min(width, x_begin + tile_size);
+            unsigned int y_begin = row * tile_size;
+            unsigned int y_end = std::min(height, y_begin + tile_size);
+            clearTile(x_begin, x_end, y_begin, y_end, shaded);
+            if (shaded) {
+                putDensities(state, x_begin, x_end, y_begin, y_end);
+                continue;
+            }
+            for (const auto& id_blob: state.getBlobs()) {
+                putBlob(id_blob.second,
+                        static_cast<std::uint8_t>(id_blob.first + 1),
+                        x_begin, x_end, y_begin, y_end);
+            }
+        }
+    }
+}
+
+// Fills the whole view a band of rows per task. Blobs whose particles are
+// walked instead of looking up cells are first sorted into the bands on the
+// calling thread, so that each particle is only visited once.
+template<class S>
+void RenderSnapshot::fillBands(const S& state, bool shaded,
+                               WorkerPool* workers) {
+    unsigned int threads = workers != nullptr ? workers->getThreadCount() : 1;
+    unsigned int bands = std::max(1u, std::min(threads, tile_rows));
+    if (!shaded) {
+        sortIntoBands(state, bands);
+    }
+    WorkerPool::Task fill_band = [&](unsigned int band) {
+        unsigned int row_begin = band * tile_rows / bands * tile_size;
+        unsigned int row_end = std::min(
+            height, (band + 1) * tile_rows / bands * tile_size);
+        if (shaded) {
+            putDensities(state, 0, width, row_begin, row_end);
+            return;
+        }
+        std::size_t blob_index = 0;
+        std::size_t cells_begin = 0;
+        for (const auto& id_blob: state.getBlobs()) {
+            std::uint8_t owner = static_cast<std::uint8_t>(id_blob.first + 1);
+            if (walksParticles(id_blob.second)) {
+                std::size_t cells_end
+                    = band_cell_ends[band * state.getBlobs().size()
+                                     + blob_index];
+                for (std::size_t i = cells_begin; i < cells_end; i++) {
+                    putCell(band_cells[band][i], owner);
+                }
+                cells_begin = cells_end;
+            } else {
+                lookUpCells(id_blob.second, owner, 0, width, row_begin,
+                            row_end);
+            }
+            blob_index++;
+        }
+    };
+    if (workers != nullptr && bands > 1) {
+        workers->run(bands, fill_band);
+    } else {
+        for (unsigned int band = 0; band < bands; band++) {
+            fill_band(band);
+        }
+    }
+}
+
+// Collects the visible cells of the particles of the blobs that are walked, by
+// band. The cells of each band are in blob order, and band_cell_ends tells
+// where the cells of each blob end.
+template<class S>
+void RenderSnapshot::sortIntoBands(const S& state, unsigned int bands) {
+    band_cells.resize(std::max<std::size_t>(band_cells.size(), bands));
+    for (std::vector<IntVector>& cells: band_cells) {
+        cells.clear();
+    }
+    tile_row_bands.resize(tile_rows);
+    for (unsigned int band = 0; band < bands; band++) {
+        for (unsigned int row = band * tile_rows / bands;
+             row < (band + 1) * tile_rows / bands; row++) {
+            tile_row_bands[row] = band;
+        }
+    }
+    std::size_t blob_count = state.getBlobs().size();
+    band_cell_ends.assign(bands * blob_count, 0);
+    IntVector begin = viewport.getVisibleBegin();
+    IntVector end = viewport.getVisibleEnd();
+    int cells = static_cast<int>(viewport.getCellsPerSample());
+    std::size_t blob_index = 0;
+    for (const auto& id_blob: state.getBlobs()) {
+        if (walksParticles(id_blob.second)) {
+            for (const auto* particle: id_blob.second.getParticles()) {
+                const IntVector& position = particle->getPosition();
+                if (position.getX() >= begin.getX()
+                    && position.getX() < end.getX()
+                    && position.getY() >= begin.getY()
+                    && position.getY() < end.getY()) {
+                    unsigned int y = static_cast<unsigned int>(
+                        (position.getY() - viewport.getOrigin().getY())
+                        / cells);
+                    band_cells[tile_row_bands[y / tile_size]].push_back(
+                        position);
+                }
+            }
+        }
+        for (unsigned int band = 0; band < bands; band++) {
+            band_cell_ends[band * blob_count + blob_index]
+                = band_cells[band].size();
+        }
+        blob_index++;
+    }
+}
+
+// Returns whether the blob has no more particles than there are visible cells,
+// so that going through its particles is faster than looking up every cell.
+template<class B>
+bool RenderSnapshot::walksParticles(const B& blob) const {
+    IntVector begin = viewport.getVisibleBegin();
+    IntVector end = viewport.getVisibleEnd();
+    if (end.getX() <= begin.getX() || end.getY() <= begin.getY()) {
+        return true;
+    }
+    std::size_t visible_cells
+        = static_cast<std::size_t>(end.getX() - begin.getX())
+          * static_cast<std::size_t>(end.getY() - begin.getY());
+    return blob.getParticles().size() <= visible_cells;
+}
+
+// Shading needs a sample to be exactly a block of one of the pyramid levels.
+template<class S>
+bool RenderSnapshot::canShade(const S& state) const {
+    int level = -viewport.getZoom();
+    if (level < 1 || level > static_cast<int>(DensityPyramid::levels)
+        || state.getBlobs().empty()) {
+        return false;
+    }
+    for (const auto& id_blob: state.getBlobs()) {
+        if (!id_blob.second.getDensity().isEnabled()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Fills the samples in columns [x_begin, x_end) of rows [row_begin, row_end).
+// Finds the owner of each sample
+// from the block counts of each blob, ties going to the lower player id, and
+// shades it by how many of the block's cells the owner's particles fill. This
+// only depends on the number of samples and players, not on the number of
+// particles.
+template<class S>
+void RenderSnapshot::putDensities(const S& state, unsigned int column_begin,
+                                  unsigned int column_end,
+                                  unsigned int row_begin,
+                                  unsigned int row_end) {
+    unsigned int level = static_cast<unsigned int>(-viewport.getZoom());
+    // All pyramids cover the same arena.
+    const DensityPyramid& blocks = state.getBlobs().begin()->second.getDensity();
+    // The origin is a multiple of the block size (see Viewport), so samples
+    // are blocks shifted by a whole number of columns and rows.
+    int cells = static_cast<int>(viewport.getCellsPerSample());
+    int column_offset = viewport.getOrigin().getX() / cells;
+    int row_offset = viewport.getOrigin().getY() / cells;
+    int x_begin = std::max(-column_offset, static_cast<int>(column_begin));
+    int x_end = std::min(static_cast<int>(column_end),
+                         static_cast<int>(blocks.getColumns(level))
+                         - column_offset);
+    int y_begin = std::max(-row_offset, static_cast<int>(row_begin));
+    int y_end = std::min(static_cast<int>(row_end),
+                         static_cast<int>(blocks.getRows(level)) - row_offset);
+    for (const auto& id_blob: state.getBlobs()) {
+        std::uint8_t owner = static_cast<std::uint8_t>(id_blob.first + 1);
+        const DensityPyramid& density = id_blob.second.getDensity();
+        for (int y = y_begin; y < y_end; y++) {
+            std::size_t row = static_cast<std::size_t>(y) * width;
+            for (int x = x_begin; x < x_end; x++) {
+                std::uint32_t count = density.getCount(
+                    level, static_cast<unsigned int>(x + column_offset),
+                    static_cast<unsigned int>(y + row_offset));
+                std::uint32_t& owner_count = owner_counts[row + x];
+                std::uint8_t& sample = samples[row + x];
+                if (count > owner_count
+                    || (count > 0 && count == owner_count && owner < sample)) {
+                    owner_count = count;
+                    sample = owner;
+                }
+            }
+        }
+    }
+    for (int y = y_begin; y < y_end; y++) {
+        std::size_t row = static_cast<std::size_t>(y) * width;
+        for (int x = x_begin; x < x_end; x++) {
+            std::uint32_t count = owner_counts[row + x];
+            if (count > 0) {
+                unsigned int area = blocks.getArea(
+                    level, static_cast<unsigned int>(x + column_offset),
+                    static_cast<unsigned int>(y + row_offset));
+                shades[row + x] = toShade(count, area);
+            }
+        }
+    }
+}
+
+// Fills the blob's particles into the samples in columns
+// [column_begin, column_end) of rows [row_begin, row_end). They are found
+// either by looking up each cell of those samples or by going through all
+// particles, whichever means fewer steps. Zoomed in on a large battle the
+// first is much faster, zoomed out the second.
+template<class B>
+void RenderSnapshot::putBlob(const B& blob, std::uint8_t owner,
+                             unsigned int column_begin,
+                             unsigned int column_end, unsigned int row_begin,
+                             unsigned int row_end) {
+    IntVector begin;
+    IntVector end;
+    if (!getCells(column_begin, column_end, row_begin, row_end, begin, end)) {
+        return;
+    }
+    std::size_t cell_count
+        = static_cast<std::size_t>(end.getX() - begin.getX())
+          * static_cast<std::size_t>(end.getY() - begin.getY());
+    if (cell_count < blob.getParticles().size()) {
+        lookUpCells(blob, owner, column_begin, column_end, row_begin,
+                    row_end);
+        return;
+    }
+    for (const auto* particle: blob.getParticles()) {
+        const IntVector& position = particle->getPosition();
+        if (position.getX() >= begin.getX() && position.getX() < end.getX()
+            && position.getY() >= begin.getY()
+            && position.getY() < end.getY()) {
+            putCell(position, owner);
+        }
+    }
+}
+
+// Fills the blob's particles into the samples in columns
+// [column_begin, column_end) of rows [row_begin, row_end) by looking up each
+// of their cells.
+template<class B>
+void RenderSnapshot::lookUpCells(const B& blob, std::uint8_t owner,
+                                 unsigned int column_begin,
+                                 unsigned int column_end,
+                                 unsigned int row_begin,
+                                 unsigned int row_end) {
+    IntVector begin;
+    IntVector end;
+    if (!getCells(column_begin, column_end, row_begin, row_end, begin, end)) {
+        return;
+    }
+    for (int y = begin.getY(); y < end.getY(); y++) {
+        for (int x = begin.getX(); x < end.getX(); x++) {
+            IntVector cell(x, y);
+            if (blob.getParticleAt(cell) != nullptr) {
+                putCell(cell, owner);
+            }
+        }
+    }
+}
+
+}
@@ -3,27 +3,32 @@
 namespace wotmin2d {
 
 const SdlTexture::Color Screen::BLACK = { 0x00, 0x00, 0x00 };
-const SdlTexture::Color Screen::WHITE = { 0xff, 0xff, 0xff };
-const SdlTexture::Color Screen::BLUE = { 0x00, 0x00, 0xff };
-const SdlTexture::Color Screen::RED = { 0xff, 0x00, 0x00 };
+const SdlTexture::Color Screen::PRESSURE_COLOR = { 0xff, 0xff, 0xff };
+const SdlTexture::Color Screen::STRENGTH_COLOR = { 0xff, 0x40, 0x00 };
+const SdlTexture::Color Screen::LEADERSHIP_COLOR = { 0xff, 0xe0, 0x00 };
+const SdlTexture::Color Screen::HUD_COLOR = { 0xff, 0xff, 0xff };
+const SdlTexture::Color Screen::OVERRUN_COLOR = { 0xff, 0x40, 0x40 };
+const int Screen::HUD_SCALE = 2;
 
-void Screen::construct(unsigned int arena_width,
-                       unsigned int arena_height,
-                       unsigned int display_width,
+void Screen::construct(unsigned int display_width,
                        unsigned int display_height) {
     window = SDL_CreateWindow("WoTMin2D", SDL_WINDOWPOS_CENTERED,
                               SDL_WINDOWPOS_CENTERED, display_width,
-                              display_height, 0);
+                              display_height,
+                              headless ? SDL_WINDOW_HIDDEN : 0);
     if (window == nullptr) {
         throw SdlException("Error creating a window.", SDL_GetError());
     }
-    renderer = SDL_CreateRenderer(window, -1, 0);
+    renderer = SDL_CreateRenderer(window, -1,
+                                  headless ? SDL_RENDERER_SOFTWARE : 0);
     if (renderer == nullptr) {
         SDL_DestroyWindow(window);
         throw SdlException("Error creating a renderer.", SDL_GetError());
     }
     try {
-        texture.reset(new SdlTexture(renderer, arena_width, arena_height));
+        texture.reset(new SdlTexture(renderer, display_width,
+                                     display_height));
+        mapPalette();
     } catch (...) {
         SDL_DestroyRenderer(renderer);
         SDL_DestroyWindow(window);
@@ -32,23 +37,47 @@ void Screen::construct(unsigned int arena_width,
 }
 
 Screen::Screen(unsigned int arena_width, unsigned int arena_height,
-               unsigned int display_width, unsigned int display_height) :
+               unsigned int display_width, unsigned int display_height,
+               bool headless) :
+    viewport(arena_width, arena_height, display_width, display_height),
+    headless(headless),
     window(nullptr),
     renderer(nullptr),
-    texture(nullptr)
+    texture(nullptr),
+    palette(),
+    pixel_values(),
+    shaded_values(),
+    dirty_tiles(),
+    blended_tiles(),
+    drawn_sequence(0),
+    drawn_mouse_position(0, 0),
+    drawn_selection(0.0f),
+    frame_writer(nullptr),
+    frame_ring(nullptr)
 {
-    construct(arena_width, arena_height, display_width, display_height);
+    construct(display_width, display_height);
 }
 
 Screen::Screen(const Screen& other) :
+    viewport(other.viewport),
+    headless(other.headless),
     window(nullptr),
     renderer(nullptr),
-    texture(nullptr)
+    texture(nullptr),
+    palette(),
+    pixel_values(),
+    shaded_values(),
+    dirty_tiles(),
+    blended_tiles(),
+    drawn_sequence(0),
+    drawn_mouse_position(0, 0),
+    drawn_selection(0.0f),
+    frame_writer(nullptr),
+    frame_ring(nullptr)
 {
     int display_width, display_height;
     SDL_GetWindowSize(other.window, &display_width, &display_height);
-    construct(other.texture->getWidth(), other.texture->getHeight(),
-              display_width, display_height);
+    construct(display_width, display_height);
 }
 
 Screen& Screen::operator=(Screen other) {
@@ -67,143 +96,566 @@ Screen::~Screen() {
 
 void swap(Screen& first, Screen& second) noexcept {
     using std::swap;
+    swap(first.viewport, second.viewport);
+    swap(first.headless, second.headless);
     swap(first.window, second.window);
     swap(first.renderer, second.renderer);
     swap(first.texture, second.texture);
+    swap(first.pixel_values, second.pixel_values);
+    swap(first.shaded_values, second.shaded_values);
+    swap(first.dirty_tiles, second.dirty_tiles);
+    swap(first.blended_tiles, second.blended_tiles);
+    swap(first.drawn_sequence, second.drawn_sequence);
+    swap(first.drawn_mouse_position, second.drawn_mouse_position);
+    swap(first.drawn_selection, second.drawn_selection);
+    swap(first.frame_writer, second.frame_writer);
+    swap(first.frame_ring, second.frame_ring);
 }
 
-void Screen::draw(const State<>& state) {
-    updateTexture(state);
-    presentTexture();
+// Draws the snapshot. With an interpolation below 1, cells whose owner changed
+// since the previous snapshot are blended between their colors before and
+// after, so that movement looks smooth when rendering more often than ticking.
+// Shaded snapshots are shown far enough zoomed out that movement is less than
+// a pixel, so they aren't blended. Only the tiles that look different from the
+// last frame are updated. The layers of the debug snapshot, if there is one,
+// are drawn on top, and the performance overlay over everything.
+void Screen::draw(const RenderSnapshot& snapshot, float interpolation,
+                  const DebugSnapshot* debug,
+                  const PerformanceSnapshot* performance) {
+    updateTexture(snapshot, interpolation);
+    presentTexture(snapshot, debug, performance);
 }
 
-IntVector Screen::scaleWindowToArenaCoordinates(const IntVector& coordinate)
-    const
-{
-    int window_width_int, window_height_int;
-    SDL_GetWindowSize(window, &window_width_int, &window_height_int);
-    assert(coordinate.getX() >= 0);
-    assert(coordinate.getY() >= 0);
-    int x_in = coordinate.getX();
-    int y_in = coordinate.getY();
-    if (x_in >= window_width_int) {
-        // This can happen even with valid inputs on window resizing. Set to
-        // window border.
-        x_in = window_width_int - 1;
-    }
-    if (y_in >= window_height_int) {
-        y_in = window_height_int - 1;
-    }
-    float window_width = static_cast<float>(window_width_int);
-    float window_height = static_cast<float>(window_height_int);
-    float arena_width = static_cast<float>(texture->getWidth());
-    float arena_height = static_cast<float>(texture->getHeight());
-    float width_multiplier = arena_width / window_width;
-    float height_multiplier = arena_height / window_height;
-    float window_x = static_cast<float>(x_in);
-    int arena_x = static_cast<int>(window_x * width_multiplier);
-    float window_y = static_cast<float>(y_in);
-    int arena_y = static_cast<int>(window_y * height_multiplier);
-    return IntVector(arena_x, arena_y);
-}
-
-unsigned int Screen::invertArenaY(unsigned int y) const {
-    return texture->getHeight() - y - 1;
+const Viewport& Screen::getViewport() const {
+    return viewport;
+}
+
+void Screen::setViewport(const Viewport& viewport) {
+    this->viewport = viewport;
 }
 
+// Takes window coordinates and returns the cell of the arena shown there in
+// the current viewport.
 IntVector Screen::sdlToArenaCoordinates(const IntVector& coordinate) const {
-    IntVector arena_coordinate = scaleWindowToArenaCoordinates(coordinate);
-    assert(arena_coordinate.getY() >= 0);
-    unsigned int y_inv = invertArenaY(arena_coordinate.getY());
-    return IntVector(arena_coordinate.getX(), y_inv);
+    return viewport.windowToArena(coordinate);
+}
+
+// Writes every frame drawn from now on, as it's shown in the window. Copies of
+// the screen don't export.
+void Screen::exportFrames(std::unique_ptr<FrameWriter> writer) {
+    frame_writer = std::move(writer);
+}
+
+// Publishes every frame drawn from now on to the ring, as it's shown in the
+// window. Frames larger than the ring's maximum size are skipped. Copies of
+// the screen don't publish.
+void Screen::publishFrames(std::unique_ptr<FrameRingWriter> ring) {
+    frame_ring = std::move(ring);
 }
 
-void Screen::updateTexture(const State<>& state) {
+// Waits until the exported frames are written, see FrameWriter::flush().
+void Screen::flushFrames() {
+    if (frame_writer != nullptr) {
+        frame_writer->flush();
+    }
+}
+
+std::size_t Screen::getMemoryUsage() const {
+    return texture->getMemoryUsage();
+}
+
+void Screen::updateTexture(const RenderSnapshot& snapshot,
+                           float interpolation) {
     assert(!texture->isLocked() && "Attempt to update a texture that was "
            "already locked for writing.");
-    texture->lockForWriting();
-    // Make everything white to begin with.
-    texture->setPixelRange(0, texture->getWidth() * texture->getHeight(),
-                           WHITE);
-    putBlobs(state);
+    assert(snapshot.getWidth() <= texture->getWidth());
+    assert(snapshot.getHeight() <= texture->getHeight());
     // TODO Getting the mouse state here means it may be a bit old (since
     // rendering the blobs takes time).
-    putSelectionCircleAndAimPoint(state);
+    int mouse_x, mouse_y;
+    SDL_GetMouseState(&mouse_x, &mouse_y);
+    const Viewport& snapshot_viewport = snapshot.getViewport();
+    IntVector mouse_sample
+        = snapshot_viewport.windowToSample(IntVector(mouse_x, mouse_y));
+    IntVector mouse_position(mouse_sample.getX(),
+                             invertY(mouse_sample.getY(),
+                                     snapshot.getHeight()));
+    // The radius is in cells, the circle is drawn in samples.
+    float radius = snapshot.getSelectionRadius()
+                   / snapshot_viewport.getCellsPerSample();
+    assert(radius >= 0.0f);
+    markDirtyTiles(snapshot);
+    if (mouse_position != drawn_mouse_position
+        || radius != drawn_selection.getRadius()) {
+        markTiles(drawn_mouse_position, drawn_selection.getRadius(),
+                  snapshot.getWidth(), snapshot.getHeight());
+        markTiles(mouse_position, radius, snapshot.getWidth(),
+                  snapshot.getHeight());
+    }
+    drawn_mouse_position = mouse_position;
+    drawn_selection.update(radius);
+    // Lock each run of dirty tiles in a row as one region.
+    unsigned int columns = snapshot.getTileColumns();
+    for (unsigned int row = 0; row < snapshot.getTileRows(); row++) {
+        unsigned int column = 0;
+        while (column < columns) {
+            if (!dirty_tiles[row * columns + column]) {
+                column++;
+                continue;
+            }
+            unsigned int end_column = column + 1;
+            while (end_column < columns
+                   && dirty_tiles[row * columns + end_column]) {
+                end_column++;
+            }
+            drawTiles(snapshot, interpolation, column, end_column, row);
+            column = end_column;
+        }
+    }
+    bool blending = interpolation < 1.0f && !snapshot.isShaded();
+    for (unsigned int row = 0; row < snapshot.getTileRows(); row++) {
+        for (unsigned int column = 0; column < columns; column++) {
+            blended_tiles[row * columns + column]
+                = blending && snapshot.isTileDirty(column, row);
+        }
+    }
+    drawn_sequence = snapshot.getSequence();
+}
+
+// Marks the tiles that need drawing because of the snapshot: tiles that still
+// show a blend (which either progresses or settles), and tiles that changed if
+// the snapshot directly follows the last one drawn. If snapshots were missed,
+// everything is drawn.
+void Screen::markDirtyTiles(const RenderSnapshot& snapshot) {
+    std::size_t tile_count = static_cast<std::size_t>(snapshot.getTileColumns())
+                             * snapshot.getTileRows();
+    if (drawn_sequence == 0 || blended_tiles.size() != tile_count
+        || snapshot.getSequence() > drawn_sequence + 1
+        || snapshot.getSequence() < drawn_sequence) {
+        dirty_tiles.assign(tile_count, true);
+        blended_tiles.assign(tile_count, false);
+        return;
+    }
+    dirty_tiles.assign(blended_tiles.begin(), blended_tiles.end());
+    if (snapshot.getSequence() == drawn_sequence) {
+        return;
+    }
+    for (unsigned int row = 0; row < snapshot.getTileRows(); row++) {
+        for (unsigned int column = 0; column < snapshot.getTileColumns();
+             column++) {
+            if (snapshot.isTileDirty(column, row)) {
+                dirty_tiles[row * snapshot.getTileColumns() + column] = true;
+            }
+        }
+    }
+}
+
+// Marks the tiles covered by a selection circle, given in texture coordinates,
+// in a snapshot of the given size.
+void Screen::markTiles(const IntVector& center, float radius,
+                       unsigned int snapshot_width,
+                       unsigned int snapshot_height) {
+    int radius_int = static_cast<int>(radius);
+    int width = static_cast<int>(snapshot_width);
+    int height = static_cast<int>(snapshot_height);
+    int x_begin = std::max(center.getX() - radius_int, 0);
+    int x_end = std::min(center.getX() + radius_int + 1, width);
+    // Tiles count rows from the bottom, the texture from the top.
+    int y_begin = std::max(height - 1 - (center.getY() + radius_int), 0);
+    int y_end = std::min(height - (center.getY() - radius_int), height);
+    if (x_begin >= x_end || y_begin >= y_end) {
+        return;
+    }
+    int tile_size = static_cast<int>(RenderSnapshot::tile_size);
+    int columns = (width + tile_size - 1) / tile_size;
+    for (int row = y_begin / tile_size; row <= (y_end - 1) / tile_size;
+         row++) {
+        for (int column = x_begin / tile_size;
+             column <= (x_end - 1) / tile_size; column++) {
+            dirty_tiles[row * columns + column] = true;
+        }
+    }
+}
+
+// Draws the tiles [first_column, end_column) of a tile row, which are locked
+// together.
+void Screen::drawTiles(const RenderSnapshot& snapshot, float interpolation,
+                       unsigned int first_column, unsigned int end_column,
+                       unsigned int row) {
+    unsigned int tile_size = RenderSnapshot::tile_size;
+    unsigned int x_begin = first_column * tile_size;
+    unsigned int x_end = std::min(end_column * tile_size,
+                                  snapshot.getWidth());
+    unsigned int y_begin = row * tile_size;
+    unsigned int y_end = std::min(y_begin + tile_size, snapshot.getHeight());
+    texture->lockForWriting(x_begin, invertY(y_end - 1, snapshot.getHeight()),
+                            x_end - x_begin, y_end - y_begin);
+    putCells(snapshot, interpolation, x_begin, x_end, y_begin, y_end);
+    putSelectionCircleAndAimPoint(drawn_mouse_position);
     texture->unlock();
 }
 
-void Screen::putBlobs(const State<>& state) {
+// Rows of samples are converted straight from the snapshot, the few cells that
+// are blended are drawn over them.
+void Screen::putCells(const RenderSnapshot& snapshot, float interpolation,
+                      unsigned int x_begin, unsigned int x_end,
+                      unsigned int y_begin, unsigned int y_end) {
     assert(texture->isLocked() && "Attempt to set pixels on a texture that "
            "isn't locked for writing.");
-    for (const auto& id_blob: state.getBlobs()) {
-        const Blob<>& blob = id_blob.second;
-        const SdlTexture::Color& color = id_blob.first == 0 ? BLUE : RED;
-        for (const Particle* particle: blob.getParticles()) {
-            int x_signed = particle->getPosition().getX();
-            int y_signed = particle->getPosition().getY();
-            assert(x_signed >= 0 && "X coordinate must be positive");
-            assert(y_signed >= 0 && "Y coordinate must be positive");
-            unsigned int x = static_cast<unsigned int>(x_signed);
-            unsigned int y = static_cast<unsigned int>(y_signed);
-            assert(x < state.getWidth() && "X coordinate must be less than "
-                                           "arena width.");
-            assert(y < state.getHeight() && "Y coordinate must be less than "
-                                            "arena height.");
-            // The y-coordinates of particle start at the bottom, increasing
-            // towards the top, texture coordinates are the other way around.
-            unsigned int y_arena = invertArenaY(y);
-            texture->setPixel(x, y_arena, color);
+    const std::vector<std::uint8_t>& cells = snapshot.getSamples();
+    const std::vector<std::uint8_t>& previous_cells
+        = snapshot.getPreviousSamples();
+    bool shaded = snapshot.isShaded();
+    bool blending = interpolation < 1.0f && !shaded;
+    unsigned int width = snapshot.getWidth();
+    for (unsigned int y = y_begin; y < y_end; y++) {
+        unsigned int y_texture = invertY(y, snapshot.getHeight());
+        std::size_t row = static_cast<std::size_t>(y) * width;
+        if (shaded) {
+            texture->setPixels(x_begin, y_texture,
+                               cells.data() + row + x_begin,
+                               snapshot.getShades().data() + row + x_begin,
+                               x_end - x_begin, shaded_values.data());
+        } else {
+            texture->setPixels(x_begin, y_texture,
+                               cells.data() + row + x_begin, x_end - x_begin,
+                               pixel_values.data());
+        }
+        if (!blending) {
+            continue;
+        }
+        for (unsigned int x = x_begin; x < x_end; x++) {
+            std::uint8_t cell = cells[row + x];
+            std::uint8_t previous_cell = previous_cells[row + x];
+            if (cell != previous_cell) {
+                texture->setPixel(x, y_texture,
+                                  Palette::blend(
+                                      palette.getColor(previous_cell),
+                                      palette.getColor(cell), interpolation));
+            }
         }
     }
 }
 
-void Screen::putSelectionCircleAndAimPoint(const State<>& state) {
+// The y-coordinates of samples start at the bottom, increasing towards the
+// top, texture coordinates are the other way around.
+unsigned int Screen::invertY(unsigned int y, unsigned int height) {
+    return height - y - 1;
+}
+
+// Needs to be done whenever a texture is created, since its pixel format
+// depends on the renderer. A shade s shows a player's color at (s + 1) /
+// shade_levels of its strength over the background.
+void Screen::mapPalette() {
+    for (std::size_t i = 0; i < Palette::size; i++) {
+        pixel_values[i] = texture->mapColor(
+            palette.getColor(static_cast<std::uint8_t>(i)));
+    }
+    unsigned int shade_levels = RenderSnapshot::shade_levels;
+    shaded_values.resize(shade_levels * Palette::size);
+    for (unsigned int shade = 0; shade < shade_levels; shade++) {
+        float strength = static_cast<float>(shade + 1) / shade_levels;
+        for (std::size_t i = 0; i < Palette::size; i++) {
+            shaded_values[shade * Palette::size + i] = texture->mapColor(
+                Palette::blend(Palette::background,
+                               palette.getColor(static_cast<std::uint8_t>(i)),
+                               strength));
+        }
+    }
+}
+
+// Takes the mouse position in texture coordinates. The outline comes from the
+// mask, which is only rebuilt when the radius changes.
+void Screen::putSelectionCircleAndAimPoint(const IntVector& mouse_position) {
     assert(texture->isLocked() && "Attempt to set pixels on a texture that "
            "isn't locked for writing.");
-    // TODO A bit ugly that I'm getting the mouse state here.
-    int mouse_x, mouse_y;
-    SDL_GetMouseState(&mouse_x, &mouse_y);
-    IntVector mouse_position
-        = scaleWindowToArenaCoordinates(IntVector(mouse_x, mouse_y));
-    float radius = state.getSelectionRadius();
-    assert(radius >= 0.0f);
-    int radius_int = static_cast<int>(radius);
-    int squared_radius = static_cast<int>(radius * radius);
-    int x = 0;
-    int y = radius_int;
-    assert(IntVector(x, y).squaredNorm() <= squared_radius);
-    while (y >= 0) {
-        assert(IntVector(x, y).squaredNorm() <= squared_radius);
-        texture->setPixel(mouse_position.getX() + x, mouse_position.getY() + y,
-                          BLACK);
-        texture->setPixel(mouse_position.getX() + x, mouse_position.getY() - y,
-                          BLACK);
-        texture->setPixel(mouse_position.getX() - x, mouse_position.getY() + y,
-                          BLACK);
-        texture->setPixel(mouse_position.getX() - x, mouse_position.getY() - y,
-                          BLACK);
-        if (IntVector(x + 1, y).squaredNorm() <= squared_radius) {
-            x++;
-        } else {
-            y--;
-        }
+    for (const IntVector& offset: drawn_selection.getOutline()) {
+        texture->setPixel(mouse_position.getX() + offset.getX(),
+                          mouse_position.getY() + offset.getY(), BLACK);
     }
     // Aim point
     texture->setPixel(mouse_position.getX(), mouse_position.getY(), BLACK);
 }
 
-void Screen::presentTexture() {
+// Stretches the part of the texture the snapshot was drawn to over the window,
+// aligned to the bottom left like the samples. Samples at the top and right
+// may be cut off.
+void Screen::presentTexture(const RenderSnapshot& snapshot,
+                            const DebugSnapshot* debug,
+                            const PerformanceSnapshot* performance) {
     assert(!texture->isLocked() && "Attempt to present a texture that's "
            "currently locked for writing.");
+    // Debug layers and the overlay change the draw color.
+    setDrawColor(BLACK, 0xff);
     if (SDL_RenderClear(renderer) != 0) {
         throw SdlException("Error clearing the renderer.", SDL_GetError());
     }
-    if (SDL_RenderCopy(renderer, texture->getTexture(), nullptr,
-                       nullptr) != 0) {
+    int width = static_cast<int>(snapshot.getWidth());
+    int height = static_cast<int>(snapshot.getHeight());
+    int pixels
+        = static_cast<int>(snapshot.getViewport().getPixelsPerSample());
+    int view_height
+        = static_cast<int>(snapshot.getViewport().getViewHeight());
+    SDL_Rect source = { 0, 0, width, height };
+    SDL_Rect destination = { 0, view_height - height * pixels, width * pixels,
+                             height * pixels };
+    if (SDL_RenderCopy(renderer, texture->getTexture(), &source,
+                       &destination) != 0) {
         throw SdlException("Error copying a texture to the renderer.",
                            SDL_GetError());
     }
+    if (debug != nullptr) {
+        drawDebugLayers(*debug);
+    }
+    if (performance != nullptr) {
+        drawHud(*performance);
+    }
+    if (frame_writer != nullptr || frame_ring != nullptr) {
+        exportFrame();
+    }
     SDL_RenderPresent(renderer);
 }
 
+// Strength is shown as blocks tinted more the stronger they are, pressure as
+// lines from the middle of the blocks that reach their border at the largest
+// pressure, and leadership as lines from followers to leaders.
+void Screen::drawDebugLayers(const DebugSnapshot& debug) {
+    unsigned int layers = debug.getLayers();
+    if (layers == 0) {
+        return;
+    }
+    if (SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND) != 0) {
+        throw SdlException("Error setting the blend mode.", SDL_GetError());
+    }
+    const Viewport& debug_viewport = debug.getViewport();
+    float block_cells = static_cast<float>(debug.getBlockCells());
+    float origin_x = static_cast<float>(debug_viewport.getOrigin().getX());
+    float origin_y = static_cast<float>(debug_viewport.getOrigin().getY());
+    for (unsigned int row = 0; row < debug.getRows(); row++) {
+        float bottom = origin_y + static_cast<float>(row) * block_cells;
+        for (unsigned int column = 0; column < debug.getColumns(); column++) {
+            const DebugSnapshot::Block& block = debug.getBlock(column, row);
+            if (block.particles == 0) {
+                continue;
+            }
+            float left = origin_x + static_cast<float>(column) * block_cells;
+            if (layers & DebugSnapshot::strength_layer) {
+                FloatVector top_left = debug_viewport.arenaToWindow(
+                    FloatVector(left, bottom + block_cells));
+                FloatVector bottom_right = debug_viewport.arenaToWindow(
+                    FloatVector(left + block_cells, bottom));
+                int x = static_cast<int>(top_left.getX());
+                int y = static_cast<int>(top_left.getY());
+                SDL_Rect rect = { x, y,
+                                  static_cast<int>(bottom_right.getX()) - x,
+                                  static_cast<int>(bottom_right.getY()) - y };
+                int strength = std::min(block.strength,
+                                        debug.getMaxStrength());
+                setDrawColor(STRENGTH_COLOR, static_cast<std::uint8_t>(
+                    0xc0 * strength / debug.getMaxStrength()));
+                if (SDL_RenderFillRect(renderer, &rect) != 0) {
+                    throw SdlException("Error drawing a rectangle.",
+                                       SDL_GetError());
+                }
+            }
+            if (layers & DebugSnapshot::pressure_layer) {
+                FloatVector center(left + block_cells / 2.0f,
+                                   bottom + block_cells / 2.0f);
+                FloatVector from = debug_viewport.arenaToWindow(center);
+                FloatVector to = debug_viewport.arenaToWindow(
+                    center + block.pressure
+                             * (block_cells / 2.0f / debug.getMaxPressure()));
+                setDrawColor(PRESSURE_COLOR, 0xff);
+                drawLine(from, to);
+            }
+        }
+    }
+    if (layers & DebugSnapshot::leadership_layer) {
+        setDrawColor(LEADERSHIP_COLOR, 0xff);
+        FloatVector half_cell(0.5f, 0.5f);
+        for (const DebugSnapshot::Link& link: debug.getLinks()) {
+            drawLine(debug_viewport.arenaToWindow(
+                         static_cast<FloatVector>(link.follower) + half_cell),
+                     debug_viewport.arenaToWindow(
+                         static_cast<FloatVector>(link.leader) + half_cell));
+        }
+    }
+}
+
+// Shows the performance snapshot as lines of text over a dark box in the top
+// left corner: the last tick's time against the tick duration (in red if it
+// took too long) and by phase, how long capturing and drawing take, what
+// happened in the tick, how often the simulation and drawing fell behind, and
+// the particles of each player in their color. The lines are formatted into
+// buffers on the stack, so this doesn't allocate.
+void Screen::drawHud(const PerformanceSnapshot& performance) {
+    constexpr std::size_t line_length = 64;
+    char lines[5 + PerformanceSnapshot::max_players][line_length];
+    const TickProfile& profile = performance.profile;
+    PerformanceSnapshot::Clock::duration tick_time
+        = profile.getTotal() + performance.output;
+    std::snprintf(lines[0], line_length, "TICK %llu: %.2f OF %.0f MS",
+                  static_cast<unsigned long long>(performance.tick),
+                  toMilliseconds(tick_time),
+                  toMilliseconds(performance.tick_duration));
+    std::snprintf(lines[1], line_length,
+                  "PRESSURE %.2f MOVEMENT %.2f COLLISIONS %.2f",
+                  toMilliseconds(profile.pressure),
+                  toMilliseconds(profile.movement),
+                  toMilliseconds(profile.collisions));
+    std::snprintf(lines[2], line_length, "OUTPUT %.2f CAPTURE %.2f DRAW %.2f",
+                  toMilliseconds(performance.output),
+                  toMilliseconds(performance.capture),
+                  toMilliseconds(performance.draw_time));
+    std::snprintf(lines[3], line_length, "MOVES %llu HOSTILE COLLISIONS %llu",
+                  static_cast<unsigned long long>(profile.moves),
+                  static_cast<unsigned long long>(profile.hostile_collisions));
+    std::snprintf(lines[4], line_length,
+                  "OVERRUNS: TICKS %llu DROPPED %llu FRAMES %llu",
+                  static_cast<unsigned long long>(performance.tick_overruns),
+                  static_cast<unsigned long long>(performance.dropped_ticks),
+                  static_cast<unsigned long long>(
+                      performance.skipped_renders));
+    std::size_t line_count = 5;
+    for (std::size_t i = 0; i < performance.player_count; i++) {
+        std::snprintf(lines[line_count++], line_length,
+                      "PLAYER %u: %llu PARTICLES",
+                      static_cast<unsigned int>(performance.players[i]),
+                      static_cast<unsigned long long>(
+                          performance.particles[i]));
+    }
+    unsigned int width = 0;
+    for (std::size_t i = 0; i < line_count; i++) {
+        width = std::max(width, BitmapFont::getWidth(lines[i]));
+    }
+    int margin = 2 * HUD_SCALE;
+    int line_height = static_cast<int>(BitmapFont::glyph_height + 2)
+                      * HUD_SCALE;
+    SDL_Rect box = { 0, 0,
+                     static_cast<int>(width) * HUD_SCALE + 2 * margin,
+                     static_cast<int>(line_count) * line_height + margin };
+    if (SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND) != 0) {
+        throw SdlException("Error setting the blend mode.", SDL_GetError());
+    }
+    setDrawColor(BLACK, 0xa0);
+    fillRects(&box, 1);
+    for (std::size_t i = 0; i < line_count; i++) {
+        if (i == 0 && tick_time > performance.tick_duration) {
+            setDrawColor(OVERRUN_COLOR, 0xff);
+        } else if (i < 5) {
+            setDrawColor(HUD_COLOR, 0xff);
+        } else {
+            setDrawColor(palette.getColor(static_cast<std::uint8_t>(
+                             performance.players[i - 5] + 1)), 0xff);
+        }
+        drawText(lines[i], margin,
+                 margin + static_cast<int>(i) * line_height);
+    }
+}
+
+// Draws the text in the current draw color with its top left corner at the
+// window coordinates. The pixels of the glyphs are collected into a fixed
+// batch of rectangles that is drawn whenever it fills up.
+void Screen::drawText(const char* text, int x, int y) {
+    std::array<SDL_Rect, 256> rects;
+    std::size_t count = 0;
+    for (; *text != '\0'; text++) {
+        const BitmapFont::Glyph& glyph = BitmapFont::getGlyph(*text);
+        for (unsigned int row = 0; row < BitmapFont::glyph_height; row++) {
+            for (unsigned int column = 0; column < BitmapFont::glyph_width;
+                 column++) {
+                if (!BitmapFont::isSet(glyph, column, row)) {
+                    continue;
+                }
+                if (count == rects.size()) {
+                    fillRects(rects.data(), count);
+                    count = 0;
+                }
+                rects[count++] = {
+                    x + static_cast<int>(column) * HUD_SCALE,
+                    y + static_cast<int>(row) * HUD_SCALE,
+                    HUD_SCALE, HUD_SCALE };
+            }
+        }
+        x += static_cast<int>(BitmapFont::advance) * HUD_SCALE;
+    }
+    fillRects(rects.data(), count);
+}
+
+void Screen::fillRects(const SDL_Rect* rects, std::size_t count) {
+    if (count > 0 && SDL_RenderFillRects(renderer, rects,
+                                         static_cast<int>(count)) != 0) {
+        throw SdlException("Error drawing rectangles.", SDL_GetError());
+    }
+}
+
+double Screen::toMilliseconds(PerformanceSnapshot::Clock::duration time) {
+    return std::chrono::duration<double, std::milli>(time).count();
+}
+
+void Screen::setDrawColor(const SdlTexture::Color& color,
+                          std::uint8_t alpha) {
+    if (SDL_SetRenderDrawColor(renderer, color[0], color[1], color[2], alpha)
+        != 0) {
+        throw SdlException("Error setting the draw color.", SDL_GetError());
+    }
+}
+
+// Takes window coordinates.
+void Screen::drawLine(const FloatVector& from, const FloatVector& to) {
+    if (SDL_RenderDrawLine(renderer, static_cast<int>(from.getX()),
+                           static_cast<int>(from.getY()),
+                           static_cast<int>(to.getX()),
+                           static_cast<int>(to.getY())) != 0) {
+        throw SdlException("Error drawing a line.", SDL_GetError());
+    }
+}
+
+// Reads back what the renderer is about to present. This has to happen before
+// presenting, since the contents are undefined afterwards. Pixels for the ring
+// are read straight into its shared memory, and copied from there for the
+// frame writer. If writing frames fails, the error is reported and no more
+// frames are exported, the window keeps showing them.
+void Screen::exportFrame() {
+    int width, height;
+    if (SDL_GetRendererOutputSize(renderer, &width, &height) != 0) {
+        throw SdlException("Error getting the renderer output size.",
+                           SDL_GetError());
+    }
+    std::size_t size = static_cast<std::size_t>(width) * height * 3;
+    std::uint8_t* published = nullptr;
+    if (frame_ring != nullptr) {
+        published = frame_ring->beginFrame(width, height);
+        if (published != nullptr) {
+            readPixels(published, width);
+            frame_ring->endFrame();
+        }
+    }
+    if (frame_writer == nullptr) {
+        return;
+    }
+    std::vector<std::uint8_t> pixels = frame_writer->takeBuffer();
+    if (published != nullptr) {
+        pixels.assign(published, published + size);
+    } else {
+        pixels.resize(size);
+        readPixels(pixels.data(), width);
+    }
+    try {
+        frame_writer->writeFrame(std::move(pixels), width, height);
+    } catch (const IoException& e) {
+        std::cerr << e.what() << " Frame export stopped." << std::endl;
+        frame_writer.reset();
+    }
+}
+
+// Reads what the renderer is about to present as 8-bit RGB.
+void Screen::readPixels(std::uint8_t* pixels, int width) {
+    if (SDL_RenderReadPixels(renderer, nullptr, SDL_PIXELFORMAT_RGB24,
+                             pixels, width * 3) != 0) {
+        throw SdlException("Error reading pixels from the renderer.",
+                           SDL_GetError());
+    }
+}
+
 }
@@ -1,45 +1,127 @@
 #ifndef SCREEN_HPP
 #define SCREEN_HPP
 
-#include "../game/State.hpp"
-#include "../game/Blob.hpp"
-#include "../game/Particle.hpp"
+#include "../game/Vector.hpp"
+#include "../game/CircleMask.hpp"
+#include "RenderSnapshot.hpp"
+#include "DebugSnapshot.hpp"
+#include "PerformanceSnapshot.hpp"
+#include "BitmapFont.hpp"
+#include "Viewport.hpp"
+#include "Palette.hpp"
 #include "SdlTexture.hpp"
 #include "SdlException.hpp"
+#include "../io/FrameWriter.hpp"
+#include "../io/FrameRing.hpp"
+#include "../io/IoException.hpp"
 
 #include <SDL.h>
 #include <utility>
 #include <cstdint>
 #include <cassert>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
 
 namespace wotmin2d {
 
+/**
+ * The window. It shows render snapshots through the viewport they were
+ * captured with: the texture is the size of the window, a sample of the
+ * snapshot is a pixel of the texture, and the part of the texture that is used
+ * is stretched to make samples the size the viewport's zoom asks for.
+ *
+ * A headless screen uses a hidden window and SDL's software renderer, so that
+ * it works with the dummy video driver on machines without a display. Either
+ * kind can export every frame it shows to files (see FrameWriter) and publish
+ * it to other processes through shared memory (see FrameRingWriter).
+ *
+ * Debug layers (see DebugSnapshot) and the performance overlay are drawn over
+ * the texture at the window's resolution, so they show up in exported frames
+ * but don't touch the tiles.
+ */
 class Screen {
     public:
     Screen(unsigned int arena_width, unsigned int arena_height,
-           unsigned int display_width, unsigned int display_height);
+           unsigned int display_width, unsigned int display_height,
+           bool headless = false);
     Screen(const Screen& other);
     Screen& operator=(Screen other);
     ~Screen();
     friend void swap(Screen& first, Screen& second) noexcept;
-    void draw(const State<>& state);
-    IntVector scaleWindowToArenaCoordinates(const IntVector& coordinate) const;
-    unsigned int invertArenaY(unsigned int y) const;
+    void draw(const RenderSnapshot& snapshot, float interpolation = 1.0f,
+              const DebugSnapshot* debug = nullptr,
+              const PerformanceSnapshot* performance = nullptr);
+    const Viewport& getViewport() const;
+    void setViewport(const Viewport& viewport);
     IntVector sdlToArenaCoordinates(const IntVector& coordinate) const;
+    void exportFrames(std::unique_ptr<FrameWriter> writer);
+    void publishFrames(std::unique_ptr<FrameRingWriter> ring);
+    void flushFrames();
+    std::size_t getMemoryUsage() const;
     private:
-    void construct(unsigned int arena_width, unsigned int arena_height,
-                   unsigned int display_width, unsigned int display_height);
-    void updateTexture(const State<>& state);
-    void presentTexture();
-    void putBlobs(const State<>& state);
-    void putSelectionCircleAndAimPoint(const State<>& state);
+    void construct(unsigned int display_width, unsigned int display_height);
+    void updateTexture(const RenderSnapshot& snapshot, float interpolation);
+    void presentTexture(const RenderSnapshot& snapshot,
+                        const DebugSnapshot* debug,
+                        const PerformanceSnapshot* performance);
+    void drawDebugLayers(const DebugSnapshot& debug);
+    void drawHud(const PerformanceSnapshot& performance);
+    void drawText(const char* text, int x, int y);
+    void fillRects(const SDL_Rect* rects, std::size_t count);
+    static double toMilliseconds(PerformanceSnapshot::Clock::duration time);
+    void setDrawColor(const SdlTexture::Color& color, std::uint8_t alpha);
+    void drawLine(const FloatVector& from, const FloatVector& to);
+    void exportFrame();
+    void readPixels(std::uint8_t* pixels, int width);
+    static unsigned int invertY(unsigned int y, unsigned int height);
+    void markDirtyTiles(const RenderSnapshot& snapshot);
+    void markTiles(const IntVector& center, float radius, unsigned int width,
+                   unsigned int height);
+    void drawTiles(const RenderSnapshot& snapshot, float interpolation,
+                   unsigned int first_column, unsigned int end_column,
+                   unsigned int row);
+    void putCells(const RenderSnapshot& snapshot, float interpolation,
+                  unsigned int x_begin, unsigned int x_end,
+                  unsigned int y_begin, unsigned int y_end);
+    void mapPalette();
+    void putSelectionCircleAndAimPoint(const IntVector& mouse_position);
+    // Where input is aimed. The snapshots catch up with it once the
+    // simulation captures the next one.
+    Viewport viewport;
+    bool headless;
     SDL_Window* window;
     SDL_Renderer* renderer;
     std::unique_ptr<SdlTexture> texture;
+    Palette palette;
+    // The palette in the texture's pixel format, and for shaded snapshots
+    // the palette at each shade (see SdlTexture::setPixels()).
+    std::array<std::uint32_t, Palette::size> pixel_values;
+    std::vector<std::uint32_t> shaded_values;
+    // What the texture shows, so that only tiles (see RenderSnapshot) that
+    // change are drawn. The tiles to draw in this frame, the tiles that show
+    // cells blended between two ticks, the sequence number of the snapshot
+    // that was drawn (0 for none) and where the selection circle was drawn.
+    std::vector<bool> dirty_tiles;
+    std::vector<bool> blended_tiles;
+    std::uint64_t drawn_sequence;
+    IntVector drawn_mouse_position;
+    // The selection circle last drawn, in samples.
+    CircleMask drawn_selection;
+    std::unique_ptr<FrameWriter> frame_writer;
+    std::unique_ptr<FrameRingWriter> frame_ring;
     const static SdlTexture::Color BLACK;
-    const static SdlTexture::Color WHITE;
-    const static SdlTexture::Color BLUE;
-    const static SdlTexture::Color RED;
+    const static SdlTexture::Color PRESSURE_COLOR;
+    const static SdlTexture::Color STRENGTH_COLOR;
+    const static SdlTexture::Color LEADERSHIP_COLOR;
+    const static SdlTexture::Color HUD_COLOR;
+    const static SdlTexture::Color OVERRUN_COLOR;
+    // Pixels per pixel of the font in the overlay.
+    const static int HUD_SCALE;
 };
 
 }
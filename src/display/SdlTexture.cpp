@@ -10,7 +10,8 @@ SdlTexture::SdlTexture(SDL_Renderer* renderer, unsigned int texture_width,
     texture(nullptr),
     pixel_format(nullptr),
     pixels(nullptr),
-    pitch(0)
+    pitch(0),
+    locked()
 {
     std::uint32_t pixel_format_id = findPixelFormat(renderer);
     texture = SDL_CreateTexture(renderer, pixel_format_id,
@@ -55,7 +56,20 @@ SdlTexture::~SdlTexture() {
 }
 
 void SdlTexture::lockForWriting() {
-    if (SDL_LockTexture(texture, nullptr, &pixels, &pitch) != 0) {
+    lockForWriting(0, 0, texture_width, texture_height);
+}
+
+// Locks only part of the texture, which saves the renderer from uploading the
+// rest. The previous contents of the region are lost, every pixel in it needs
+// to be set before unlocking.
+void SdlTexture::lockForWriting(unsigned int x, unsigned int y,
+                                unsigned int width, unsigned int height) {
+    assert(x + width <= texture_width && y + height <= texture_height);
+    locked.x = static_cast<int>(x);
+    locked.y = static_cast<int>(y);
+    locked.w = static_cast<int>(width);
+    locked.h = static_cast<int>(height);
+    if (SDL_LockTexture(texture, &locked, &pixels, &pitch) != 0) {
         throw SdlException("Error locking texture.", SDL_GetError());
     }
 }
@@ -70,38 +84,71 @@ bool SdlTexture::isLocked() const {
     return pixels != nullptr;
 }
 
+// Takes texture coordinates. Pixels outside the locked region are ignored, so
+// that shapes can be drawn into a region without clipping them first.
 void SdlTexture::setPixel(unsigned int x, unsigned int y, const Color& color) {
-    if (x >= texture_width || y >= texture_height) {
-        // Coordinates out of bounds, return gracefully.
+    assert(isLocked() && "Attempt to set pixels on unlocked texture.");
+    if (x < static_cast<unsigned int>(locked.x)
+        || y < static_cast<unsigned int>(locked.y)) {
         return;
     }
-    unsigned int index = texture_width * y + x;
-    setPixelIndex(index, color);
+    unsigned int locked_x = x - locked.x;
+    unsigned int locked_y = y - locked.y;
+    if (locked_x >= static_cast<unsigned int>(locked.w)
+        || locked_y >= static_cast<unsigned int>(locked.h)) {
+        return;
+    }
+    std::uint8_t* row = static_cast<std::uint8_t*>(pixels)
+                        + static_cast<std::size_t>(locked_y) * pitch;
+    reinterpret_cast<std::uint32_t*>(row)[locked_x] = mapColor(color);
 }
 
-void SdlTexture::setPixelIndex(unsigned int index, const Color& color) {
+// Sets count pixels of a row, starting at the given texture coordinates, to
+// the pixel values (see mapColor()) at the given indices. Unlike setPixel(),
+// the pixels must all be inside the locked region. This is how whole rows of
+// cells are drawn: looking values up in a table made once is much cheaper than
+// mapping every pixel's color.
+void SdlTexture::setPixels(unsigned int x, unsigned int y,
+                           const std::uint8_t* indices, unsigned int count,
+                           const std::uint32_t* pixel_values) {
     assert(isLocked() && "Attempt to set pixels on unlocked texture.");
-    assert(index < texture_width * texture_height && "Pixel index out of "
-           "range.");
-    std::uint32_t pixel_value = SDL_MapRGB(pixel_format, color[0], color[1],
-                                           color[2]);
-    std::uint32_t* pixels32 = static_cast<std::uint32_t*>(pixels);
-    pixels32[index] = pixel_value;
+    assert(x >= static_cast<unsigned int>(locked.x)
+           && x + count <= static_cast<unsigned int>(locked.x + locked.w));
+    assert(y >= static_cast<unsigned int>(locked.y)
+           && y < static_cast<unsigned int>(locked.y + locked.h));
+    std::uint8_t* row = static_cast<std::uint8_t*>(pixels)
+                        + static_cast<std::size_t>(y - locked.y) * pitch;
+    std::uint32_t* destination = reinterpret_cast<std::uint32_t*>(row)
+                                 + (x - locked.x);
+    for (unsigned int i = 0; i < count; i++) {
+        destination[i] = pixel_values[indices[i]];
+    }
 }
 
-void SdlTexture::setPixelRange(unsigned int start, unsigned int end,
-                               const Color& color) {
+// Like the above, but the pixel values form a table of rows of 256 values, one
+// row per shade, and each pixel's row is given by its shade.
+void SdlTexture::setPixels(unsigned int x, unsigned int y,
+                           const std::uint8_t* indices,
+                           const std::uint8_t* shades, unsigned int count,
+                           const std::uint32_t* shaded_values) {
     assert(isLocked() && "Attempt to set pixels on unlocked texture.");
-    assert(start <= texture_width * texture_height && "Start index out of "
-           "range.");
-    assert(end <= texture_width * texture_height && "End index out of range.");
-    if (start > end) {
-        return;
+    assert(x >= static_cast<unsigned int>(locked.x)
+           && x + count <= static_cast<unsigned int>(locked.x + locked.w));
+    assert(y >= static_cast<unsigned int>(locked.y)
+           && y < static_cast<unsigned int>(locked.y + locked.h));
+    std::uint8_t* row = static_cast<std::uint8_t*>(pixels)
+                        + static_cast<std::size_t>(y - locked.y) * pitch;
+    std::uint32_t* destination = reinterpret_cast<std::uint32_t*>(row)
+                                 + (x - locked.x);
+    for (unsigned int i = 0; i < count; i++) {
+        destination[i] = shaded_values[static_cast<std::size_t>(shades[i]) * 256
+                                       + indices[i]];
     }
-    std::uint32_t pixel_value = SDL_MapRGB(pixel_format, color[0], color[1],
-                                           color[2]);
-    std::uint32_t* pixels32 = static_cast<std::uint32_t*>(pixels);
-    std::fill_n(pixels32 + start, end - start, pixel_value);
+}
+
+// Returns the value of a pixel of the given color in the texture's format.
+std::uint32_t SdlTexture::mapColor(const Color& color) const {
+    return SDL_MapRGB(pixel_format, color[0], color[1], color[2]);
 }
 
 unsigned int SdlTexture::getWidth() const {
@@ -112,6 +159,13 @@ unsigned int SdlTexture::getHeight() const {
     return texture_height;
 }
 
+// Size of the pixel buffer used for streaming. The renderer may hold further
+// copies (e.g. in video memory) that aren't accounted for.
+std::size_t SdlTexture::getMemoryUsage() const {
+    return static_cast<std::size_t>(texture_width) * texture_height
+           * pixel_format->BytesPerPixel;
+}
+
 SDL_Texture* SdlTexture::getTexture() const {
     return texture;
 }
@@ -8,6 +8,7 @@
 #include <cassert>
 #include <algorithm>
 #include <array>
+#include <cstddef>
 
 namespace wotmin2d {
 
@@ -20,14 +21,20 @@ class SdlTexture {
     SdlTexture& operator=(SdlTexture other) = delete;
     ~SdlTexture();
     void lockForWriting();
+    void lockForWriting(unsigned int x, unsigned int y, unsigned int width,
+                        unsigned int height);
     void unlock();
     bool isLocked() const;
     void setPixel(unsigned int x, unsigned int y, const Color& color);
-    void setPixelIndex(unsigned int index, const Color& color);
-    void setPixelRange(unsigned int start, unsigned int end,
-                       const Color& color);
+    void setPixels(unsigned int x, unsigned int y, const std::uint8_t* indices,
+                   unsigned int count, const std::uint32_t* pixel_values);
+    void setPixels(unsigned int x, unsigned int y, const std::uint8_t* indices,
+                   const std::uint8_t* shades, unsigned int count,
+                   const std::uint32_t* shaded_values);
+    std::uint32_t mapColor(const Color& color) const;
     unsigned int getWidth() const;
     unsigned int getHeight() const;
+    std::size_t getMemoryUsage() const;
     SDL_Texture* getTexture() const;
     private:
     std::uint32_t findPixelFormat(SDL_Renderer* renderer);
@@ -38,6 +45,8 @@ class SdlTexture {
     SDL_PixelFormat* pixel_format;
     void* pixels;
     int pitch;
+    // The locked region.
+    SDL_Rect locked;
 };
 
 }
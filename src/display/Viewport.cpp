@@ -0,0 +1,185 @@
+#include "Viewport.hpp"
+
+namespace wotmin2d {
+
+constexpr int Viewport::min_zoom;
+constexpr int Viewport::max_zoom;
+
+Viewport::Viewport() :
+    arena_width(0),
+    arena_height(0),
+    view_width(0),
+    view_height(0),
+    zoom_level(0),
+    origin(0, 0) {}
+
+// Starts with the largest zoom at which the whole arena fits into the view (or
+// the smallest possible zoom), centered.
+Viewport::Viewport(unsigned int arena_width, unsigned int arena_height,
+                   unsigned int view_width, unsigned int view_height) :
+    arena_width(arena_width),
+    arena_height(arena_height),
+    view_width(view_width),
+    view_height(view_height),
+    zoom_level(0),
+    origin(0, 0) {
+    assert(view_width > 0 && view_height > 0);
+    if (arena_width <= view_width && arena_height <= view_height) {
+        while (zoom_level < max_zoom
+               && arena_width << (zoom_level + 1) <= view_width
+               && arena_height << (zoom_level + 1) <= view_height) {
+            zoom_level++;
+        }
+    } else {
+        while (zoom_level > min_zoom
+               && (view_width * getCellsPerSample() < arena_width
+                   || view_height * getCellsPerSample() < arena_height)) {
+            zoom_level--;
+        }
+    }
+    clampOrigin();
+}
+
+bool Viewport::operator==(const Viewport& other) const {
+    return arena_width == other.arena_width
+           && arena_height == other.arena_height
+           && view_width == other.view_width
+           && view_height == other.view_height
+           && zoom_level == other.zoom_level && origin == other.origin;
+}
+
+bool Viewport::operator!=(const Viewport& other) const {
+    return !(*this == other);
+}
+
+// Zooms in (positive steps) or out, keeping the cell under the anchor (in
+// window coordinates) where it is.
+void Viewport::zoom(int steps, const IntVector& anchor) {
+    IntVector cell = windowToArena(anchor);
+    zoom_level = std::max(min_zoom, std::min(max_zoom, zoom_level + steps));
+    IntVector sample = windowToSample(anchor);
+    origin = cell - sample * static_cast<int>(getCellsPerSample());
+    clampOrigin();
+}
+
+// Moves the view by an eighth of its size in the given direction (with y
+// pointing up, like arena coordinates).
+void Viewport::pan(const IntVector& direction) {
+    int step_x = std::max<int>(getColumns() * getCellsPerSample() / 8, 1);
+    int step_y = std::max<int>(getRows() * getCellsPerSample() / 8, 1);
+    origin += IntVector(direction.getX() * step_x, direction.getY() * step_y);
+    clampOrigin();
+}
+
+int Viewport::getZoom() const {
+    return zoom_level;
+}
+
+const IntVector& Viewport::getOrigin() const {
+    return origin;
+}
+
+unsigned int Viewport::getViewWidth() const {
+    return view_width;
+}
+
+unsigned int Viewport::getViewHeight() const {
+    return view_height;
+}
+
+unsigned int Viewport::getPixelsPerSample() const {
+    return zoom_level > 0 ? 1u << zoom_level : 1u;
+}
+
+unsigned int Viewport::getCellsPerSample() const {
+    return zoom_level < 0 ? 1u << -zoom_level : 1u;
+}
+
+// Returns the number of samples across the view, including one that is only
+// partly visible at the right edge.
+unsigned int Viewport::getColumns() const {
+    return (view_width + getPixelsPerSample() - 1) / getPixelsPerSample();
+}
+
+unsigned int Viewport::getRows() const {
+    return (view_height + getPixelsPerSample() - 1) / getPixelsPerSample();
+}
+
+// Returns the bottom left cell of the visible part of the arena.
+IntVector Viewport::getVisibleBegin() const {
+    return IntVector(std::max(origin.getX(), 0), std::max(origin.getY(), 0));
+}
+
+// Returns the cell after the top right cell of the visible part of the arena.
+// The visible part is empty if it isn't above and to the right of the begin.
+IntVector Viewport::getVisibleEnd() const {
+    int cells = static_cast<int>(getCellsPerSample());
+    int x_end = origin.getX() + static_cast<int>(getColumns()) * cells;
+    int y_end = origin.getY() + static_cast<int>(getRows()) * cells;
+    return IntVector(std::min(x_end, static_cast<int>(arena_width)),
+                     std::min(y_end, static_cast<int>(arena_height)));
+}
+
+// Takes window coordinates, which start at the top left. Coordinates outside
+// the window (e.g. while it's resized) are moved to its border.
+IntVector Viewport::windowToSample(const IntVector& coordinate) const {
+    int x = std::max(0, std::min(coordinate.getX(),
+                                 static_cast<int>(view_width) - 1));
+    int y = std::max(0, std::min(coordinate.getY(),
+                                 static_cast<int>(view_height) - 1));
+    int pixels = static_cast<int>(getPixelsPerSample());
+    return IntVector(x / pixels, (static_cast<int>(view_height) - 1 - y)
+                                 / pixels);
+}
+
+// Returns the cell shown at the given window coordinates (the bottom left cell
+// of the sample when zoomed out). Coordinates beside the arena are moved to
+// its border.
+IntVector Viewport::windowToArena(const IntVector& coordinate) const {
+    IntVector cell = origin + windowToSample(coordinate)
+                              * static_cast<int>(getCellsPerSample());
+    int x_max = std::max(static_cast<int>(arena_width) - 1, 0);
+    int y_max = std::max(static_cast<int>(arena_height) - 1, 0);
+    return IntVector(std::max(0, std::min(cell.getX(), x_max)),
+                     std::max(0, std::min(cell.getY(), y_max)));
+}
+
+// Takes a position in the arena where cells are squares from their coordinates
+// to the next, so (x + 0.5, y + 0.5) is the center of cell (x, y), and returns
+// where it is shown in the window. It may be outside of the window.
+FloatVector Viewport::arenaToWindow(const FloatVector& position) const {
+    float scale = static_cast<float>(getPixelsPerSample())
+                  / static_cast<float>(getCellsPerSample());
+    return FloatVector(
+        (position.getX() - static_cast<float>(origin.getX())) * scale,
+        static_cast<float>(view_height)
+        - (position.getY() - static_cast<float>(origin.getY())) * scale);
+}
+
+void Viewport::clampOrigin() {
+    origin = IntVector(
+        clampAxis(origin.getX(), arena_width,
+                  getColumns() * getCellsPerSample()),
+        clampAxis(origin.getY(), arena_height,
+                  getRows() * getCellsPerSample()));
+}
+
+// An arena smaller than the view is centered, a larger one always fills the
+// view. Zoomed out, the origin is then rounded down to a multiple of the cells
+// per sample.
+int Viewport::clampAxis(int origin, unsigned int arena_size,
+                        unsigned int visible_size) const {
+    int arena = static_cast<int>(arena_size);
+    int visible = static_cast<int>(visible_size);
+    int clamped;
+    if (visible >= arena) {
+        clamped = -((visible - arena) / 2);
+    } else {
+        clamped = std::max(0, std::min(origin, arena - visible));
+    }
+    int cells = static_cast<int>(getCellsPerSample());
+    int remainder = clamped % cells;
+    return remainder < 0 ? clamped - remainder - cells : clamped - remainder;
+}
+
+}
@@ -0,0 +1,61 @@
+#ifndef VIEWPORT_HPP
+#define VIEWPORT_HPP
+
+#include "../game/Vector.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace wotmin2d {
+
+/**
+ * The part of the arena that is shown in a view (the window) of a given size
+ * in pixels, and at which zoom.
+ *
+ * The view is divided into samples. At zoom level z >= 0, a sample is a cell
+ * shown as a square of 2^z by 2^z pixels, at z < 0 a sample is a pixel that
+ * covers 2^-z by 2^-z cells. Samples are counted from the bottom left of the
+ * view like cells, and sample (0, 0) starts at the origin cell. Keeping the
+ * zoom to powers of two means samples always line up with whole cells, and
+ * zoomed out the origin is kept at a multiple of the cells per sample, so they
+ * also line up with the blocks of a DensityPyramid.
+ */
+class Viewport {
+    public:
+    constexpr static int min_zoom = -8;
+    constexpr static int max_zoom = 5;
+    Viewport();
+    Viewport(unsigned int arena_width, unsigned int arena_height,
+             unsigned int view_width, unsigned int view_height);
+    bool operator==(const Viewport& other) const;
+    bool operator!=(const Viewport& other) const;
+    void zoom(int steps, const IntVector& anchor);
+    void pan(const IntVector& direction);
+    int getZoom() const;
+    const IntVector& getOrigin() const;
+    unsigned int getViewWidth() const;
+    unsigned int getViewHeight() const;
+    unsigned int getPixelsPerSample() const;
+    unsigned int getCellsPerSample() const;
+    unsigned int getColumns() const;
+    unsigned int getRows() const;
+    IntVector getVisibleBegin() const;
+    IntVector getVisibleEnd() const;
+    IntVector windowToSample(const IntVector& coordinate) const;
+    IntVector windowToArena(const IntVector& coordinate) const;
+    FloatVector arenaToWindow(const FloatVector& position) const;
+    private:
+    void clampOrigin();
+    int clampAxis(int origin, unsigned int arena_size,
+                  unsigned int visible_size) const;
+    unsigned int arena_width;
+    unsigned int arena_height;
+    unsigned int view_width;
+    unsigned int view_height;
+    int zoom_level;
+    IntVector origin;
+};
+
+}
+
+#endif
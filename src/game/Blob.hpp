@@ -4,6 +4,12 @@
 #include "BlobState.hpp"
 #include "Particle.hpp"
 #include "Vector.hpp"
+#include "Shape.hpp"
+#include "MemoryUsage.hpp"
+#include "Snapshot.hpp"
+#include "ChangeLog.hpp"
+#include "DensityPyramid.hpp"
+#include "CircleMask.hpp"
 #include "../Config.hpp"
 
 #include <vector>
@@ -25,16 +31,28 @@ class Blob {
     Blob(const IntVector& center, float radius,
          unsigned int arena_width, unsigned int arena_height,
          std::shared_ptr<B> state = std::make_shared<B>());
+    Blob(const Shape& shape, unsigned int arena_width,
+         unsigned int arena_height,
+         std::shared_ptr<B> state = std::make_shared<B>());
     void damageParticle(P& particle, int advantage);
     const typename BlobState<P>::ParticleSet& getParticles() const;
     P* getParticleAt(const IntVector& position) const;
     void advanceParticles(std::chrono::milliseconds time_delta);
     P* getHighestMobilityParticle() const;
     void setTarget(const IntVector& target, float pressure_per_second,
-                   const IntVector& center, float radius);
+                   const IntVector& center, const CircleMask& selection);
+    void setTarget(const IntVector& target, float pressure_per_second);
     void collideParticleWithWall(P& particle, Direction collision_direction);
-    void handleParticle(P& particle, Direction movement_direction);
+    bool handleParticle(P& particle, Direction movement_direction);
     int getParticleStrength(const P& particle) const;
+    MemoryUsage getMemoryUsage() const;
+    void snapshot(BlobSnapshot& snapshot) const;
+    void restore(const BlobSnapshot& snapshot);
+    void setChangeLogging(bool enabled);
+    const ChangeLog& getChanges() const;
+    void setDensityTracking(unsigned int arena_width,
+                            unsigned int arena_height);
+    const DensityPyramid& getDensity() const;
     private:
     // TODO Store by value and make the tests a friend so they can replace it.
     std::shared_ptr<B> state;
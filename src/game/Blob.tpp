@@ -7,31 +7,15 @@ template<class P, class B>
 Blob<P, B>::Blob(const IntVector& center, float radius,
                  unsigned int arena_width, unsigned int arena_height,
                  std::shared_ptr<B> state) :
+    Blob(radius > 0.0f ? Shape::circle(center, radius) : Shape(),
+         arena_width, arena_height, state) {}
+
+template<class P, class B>
+Blob<P, B>::Blob(const Shape& shape, unsigned int arena_width,
+                 unsigned int arena_height, std::shared_ptr<B> state) :
     state(state)
 {
-    if (radius <= 0.0) {
-        return;
-    }
-    // Add particles by checking every vector within the bounding box of the
-    // circle whether it's less than the radius from the center.
-    int rounded_radius = static_cast<int>(radius + 0.5);
-    int left = std::max(0, center.getX() - rounded_radius);
-    int top = std::max(0, center.getY() - rounded_radius);
-    int right = std::min(center.getX() + rounded_radius,
-                         static_cast<int>(arena_width - 1));
-    int bottom = std::min(center.getY() + rounded_radius,
-                          static_cast<int>(arena_height - 1));
-    float squared_radius = radius * radius;
-    for (int y = top; y <= bottom; y++) {
-        for (int x = left; x <= right; x++) {
-            IntVector coordinate(x, y);
-            IntVector center_to_coordinate = coordinate - center;
-            int squaredNorm = center_to_coordinate.squaredNorm();
-            if (squaredNorm <= squared_radius) {
-                state->addParticle(coordinate);
-            }
-        }
-    }
+    state->addParticles(shape.clipped(arena_width, arena_height));
 }
 
 template<class P, class B>
@@ -59,29 +43,41 @@ P* Blob<P, B>::getHighestMobilityParticle() const {
     return state->getHighestMobilityParticle();
 }
 
+// Sets the target of the particles within the selection around the center.
 template<class P, class B>
 void Blob<P, B>::setTarget(const IntVector& target, float pressure_per_second,
-                           const IntVector& center, float radius) {
-    const std::vector<P*> particles = state->getParticles(center, radius);
+                           const IntVector& center,
+                           const CircleMask& selection) {
+    const std::vector<P*> particles = state->getParticles(center, selection);
     for (P* particle: particles) {
         particle->setTarget(target, pressure_per_second);
     }
 }
 
+// Sets the target of all particles.
+template<class P, class B>
+void Blob<P, B>::setTarget(const IntVector& target,
+                           float pressure_per_second) {
+    for (P* particle: state->getParticles()) {
+        particle->setTarget(target, pressure_per_second);
+    }
+}
+
 template<class P, class B>
 void Blob<P, B>::collideParticleWithWall(P& particle,
                                          Direction collision_direction) {
     state->collideParticleWithWall(particle, collision_direction);
 }
 
+// Returns whether the particle moved, rather than colliding with its neighbor.
 template<class P, class B>
-void Blob<P, B>::handleParticle(P& particle, Direction movement_direction) {
+bool Blob<P, B>::handleParticle(P& particle, Direction movement_direction) {
     P* forward_neighbor = particle.getNeighbor(movement_direction);
     if (forward_neighbor != nullptr) {
         // Movement is obstructed. Only collide.
         state->collideParticles(particle, *forward_neighbor,
                                 movement_direction);
-        return;
+        return false;
     }
     // TODO Maybe add more than the immediate neighbors? Maybe also their
     // neighbors?
@@ -99,6 +95,7 @@ void Blob<P, B>::handleParticle(P& particle, Direction movement_direction) {
         // neighbors follow it to catch up.
         state->addParticleFollowers(particle, neighbors);
     }
+    return true;
 }
 
 template<class P, class B>
@@ -106,4 +103,40 @@ int Blob<P, B>::getParticleStrength(const P& particle) const {
     return state->getParticleStrength(particle);
 }
 
+template<class P, class B>
+MemoryUsage Blob<P, B>::getMemoryUsage() const {
+    return state->getMemoryUsage();
+}
+
+template<class P, class B>
+void Blob<P, B>::snapshot(BlobSnapshot& snapshot) const {
+    state->snapshot(snapshot);
+}
+
+template<class P, class B>
+void Blob<P, B>::restore(const BlobSnapshot& snapshot) {
+    state->restore(snapshot);
+}
+
+template<class P, class B>
+void Blob<P, B>::setChangeLogging(bool enabled) {
+    state->setChangeLogging(enabled);
+}
+
+template<class P, class B>
+const ChangeLog& Blob<P, B>::getChanges() const {
+    return state->getChanges();
+}
+
+template<class P, class B>
+void Blob<P, B>::setDensityTracking(unsigned int arena_width,
+                                    unsigned int arena_height) {
+    state->setDensityTracking(arena_width, arena_height);
+}
+
+template<class P, class B>
+const DensityPyramid& Blob<P, B>::getDensity() const {
+    return state->getDensity();
+}
+
 }
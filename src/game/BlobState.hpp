@@ -3,6 +3,14 @@
 
 #include "Direction.hpp"
 #include "Particle.hpp"
+#include "MemoryUsage.hpp"
+#include "ParticlePool.hpp"
+#include "NodePool.hpp"
+#include "Shape.hpp"
+#include "Snapshot.hpp"
+#include "ChangeLog.hpp"
+#include "DensityPyramid.hpp"
+#include "CircleMask.hpp"
 
 #include <vector>
 #include <unordered_map>
@@ -10,6 +18,10 @@
 #include <algorithm>
 #include <array>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <functional>
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/hashed_index.hpp>
 #include <boost/multi_index/ordered_index.hpp>
@@ -22,17 +34,23 @@ namespace mi = boost::multi_index;
 template<class P = Particle>
 class BlobState {
     public:
+    // The constants of the simulation are those of the particles.
+    using Config = typename P::Config;
     class ParticleMobilityGreater {
         public:
         bool operator()(const P* first, const P* second) const;
     };
-    using ParticleMap = std::unordered_map<IntVector, P*, IntVector::Hash>;
+    using ParticleMap = std::unordered_map<
+        IntVector, P*, IntVector::Hash, std::equal_to<IntVector>,
+        NodeAllocator<std::pair<const IntVector, P*>>
+    >;
     using ParticleSet = mi::multi_index_container<
         P*,
         mi::indexed_by<
             mi::hashed_unique<mi::identity<P*>>,
             mi::ordered_non_unique<mi::identity<P*>, ParticleMobilityGreater>
-        >
+        >,
+        NodeAllocator<P*>
     >;
     BlobState();
     BlobState(const BlobState&) = delete;
@@ -41,8 +59,11 @@ class BlobState {
     const ParticleSet& getParticles() const;
     const std::vector<P*> getParticles(const IntVector& center,
                                        float radius) const;
+    const std::vector<P*> getParticles(const IntVector& center,
+                                       const CircleMask& mask) const;
     P* getParticleAt(const IntVector& position) const;
     void addParticle(const IntVector& position);
+    void addParticles(const Shape& shape);
     void damageParticle(P& particle, int advantage);
     void moveParticle(P& particle, Direction movement_direction);
     void collideParticles(P& first, P& second, Direction collision_direction);
@@ -51,9 +72,24 @@ class BlobState {
     P* getHighestMobilityParticle();
     void addParticleFollowers(P& leader, const std::vector<P*>& followers);
     int getParticleStrength(const P& particle) const;
+    MemoryUsage getMemoryUsage() const;
+    void snapshot(BlobSnapshot& snapshot) const;
+    void restore(const BlobSnapshot& snapshot);
+    void setChangeLogging(bool enabled);
+    const ChangeLog& getChanges() const;
+    void setDensityTracking(unsigned int arena_width,
+                            unsigned int arena_height);
+    const DensityPyramid& getDensity() const;
     private:
+    ParticlePool<P> pool;
+    // The nodes of the containers, declared first so they outlive them.
+    NodePool set_nodes;
+    NodePool map_nodes;
     ParticleSet particles;
     ParticleMap particle_map;
+    std::vector<P*> advance_order;
+    ChangeLog change_log;
+    DensityPyramid density;
     void updateParticleInformation(P& particle,
                                    const IntVector& old_position);
     void updateParticleMap(P& particle, const IntVector& old_position);
@@ -61,6 +97,8 @@ class BlobState {
     template<class Modifier>
     void modifyParticle(P& particle, Modifier modifier);
     void removeParticle(P& particle);
+    void clear();
+    void linkNeighbor(P& particle, Direction direction, P* neighbor);
 };
 
 }
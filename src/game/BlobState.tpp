@@ -2,14 +2,22 @@ namespace wotmin2d {
 
 template<class P>
 BlobState<P>::BlobState() :
-    particles(),
-    particle_map() {
+    pool(),
+    set_nodes(),
+    map_nodes(),
+    particles(typename ParticleSet::ctor_args_list(),
+              NodeAllocator<P*>(set_nodes)),
+    particle_map(0, IntVector::Hash(), std::equal_to<IntVector>(),
+                 typename ParticleMap::allocator_type(map_nodes)),
+    advance_order(),
+    change_log(),
+    density() {
 }
 
 template<class P>
 BlobState<P>::~BlobState() {
-    for (const P* particle: particles) {
-        delete particle;
+    for (P* particle: particles) {
+        pool.destroy(particle);
     }
 }
 
@@ -21,9 +29,18 @@ const typename BlobState<P>::ParticleSet& BlobState<P>::getParticles() const {
 template<class P>
 const std::vector<P*> BlobState<P>::getParticles(const IntVector& center,
                                                  float radius) const {
+    return getParticles(center, CircleMask(radius));
+}
+
+// Returns the particles within the mask around the center. Whoever queries the
+// same radius repeatedly should keep the mask, so its rows aren't measured
+// again for every query.
+template<class P>
+const std::vector<P*> BlobState<P>::getParticles(const IntVector& center,
+                                                 const CircleMask& mask) const {
     // TODO If particle_map were two nested one-dimensional maps, this could go
     // faster (just using lower_bound() and upper_bound()).
-    if (radius < 0.0f) {
+    if (mask.empty()) {
         return {};
     }
     std::vector<P*> particles;
@@ -33,17 +50,13 @@ const std::vector<P*> BlobState<P>::getParticles(const IntVector& center,
     if (center_iter != particle_map.end()) {
         particles.push_back(center_iter->second);
     }
-    int radius_int = static_cast<int>(radius);
-    int squared_radius = static_cast<int>(radius * radius);
-    int half_width = 1;
-    for (int i = radius_int; i > 0; i--) {
-        for (; IntVector(half_width, i).squaredNorm() <= squared_radius;
-             half_width++);
+    for (int i = mask.getExtent(); i > 0; i--) {
+        int half_width = mask.getHalfWidth(i);
         // Look in all four cardinal directions, up to the radius.
         for (Direction forward: Direction::all()) {
             // From there, turn right, up to the width of the circle at the
             // distance from the center.
-            for (int j = 0; j < half_width; j++) {
+            for (int j = 0; j <= half_width; j++) {
                 IntVector position = center + (forward.vector() * i)
                                      + (forward.right().vector() * j);
                 auto iter = particle_map.find(position);
@@ -73,9 +86,10 @@ void BlobState<P>::addParticle(const IntVector& position) {
         assert(position_iter == particle_map.end()
                && "Attempt to add particle on top of another one.");
     #endif
-    P* particle = new P(position);
+    P* particle = pool.create(position);
     particles.insert(particle);
     particle_map.emplace(position, particle);
+    density.add(position);
     // Make potential neighbors aware of the new particle and vice versa.
     for (const Direction& direction: Direction::all()) {
         auto neighbor_iter = particle_map.find(position + direction.vector());
@@ -88,6 +102,68 @@ void BlobState<P>::addParticle(const IntVector& position) {
     }
 }
 
+// Adds particles at all positions of the shape in a single pass over its rows.
+// Neighbors within the shape are linked from the particles created just before
+// in the same row and the previous row, only positions outside the shape are
+// looked up in the particle map (and only if there were particles before).
+template<class P>
+void BlobState<P>::addParticles(const Shape& shape) {
+    std::size_t count = shape.count();
+    if (count == 0) {
+        return;
+    }
+    bool had_particles = !particle_map.empty();
+    pool.reserve(count);
+    particles.reserve(particles.size() + count);
+    particle_map.reserve(particle_map.size() + count);
+    typename ParticleSet::template nth_index<1>::type& mobility_index
+        = particles.template get<1>();
+    unsigned int width = shape.getWidth();
+    unsigned int height = shape.getHeight();
+    std::vector<P*> previous_row(width, nullptr);
+    for (unsigned int y = 0; y < height; y++) {
+        P* west_particle = nullptr;
+        for (unsigned int x = 0; x < width; x++) {
+            if (!shape.isSet(x, y)) {
+                previous_row[x] = nullptr;
+                west_particle = nullptr;
+                continue;
+            }
+            IntVector position = shape.getOrigin()
+                                 + IntVector(static_cast<int>(x),
+                                             static_cast<int>(y));
+            assert(particle_map.count(position) == 0
+                   && "Attempt to add particle on top of another one.");
+            P* particle = pool.create(position);
+            // New particles have no pressure and are created row by row, so
+            // they usually belong at the end of the mobility index.
+            mobility_index.insert(mobility_index.end(), particle);
+            particle_map.emplace(position, particle);
+            density.add(position);
+            linkNeighbor(*particle, Direction::south(), previous_row[x]);
+            linkNeighbor(*particle, Direction::west(), west_particle);
+            if (had_particles) {
+                bool in_shape[4];
+                in_shape[Direction::south()] = y > 0 && shape.isSet(x, y - 1);
+                in_shape[Direction::west()] = x > 0 && shape.isSet(x - 1, y);
+                in_shape[Direction::north()] = y + 1 < height
+                                               && shape.isSet(x, y + 1);
+                in_shape[Direction::east()] = x + 1 < width
+                                              && shape.isSet(x + 1, y);
+                for (Direction direction: Direction::all()) {
+                    if (in_shape[direction]) {
+                        continue;
+                    }
+                    linkNeighbor(*particle, direction,
+                                 getParticleAt(position + direction.vector()));
+                }
+            }
+            previous_row[x] = particle;
+            west_particle = particle;
+        }
+    }
+}
+
 template<class P>
 void BlobState<P>::damageParticle(P& particle, int advantage) {
     unsigned int amount;
@@ -99,6 +175,9 @@ void BlobState<P>::damageParticle(P& particle, int advantage) {
     particle.damage({}, amount);
     if (particle.getHealth() == 0) {
         removeParticle(particle);
+    } else if (amount > 0) {
+        change_log.add(ChangeLog::Change::damage(particle.getPosition(),
+                                                 particle.getHealth()));
     }
 }
 
@@ -121,7 +200,30 @@ void BlobState<P>::removeParticle(P& particle) {
     assert(particle_map.at(particle.getPosition()) == &particle
            && "Particle is not at the position it thinks it is.");
     particle_map.erase(particle.getPosition());
-    delete &particle;
+    density.remove(particle.getPosition());
+    change_log.add(ChangeLog::Change::death(particle.getPosition()));
+    pool.destroy(&particle);
+}
+
+template<class P>
+void BlobState<P>::clear() {
+    for (P* particle: particles) {
+        pool.destroy(particle);
+    }
+    particles.clear();
+    particle_map.clear();
+    density.clear();
+}
+
+// Makes particle and neighbor aware of each other, if there is a neighbor.
+template<class P>
+void BlobState<P>::linkNeighbor(P& particle, Direction direction,
+                                P* neighbor) {
+    if (neighbor == nullptr) {
+        return;
+    }
+    particle.setNeighbor({}, direction, neighbor);
+    neighbor->setNeighbor({}, direction.opposite(), &particle);
 }
 
 template<class P>
@@ -193,6 +295,8 @@ void BlobState<P>::moveParticle(P& particle, Direction forward_direction) {
     auto modifier = [=](P* p) { p->move({}, forward_direction); };
     modifyParticle(particle, modifier);
     updateParticleInformation(particle, old_position);
+    density.move(old_position, particle.getPosition());
+    change_log.add(ChangeLog::Change::move(old_position, forward_direction));
 }
 
 template<class P>
@@ -223,15 +327,25 @@ void BlobState<P>::collideParticleWithWall(P& particle,
     modifyParticle(particle, modifier);
 }
 
-// Advances all particles to "refresh" pressure.
+// Advances all particles to "refresh" pressure. This starts a new tick, so the
+// changes of the last one are cleared. Particles influence each
+// other while advancing, so the order matters. The 0-th index is ordered by
+// memory address, which differs between runs, so the particles are advanced in
+// the order of the mobility index instead. It's copied first since modifying
+// the particles reorders it.
 template<class P>
 void BlobState<P>::advanceParticles(std::chrono::milliseconds time_delta) {
+    change_log.clear();
     auto modifier = [=](P* p) { p->advance({}, time_delta); };
-    // Modifying particles doesn't change their order in the 0-th index (using
-    // identity, i.e. their memory address, as key), so the iterator stays valid
-    // even if we modify stuff.
-    for (P* particle: particles) {
+    const typename ParticleSet::template nth_index<1>::type& mobility_index
+        = particles.template get<1>();
+    advance_order.assign(mobility_index.begin(), mobility_index.end());
+    for (P* particle: advance_order) {
         modifyParticle(*particle, modifier);
+        // Advancing pushed the followers, update their place in the index.
+        for (P* follower: particle->getFollowers({})) {
+            modifyParticle(*follower, [](P*){ /* nop */ });
+        }
     }
 }
 
@@ -290,6 +404,189 @@ int BlobState<P>::getParticleStrength(const P& particle) const {
     return strength;
 }
 
+template<class P>
+MemoryUsage BlobState<P>::getMemoryUsage() const {
+    // Nodes of the follower and leader sets hold a next pointer and the
+    // particle pointer.
+    const std::size_t relation_node_size = sizeof(void*) + sizeof(P*);
+    std::size_t relation_bytes = 0;
+    for (P* particle: particles) {
+        relation_bytes += MemoryUsage::hashContainerSize(
+            particle->getFollowers({}), relation_node_size);
+        relation_bytes += MemoryUsage::hashContainerSize(
+            particle->getLeaders({}), relation_node_size);
+    }
+    // The nodes of the particle set and map are counted by their pools, which
+    // also hold the nodes of particles removed since.
+    return MemoryUsage(
+        particles.size(),
+        pool.getMemoryUsage(),
+        relation_bytes,
+        MemoryUsage::bucketArraySize(particles) + set_nodes.getMemoryUsage()
+            + advance_order.capacity() * sizeof(P*)
+            + change_log.getMemoryUsage() + density.getMemoryUsage(),
+        MemoryUsage::bucketArraySize(particle_map)
+            + map_nodes.getMemoryUsage());
+}
+
+// Writes the particles to the snapshot in the order of the mobility index.
+// Pointers are translated to indices using a sorted array of all particles,
+// which needs a single allocation instead of one per particle.
+template<class P>
+void BlobState<P>::snapshot(BlobSnapshot& snapshot) const {
+    using IndexEntry = std::pair<const P*, std::uint32_t>;
+    std::less<const P*> pointer_less;
+    const typename ParticleSet::template nth_index<1>::type& mobility_index
+        = particles.template get<1>();
+    std::vector<IndexEntry> indices;
+    indices.reserve(particles.size());
+    for (const P* particle: mobility_index) {
+        indices.emplace_back(particle,
+                             static_cast<std::uint32_t>(indices.size()));
+    }
+    std::sort(indices.begin(), indices.end(),
+              [&](const IndexEntry& first, const IndexEntry& second) {
+                  return pointer_less(first.first, second.first);
+              });
+    auto index_of = [&](const P* particle) -> std::uint32_t {
+        if (particle == nullptr) {
+            return ParticleRecord::no_particle;
+        }
+        auto iter = std::lower_bound(
+            indices.begin(), indices.end(), particle,
+            [&](const IndexEntry& entry, const P* p) {
+                return pointer_less(entry.first, p);
+            });
+        assert(iter != indices.end() && iter->first == particle
+               && "Relation to a particle that isn't part of the blob.");
+        return iter->second;
+    };
+    snapshot.clear();
+    std::vector<ParticleRecord>& records = snapshot.getParticles();
+    std::vector<std::uint32_t>& followers = snapshot.getFollowers();
+    records.reserve(particles.size());
+    for (P* particle: mobility_index) {
+        ParticleRecord record;
+        record.x = particle->getPosition().getX();
+        record.y = particle->getPosition().getY();
+        record.target_x = particle->getTarget().getX();
+        record.target_y = particle->getTarget().getY();
+        record.target_pressure_per_second
+            = particle->getTargetPressurePerSecond();
+        record.pressure_x = particle->getPressure().getX();
+        record.pressure_y = particle->getPressure().getY();
+        record.health = particle->getHealth();
+        for (Direction direction: Direction::all()) {
+            record.neighbors[static_cast<Direction::val_t>(direction)]
+                = index_of(particle->getConstNeighbor(direction));
+        }
+        record.followers_begin = followers.size();
+        for (P* follower: particle->getFollowers({})) {
+            followers.push_back(index_of(follower));
+        }
+        // Hash set order depends on addresses, sorting makes snapshots of
+        // equal blobs equal.
+        std::sort(followers.begin() + record.followers_begin,
+                  followers.end());
+        record.followers_end = followers.size();
+        records.push_back(record);
+    }
+}
+
+// Replaces all particles with the ones in the snapshot. This rebuilds the
+// particle set and map, so it takes time linear in the number of particles,
+// with one hash of each particle for the set and of its position for the map.
+// They can't be copied back as a block: their nodes, the particles and the
+// neighbor and follower links all point at each other, so a copy would only
+// be valid at the addresses it was taken from. Snapshots are kept free of
+// addresses so that the same ones can be saved to files and restored into
+// forks (see StateFork).
+// Memory for all particles is reserved up front, and since the records are in
+// mobility order, particles are appended to the mobility index without
+// searching. The nodes of the particle set and map come from their pools,
+// where clear() returned the old ones, so restoring a blob of similar size
+// doesn't allocate per particle.
+template<class P>
+void BlobState<P>::restore(const BlobSnapshot& snapshot) {
+    clear();
+    // Every particle may have changed, which isn't logged.
+    change_log.invalidate();
+    const std::vector<ParticleRecord>& records = snapshot.getParticles();
+    const std::vector<std::uint32_t>& followers = snapshot.getFollowers();
+    pool.reserve(records.size());
+    particles.reserve(records.size());
+    particle_map.reserve(records.size());
+    typename ParticleSet::template nth_index<1>::type& mobility_index
+        = particles.template get<1>();
+    // The advance order is only needed during advanceParticles(), so its
+    // memory can hold the restored particles in the meantime. Together with
+    // the slots of the pool, restoring a blob of similar size again doesn't
+    // allocate memory for particles.
+    std::vector<P*>& restored = advance_order;
+    restored.clear();
+    for (const ParticleRecord& record: records) {
+        IntVector position(record.x, record.y);
+        assert(particle_map.count(position) == 0
+               && "Snapshot has more than one particle at a position.");
+        P* particle = pool.create(position);
+        particle->setTarget(IntVector(record.target_x, record.target_y),
+                            record.target_pressure_per_second);
+        particle->restore({}, FloatVector(record.pressure_x,
+                                          record.pressure_y),
+                          record.health);
+        mobility_index.insert(mobility_index.end(), particle);
+        particle_map.emplace(position, particle);
+        density.add(position);
+        restored.push_back(particle);
+    }
+    for (std::size_t i = 0; i < records.size(); i++) {
+        const ParticleRecord& record = records[i];
+        P& particle = *restored[i];
+        for (Direction direction: Direction::all()) {
+            std::uint32_t neighbor
+                = record.neighbors[static_cast<Direction::val_t>(direction)];
+            if (neighbor != ParticleRecord::no_particle) {
+                assert(neighbor < restored.size());
+                particle.setNeighbor({}, direction, restored[neighbor]);
+            }
+        }
+        for (std::uint32_t j = record.followers_begin;
+             j < record.followers_end; j++) {
+            assert(j < followers.size() && followers[j] < restored.size());
+            particle.linkFollower({}, *restored[followers[j]]);
+        }
+    }
+    restored.clear();
+}
+
+template<class P>
+void BlobState<P>::setChangeLogging(bool enabled) {
+    change_log.setEnabled(enabled);
+}
+
+// Returns the changes since the start of the current tick (the last call to
+// advanceParticles()), if logging is enabled.
+template<class P>
+const ChangeLog& BlobState<P>::getChanges() const {
+    return change_log;
+}
+
+// Starts counting the particles in a DensityPyramid covering an arena of the
+// given size, beginning with the ones there are. An empty arena stops it.
+template<class P>
+void BlobState<P>::setDensityTracking(unsigned int arena_width,
+                                      unsigned int arena_height) {
+    density.reset(arena_width, arena_height);
+    for (const P* particle: particles) {
+        density.add(particle->getPosition());
+    }
+}
+
+template<class P>
+const DensityPyramid& BlobState<P>::getDensity() const {
+    return density;
+}
+
 template<class P>
 template<class Modifier>
 void BlobState<P>::modifyParticle(P& particle, Modifier modifier) {
@@ -298,12 +595,20 @@ void BlobState<P>::modifyParticle(P& particle, Modifier modifier) {
     #ifndef NDEBUG
     bool success =
     #endif
-    particles.modify(it, modifier);
+    particles.modify(it, [&modifier](P* p) {
+        modifier(p);
+        p->updateMobility({});
+    });
     assert(success && "Modification of particle failed.");
 }
 
 // Returns whether first is more mobile than second, i.e. compares pressure and
-// treats a particle whose canMove() returns false as having no pressure.
+// treats a particle whose canMove() returns false as having no pressure. The
+// mobility cached in the particles is used, since modifying one particle can
+// change the pressure of others that haven't been put in their new place yet.
+// Particles with the same mobility are ordered by position, which makes the
+// order of the index depend only on the particles and not on the order they
+// were modified in.
 template<class P>
 bool BlobState<P>::ParticleMobilityGreater::operator()(const P* first,
                                                        const P* second) const {
@@ -312,16 +617,17 @@ bool BlobState<P>::ParticleMobilityGreater::operator()(const P* first,
     } else if (second == nullptr) {
         return true;
     }
-    bool first_can_move = first->canMove();
-    bool second_can_move = second->canMove();
-    if (first_can_move && second_can_move) {
-        return first->getPressure().squaredNorm()
-            > second->getPressure().squaredNorm();
-    } else if (first_can_move) {
-        return true;
-    } else {
-        return false;
+    float first_mobility = first->getMobility();
+    float second_mobility = second->getMobility();
+    if (first_mobility != second_mobility) {
+        return first_mobility > second_mobility;
+    }
+    const IntVector& first_position = first->getPosition();
+    const IntVector& second_position = second->getPosition();
+    if (first_position.getY() != second_position.getY()) {
+        return first_position.getY() < second_position.getY();
     }
+    return first_position.getX() < second_position.getX();
 }
 
 }
@@ -0,0 +1,107 @@
+#include "ChangeLog.hpp"
+
+namespace wotmin2d {
+
+ChangeLog::Change::Change(Type type, const IntVector& position,
+                          Direction direction, unsigned int health) :
+    type(type),
+    position(position),
+    direction(direction),
+    health(health) {}
+
+ChangeLog::Change ChangeLog::Change::move(const IntVector& from,
+                                          Direction direction) {
+    return Change(Type::move, from, direction, 0);
+}
+
+ChangeLog::Change ChangeLog::Change::damage(const IntVector& position,
+                                            unsigned int health) {
+    return Change(Type::damage, position, Direction::north(), health);
+}
+
+ChangeLog::Change ChangeLog::Change::death(const IntVector& position) {
+    return Change(Type::death, position, Direction::north(), 0);
+}
+
+bool ChangeLog::Change::operator==(const Change& other) const {
+    return type == other.type && position == other.position
+           && direction == other.direction && health == other.health;
+}
+
+bool ChangeLog::Change::operator!=(const Change& other) const {
+    return !(*this == other);
+}
+
+ChangeLog::Change::Type ChangeLog::Change::getType() const {
+    return type;
+}
+
+const IntVector& ChangeLog::Change::getPosition() const {
+    return position;
+}
+
+Direction ChangeLog::Change::getDirection() const {
+    return direction;
+}
+
+unsigned int ChangeLog::Change::getHealth() const {
+    return health;
+}
+
+ChangeLog::ChangeLog() :
+    enabled(false),
+    complete(false),
+    changes() {}
+
+bool ChangeLog::isEnabled() const {
+    return enabled;
+}
+
+// Turning logging on in the middle of a tick misses what happened before, so
+// the log is incomplete until the next tick.
+void ChangeLog::setEnabled(bool enabled) {
+    if (enabled && !this->enabled) {
+        invalidate();
+    }
+    this->enabled = enabled;
+    if (!enabled) {
+        invalidate();
+    }
+}
+
+// Returns whether logging was on since the start of the current tick and
+// nothing happened to the blob that wasn't logged.
+bool ChangeLog::isComplete() const {
+    return enabled && complete;
+}
+
+// Adds the change if logging is enabled.
+void ChangeLog::add(const Change& change) {
+    if (enabled) {
+        changes.push_back(change);
+    }
+}
+
+// Forgets all changes but keeps the memory for the next tick, which starts
+// with a complete log.
+void ChangeLog::clear() {
+    changes.clear();
+    complete = true;
+}
+
+// Forgets all changes and marks the log incomplete until the next clear(),
+// for when the blob changed in a way that isn't logged.
+void ChangeLog::invalidate() {
+    changes.clear();
+    complete = false;
+}
+
+const std::vector<ChangeLog::Change>& ChangeLog::getChanges() const {
+    return changes;
+}
+
+std::size_t ChangeLog::getMemoryUsage() const {
+    return changes.capacity() * sizeof(Change);
+}
+
+}
@@ -0,0 +1,63 @@
+#ifndef CHANGELOG_HPP
+#define CHANGELOG_HPP
+
+#include "Vector.hpp"
+#include "Direction.hpp"
+
+#include <vector>
+#include <cstddef>
+
+namespace wotmin2d {
+
+/**
+ * The visible changes to the particles of a blob during one tick, in the order
+ * they happened: moves by one cell, damage that left a particle alive, and
+ * deaths. Particles are identified by their position at the time of the
+ * change, which is unique within a blob.
+ *
+ * Logging is off by default, so blobs that nobody watches don't pay for it.
+ * A log is only complete once a tick started while it was on. Changes that
+ * aren't logged one by one (like restoring a snapshot) make it incomplete
+ * until the next tick starts, so whoever follows the log knows to look at the
+ * whole blob instead.
+ */
+class ChangeLog {
+    public:
+    class Change {
+        public:
+        enum class Type : unsigned char { move = 0, damage = 1, death = 2 };
+        static Change move(const IntVector& from, Direction direction);
+        static Change damage(const IntVector& position, unsigned int health);
+        static Change death(const IntVector& position);
+        bool operator==(const Change& other) const;
+        bool operator!=(const Change& other) const;
+        Type getType() const;
+        const IntVector& getPosition() const;
+        Direction getDirection() const;
+        unsigned int getHealth() const;
+        private:
+        Change(Type type, const IntVector& position, Direction direction,
+               unsigned int health);
+        Type type;
+        IntVector position;
+        Direction direction;
+        unsigned int health;
+    };
+    ChangeLog();
+    bool isEnabled() const;
+    void setEnabled(bool enabled);
+    bool isComplete() const;
+    void add(const Change& change);
+    void clear();
+    void invalidate();
+    const std::vector<Change>& getChanges() const;
+    std::size_t getMemoryUsage() const;
+    private:
+    bool enabled;
+    bool complete;
+    std::vector<Change> changes;
+};
+
+}
+
+#endif
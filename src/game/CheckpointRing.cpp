@@ -0,0 +1,82 @@
+#include "CheckpointRing.hpp"
+
+namespace wotmin2d {
+
+// Keeps the last capacity checkpoints, one taken every interval ticks.
+CheckpointRing::CheckpointRing(std::size_t capacity, std::uint64_t interval) :
+    checkpoints(capacity),
+    interval(interval),
+    begin(0),
+    size(0) {
+    assert(capacity > 0 && interval > 0);
+}
+
+bool CheckpointRing::isDue(std::uint64_t tick) const {
+    return tick % interval == 0;
+}
+
+// Returns the most recent checkpoint at or before the given tick, or nullptr if
+// there is none.
+const StateSnapshot* CheckpointRing::find(std::uint64_t tick) const {
+    std::size_t index = findIndex(tick);
+    return index == size ? nullptr : &at(index).second;
+}
+
+std::size_t CheckpointRing::getSize() const {
+    return size;
+}
+
+std::size_t CheckpointRing::getCapacity() const {
+    return checkpoints.size();
+}
+
+std::uint64_t CheckpointRing::getInterval() const {
+    return interval;
+}
+
+std::uint64_t CheckpointRing::getOldestTick() const {
+    assert(size > 0);
+    return at(0).first;
+}
+
+std::uint64_t CheckpointRing::getNewestTick() const {
+    assert(size > 0);
+    return at(size - 1).first;
+}
+
+// Drops all checkpoints. Their snapshots keep their memory for the next ones.
+void CheckpointRing::clear() {
+    begin = 0;
+    size = 0;
+}
+
+std::size_t CheckpointRing::getMemoryUsage() const {
+    std::size_t usage = checkpoints.capacity() * sizeof(Checkpoint);
+    for (const Checkpoint& checkpoint: checkpoints) {
+        for (const auto& id_blob: checkpoint.second.getBlobs()) {
+            usage += id_blob.second.getParticles().capacity()
+                         * sizeof(ParticleRecord)
+                     + id_blob.second.getFollowers().capacity()
+                         * sizeof(std::uint32_t);
+        }
+    }
+    return usage;
+}
+
+// Returns the index (counted from the oldest checkpoint) of the most recent
+// checkpoint at or before the given tick, or size if there is none. The ring
+// is small, so a linear search from the newest one is fine.
+std::size_t CheckpointRing::findIndex(std::uint64_t tick) const {
+    for (std::size_t i = size; i > 0; i--) {
+        if (at(i - 1).first <= tick) {
+            return i - 1;
+        }
+    }
+    return size;
+}
+
+const CheckpointRing::Checkpoint& CheckpointRing::at(std::size_t index) const {
+    return checkpoints[(begin + index) % checkpoints.size()];
+}
+
+}
@@ -0,0 +1,56 @@
+#ifndef CHECKPOINTRING_HPP
+#define CHECKPOINTRING_HPP
+
+#include "Snapshot.hpp"
+
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+namespace wotmin2d {
+
+/**
+ * Snapshots of a running state taken every few ticks, of which only the most
+ * recent ones are kept, so that the simulation can be rewound to any of them.
+ *
+ * The ring has a fixed number of slots. Taking a checkpoint overwrites the
+ * snapshot in the oldest slot, so once the ring is full, checkpoints don't
+ * allocate unless the blobs grow. Snapshots are flat arrays of particle
+ * records. Restoring one is a sequential pass over them that rebuilds the
+ * particle indices of each blob without allocating, which is linear in the
+ * number of particles (see BlobState::restore()).
+ */
+class CheckpointRing {
+    public:
+    CheckpointRing(std::size_t capacity, std::uint64_t interval);
+    bool isDue(std::uint64_t tick) const;
+    template<class S>
+    void save(std::uint64_t tick, const S& state);
+    template<class S>
+    bool rewind(std::uint64_t& tick, S& state);
+    const StateSnapshot* find(std::uint64_t tick) const;
+    std::size_t getSize() const;
+    std::size_t getCapacity() const;
+    std::uint64_t getInterval() const;
+    std::uint64_t getOldestTick() const;
+    std::uint64_t getNewestTick() const;
+    void clear();
+    std::size_t getMemoryUsage() const;
+    private:
+    using Checkpoint = std::pair<std::uint64_t, StateSnapshot>;
+    std::size_t findIndex(std::uint64_t tick) const;
+    const Checkpoint& at(std::size_t index) const;
+    std::vector<Checkpoint> checkpoints;
+    std::uint64_t interval;
+    // Slot of the oldest checkpoint.
+    std::size_t begin;
+    std::size_t size;
+};
+
+}
+
+#include "CheckpointRing.tpp"
+
+#endif
@@ -0,0 +1,38 @@
+namespace wotmin2d {
+
+// Takes a checkpoint of the state, which must be later than all checkpoints
+// in the ring. If the ring is full, the oldest one is dropped.
+template<class S>
+void CheckpointRing::save(std::uint64_t tick, const S& state) {
+    assert((size == 0 || tick > getNewestTick())
+           && "Checkpoints must be taken in order.");
+    Checkpoint* slot;
+    if (size < checkpoints.size()) {
+        slot = &checkpoints[(begin + size) % checkpoints.size()];
+        size++;
+    } else {
+        slot = &checkpoints[begin];
+        begin = (begin + 1) % checkpoints.size();
+    }
+    slot->first = tick;
+    state.snapshot(slot->second);
+}
+
+// Restores the most recent checkpoint at or before the given tick and sets the
+// tick to the one of the checkpoint. Checkpoints after it are dropped, since
+// the simulation continues from there on. Returns false, without changing
+// anything, if there is no such checkpoint.
+template<class S>
+bool CheckpointRing::rewind(std::uint64_t& tick, S& state) {
+    std::size_t index = findIndex(tick);
+    if (index == size) {
+        return false;
+    }
+    const Checkpoint& checkpoint = at(index);
+    state.restore(checkpoint.second);
+    tick = checkpoint.first;
+    size = index + 1;
+    return true;
+}
+
+}
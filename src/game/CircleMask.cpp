@@ -0,0 +1,110 @@
+#include "CircleMask.hpp"
+
+namespace wotmin2d {
+
+CircleMask::CircleMask() :
+    CircleMask(-1.0f) {}
+
+CircleMask::CircleMask(float radius) :
+    radius(radius),
+    extent(-1),
+    half_widths(),
+    outline() {
+    build();
+}
+
+// Rebuilds the mask for the radius unless it already has it. Returns whether
+// it was rebuilt.
+bool CircleMask::update(float radius) {
+    if (radius == this->radius) {
+        return false;
+    }
+    this->radius = radius;
+    build();
+    return true;
+}
+
+float CircleMask::getRadius() const {
+    return radius;
+}
+
+bool CircleMask::empty() const {
+    return extent < 0;
+}
+
+// Returns the radius rounded down, i.e. how far the mask reaches from the
+// center along the axes, or -1 if it's empty.
+int CircleMask::getExtent() const {
+    return extent;
+}
+
+// Returns the largest x that is inside in the row, which must be within the
+// extent.
+int CircleMask::getHalfWidth(int row) const {
+    assert(row >= -extent && row <= extent && "Row outside of the mask.");
+    return half_widths[static_cast<std::size_t>(row < 0 ? -row : row)];
+}
+
+const std::vector<IntVector>& CircleMask::getOutline() const {
+    return outline;
+}
+
+bool CircleMask::contains(const IntVector& offset) const {
+    if (offset.getY() < -extent || offset.getY() > extent) {
+        return false;
+    }
+    int half_width = getHalfWidth(offset.getY());
+    return offset.getX() >= -half_width && offset.getX() <= half_width;
+}
+
+std::size_t CircleMask::count() const {
+    std::size_t cells = 0;
+    for (int row = -extent; row <= extent; row++) {
+        cells += 2 * static_cast<std::size_t>(getHalfWidth(row)) + 1;
+    }
+    return cells;
+}
+
+void CircleMask::build() {
+    half_widths.clear();
+    outline.clear();
+    if (radius < 0.0f) {
+        extent = -1;
+        return;
+    }
+    extent = static_cast<int>(radius);
+    int squared_radius = static_cast<int>(radius * radius);
+    // Rows get narrower away from the center, so each one starts looking
+    // where the last one ended.
+    int half_width = extent;
+    for (int row = 0; row <= extent; row++) {
+        while (IntVector(half_width, row).squaredNorm() > squared_radius) {
+            half_width--;
+        }
+        half_widths.push_back(half_width);
+    }
+    // Walk along the border in the first quadrant, from the top clockwise,
+    // and mirror it into the others.
+    int x = 0;
+    int y = extent;
+    while (y >= 0) {
+        assert(IntVector(x, y).squaredNorm() <= squared_radius);
+        outline.emplace_back(x, y);
+        if (y != 0) {
+            outline.emplace_back(x, -y);
+        }
+        if (x != 0) {
+            outline.emplace_back(-x, y);
+            if (y != 0) {
+                outline.emplace_back(-x, -y);
+            }
+        }
+        if (IntVector(x + 1, y).squaredNorm() <= squared_radius) {
+            x++;
+        } else {
+            y--;
+        }
+    }
+}
+
+}
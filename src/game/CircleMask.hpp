@@ -0,0 +1,46 @@
+#ifndef CIRCLEMASK_HPP
+#define CIRCLEMASK_HPP
+
+#include "Vector.hpp"
+
+#include <vector>
+#include <cstddef>
+#include <cassert>
+
+namespace wotmin2d {
+
+/**
+ * The cells within a radius of a center, as offsets from it: an offset (x, y)
+ * is inside if x^2 + y^2 <= radius^2, rounded down to an integer. Each row y
+ * of the circle is the span of offsets from -getHalfWidth(y) to
+ * getHalfWidth(y), and the outline is the cells on its border, the way the
+ * selection circle is drawn.
+ *
+ * The geometry only depends on the radius, so whoever queries or draws the
+ * same circle over and over keeps a mask and rebuilds it when the radius
+ * changes (see update()). A negative radius makes an empty mask.
+ */
+class CircleMask {
+    public:
+    CircleMask();
+    explicit CircleMask(float radius);
+    bool update(float radius);
+    float getRadius() const;
+    bool empty() const;
+    int getExtent() const;
+    int getHalfWidth(int row) const;
+    const std::vector<IntVector>& getOutline() const;
+    bool contains(const IntVector& offset) const;
+    std::size_t count() const;
+    private:
+    void build();
+    float radius;
+    int extent;
+    // For rows 0 to extent, the ones below the center are the same.
+    std::vector<int> half_widths;
+    std::vector<IntVector> outline;
+};
+
+}
+
+#endif
@@ -0,0 +1,50 @@
+#include "Command.hpp"
+
+namespace wotmin2d {
+
+Command::Command(Type type, PlayerId player_id, const IntVector& position,
+                 float difference) :
+    type(type),
+    player_id(player_id),
+    position(position),
+    difference(difference) {}
+
+Command Command::selectParticles(const IntVector& center) {
+    return Command(Type::select_particles, 0, center, 0.0f);
+}
+
+Command Command::setTarget(PlayerId player_id, const IntVector& target) {
+    return Command(Type::set_target, player_id, target, 0.0f);
+}
+
+Command Command::changeSelectionRadius(float difference) {
+    return Command(Type::change_selection_radius, 0, IntVector(0, 0),
+                   difference);
+}
+
+bool Command::operator==(const Command& other) const {
+    return type == other.type && player_id == other.player_id
+           && position == other.position && difference == other.difference;
+}
+
+bool Command::operator!=(const Command& other) const {
+    return !(*this == other);
+}
+
+Command::Type Command::getType() const {
+    return type;
+}
+
+Command::PlayerId Command::getPlayerId() const {
+    return player_id;
+}
+
+const IntVector& Command::getPosition() const {
+    return position;
+}
+
+float Command::getDifference() const {
+    return difference;
+}
+
+}
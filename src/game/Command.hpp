@@ -0,0 +1,40 @@
+#ifndef COMMAND_HPP
+#define COMMAND_HPP
+
+#include "Vector.hpp"
+
+#include <cstdint>
+
+namespace wotmin2d {
+
+/**
+ * A change to the state requested by a player, in arena coordinates. Unlike
+ * input actions, commands are plain values that can be recorded and executed
+ * again later (see State::execute()).
+ */
+class Command {
+    public:
+    using PlayerId = std::uint8_t;
+    enum class Type : std::uint8_t { select_particles = 0, set_target = 1,
+                                     change_selection_radius = 2 };
+    static Command selectParticles(const IntVector& center);
+    static Command setTarget(PlayerId player_id, const IntVector& target);
+    static Command changeSelectionRadius(float difference);
+    bool operator==(const Command& other) const;
+    bool operator!=(const Command& other) const;
+    Type getType() const;
+    PlayerId getPlayerId() const;
+    const IntVector& getPosition() const;
+    float getDifference() const;
+    private:
+    Command(Type type, PlayerId player_id, const IntVector& position,
+            float difference);
+    Type type;
+    PlayerId player_id;
+    IntVector position;
+    float difference;
+};
+
+}
+
+#endif
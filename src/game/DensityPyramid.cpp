@@ -0,0 +1,186 @@
+#include "DensityPyramid.hpp"
+
+namespace wotmin2d {
+
+constexpr unsigned int DensityPyramid::levels;
+constexpr unsigned int DensityPyramid::byte_levels;
+constexpr unsigned int DensityPyramid::short_levels;
+
+namespace {
+
+template<class T>
+void resetCounts(std::vector<T>& counts, std::size_t size) {
+    counts.assign(size, 0);
+    if (size == 0) {
+        counts.shrink_to_fit();
+    }
+}
+
+}
+
+DensityPyramid::DensityPyramid() :
+    arena_width(0),
+    arena_height(0),
+    offsets(),
+    byte_counts(),
+    short_counts(),
+    long_counts() {}
+
+// Makes the pyramid cover an arena of the given size, with all counts zero. An
+// empty arena turns counting off.
+void DensityPyramid::reset(unsigned int arena_width,
+                           unsigned int arena_height) {
+    this->arena_width = arena_width;
+    this->arena_height = arena_height;
+    std::array<std::size_t, 3> sizes = {{ 0, 0, 0 }};
+    for (unsigned int level = 1; level <= levels; level++) {
+        std::size_t& size = sizes[level <= byte_levels ? 0
+                                  : level <= short_levels ? 1 : 2];
+        offsets[level - 1] = size;
+        if (isEnabled()) {
+            size += static_cast<std::size_t>(getColumns(level))
+                    * getRows(level);
+        }
+    }
+    resetCounts(byte_counts, sizes[0]);
+    resetCounts(short_counts, sizes[1]);
+    resetCounts(long_counts, sizes[2]);
+}
+
+bool DensityPyramid::isEnabled() const {
+    return arena_width > 0 && arena_height > 0;
+}
+
+void DensityPyramid::add(const IntVector& cell) {
+    if (!isEnabled()) {
+        return;
+    }
+    for (unsigned int level = 1; level <= levels; level++) {
+        change(level, getIndex(level, cell), 1);
+    }
+}
+
+void DensityPyramid::remove(const IntVector& cell) {
+    if (!isEnabled()) {
+        return;
+    }
+    for (unsigned int level = 1; level <= levels; level++) {
+        std::size_t index = getIndex(level, cell);
+        assert(getCountAt(level, index) > 0
+               && "Removing a particle that wasn't counted.");
+        change(level, index, -1);
+    }
+}
+
+// Once both cells are in the same block, they're in the same block at all
+// higher levels as well.
+void DensityPyramid::move(const IntVector& from, const IntVector& to) {
+    if (!isEnabled()) {
+        return;
+    }
+    for (unsigned int level = 1; level <= levels; level++) {
+        std::size_t from_index = getIndex(level, from);
+        std::size_t to_index = getIndex(level, to);
+        if (from_index == to_index) {
+            return;
+        }
+        assert(getCountAt(level, from_index) > 0
+               && "Moving a particle that wasn't counted.");
+        change(level, from_index, -1);
+        change(level, to_index, 1);
+    }
+}
+
+// Sets all counts to zero, for when all particles are gone.
+void DensityPyramid::clear() {
+    std::fill(byte_counts.begin(), byte_counts.end(), 0);
+    std::fill(short_counts.begin(), short_counts.end(), 0);
+    std::fill(long_counts.begin(), long_counts.end(), 0);
+}
+
+unsigned int DensityPyramid::getArenaWidth() const {
+    return arena_width;
+}
+
+unsigned int DensityPyramid::getArenaHeight() const {
+    return arena_height;
+}
+
+unsigned int DensityPyramid::getColumns(unsigned int level) const {
+    assert(level >= 1 && level <= levels);
+    return (arena_width + (1u << level) - 1) >> level;
+}
+
+unsigned int DensityPyramid::getRows(unsigned int level) const {
+    assert(level >= 1 && level <= levels);
+    return (arena_height + (1u << level) - 1) >> level;
+}
+
+// Returns the number of particles in the block at the given column and row of
+// blocks of the level.
+std::uint32_t DensityPyramid::getCount(unsigned int level, unsigned int column,
+                                       unsigned int row) const {
+    assert(isEnabled());
+    assert(column < getColumns(level) && row < getRows(level));
+    return getCountAt(level, offsets[level - 1]
+                             + static_cast<std::size_t>(row)
+                               * getColumns(level)
+                             + column);
+}
+
+// Returns the number of cells of the block that are inside the arena, i.e. how
+// many particles it can hold.
+unsigned int DensityPyramid::getArea(unsigned int level, unsigned int column,
+                                     unsigned int row) const {
+    assert(column < getColumns(level) && row < getRows(level));
+    unsigned int size = 1u << level;
+    unsigned int width = std::min(size, arena_width - column * size);
+    unsigned int height = std::min(size, arena_height - row * size);
+    return width * height;
+}
+
+std::size_t DensityPyramid::getMemoryUsage() const {
+    return byte_counts.capacity() * sizeof(std::uint8_t)
+           + short_counts.capacity() * sizeof(std::uint16_t)
+           + long_counts.capacity() * sizeof(std::uint32_t);
+}
+
+std::size_t DensityPyramid::getIndex(unsigned int level,
+                                     const IntVector& cell) const {
+    assert(cell.getX() >= 0 && cell.getY() >= 0
+           && static_cast<unsigned int>(cell.getX()) < arena_width
+           && static_cast<unsigned int>(cell.getY()) < arena_height
+           && "Cell outside the arena.");
+    unsigned int column = static_cast<unsigned int>(cell.getX()) >> level;
+    unsigned int row = static_cast<unsigned int>(cell.getY()) >> level;
+    return offsets[level - 1]
+           + static_cast<std::size_t>(row) * getColumns(level) + column;
+}
+
+std::uint32_t DensityPyramid::getCountAt(unsigned int level,
+                                         std::size_t index) const {
+    if (level <= byte_levels) {
+        return byte_counts[index];
+    } else if (level <= short_levels) {
+        return short_counts[index];
+    }
+    return long_counts[index];
+}
+
+// Adds delta to a count. Counts can't overflow their width, since they never
+// exceed the area of their block.
+void DensityPyramid::change(unsigned int level, std::size_t index,
+                            int delta) {
+    if (level <= byte_levels) {
+        byte_counts[index] = static_cast<std::uint8_t>(byte_counts[index]
+                                                       + delta);
+    } else if (level <= short_levels) {
+        short_counts[index] = static_cast<std::uint16_t>(short_counts[index]
+                                                         + delta);
+    } else {
+        long_counts[index] = static_cast<std::uint32_t>(long_counts[index]
+                                                        + delta);
+    }
+}
+
+}
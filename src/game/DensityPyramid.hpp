@@ -0,0 +1,72 @@
+#ifndef DENSITYPYRAMID_HPP
+#define DENSITYPYRAMID_HPP
+
+#include "Vector.hpp"
+
+#include <vector>
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+#include <algorithm>
+
+namespace wotmin2d {
+
+/**
+ * How many particles of a blob there are in square blocks of the arena, at
+ * several resolutions: level k counts the particles in blocks of 2^k by 2^k
+ * cells, for k from 1 to levels. Blocks start at the origin, so those at the
+ * right and top edges may stick out of the arena.
+ *
+ * The counts are kept up to date as particles are added, move and die. A move
+ * only changes the levels at which the particle crosses a block border, which
+ * for most moves is none or only the first few. Whoever draws the whole arena
+ * can then read one count per block instead of looking at every particle.
+ *
+ * A block of level k holds at most 4^k particles, so the counts of the low
+ * levels, which have by far the most blocks, are narrow: 8 bits up to
+ * byte_levels, 16 bits up to short_levels and 32 bits above. All levels
+ * together take about a third of a byte per arena cell.
+ *
+ * Counting is off (and takes no memory) until the pyramid is given the size of
+ * an arena.
+ */
+class DensityPyramid {
+    public:
+    constexpr static unsigned int levels = 8;
+    constexpr static unsigned int byte_levels = 3;
+    constexpr static unsigned int short_levels = 7;
+    DensityPyramid();
+    void reset(unsigned int arena_width, unsigned int arena_height);
+    bool isEnabled() const;
+    void add(const IntVector& cell);
+    void remove(const IntVector& cell);
+    void move(const IntVector& from, const IntVector& to);
+    void clear();
+    unsigned int getArenaWidth() const;
+    unsigned int getArenaHeight() const;
+    unsigned int getColumns(unsigned int level) const;
+    unsigned int getRows(unsigned int level) const;
+    std::uint32_t getCount(unsigned int level, unsigned int column,
+                           unsigned int row) const;
+    unsigned int getArea(unsigned int level, unsigned int column,
+                         unsigned int row) const;
+    std::size_t getMemoryUsage() const;
+    private:
+    std::size_t getIndex(unsigned int level, const IntVector& cell) const;
+    std::uint32_t getCountAt(unsigned int level, std::size_t index) const;
+    void change(unsigned int level, std::size_t index, int delta);
+    unsigned int arena_width;
+    unsigned int arena_height;
+    // The blocks of the levels with counts of the same width, row by row
+    // starting at the bottom, lowest level first. Level k starts at
+    // offsets[k - 1] of its array.
+    std::array<std::size_t, levels> offsets;
+    std::vector<std::uint8_t> byte_counts;
+    std::vector<std::uint16_t> short_counts;
+    std::vector<std::uint32_t> long_counts;
+};
+
+}
+
+#endif
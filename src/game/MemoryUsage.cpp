@@ -0,0 +1,87 @@
+#include "MemoryUsage.hpp"
+
+namespace wotmin2d {
+
+MemoryUsage::MemoryUsage() :
+    particle_count(0),
+    particle_bytes(0),
+    relation_bytes(0),
+    particle_set_bytes(0),
+    particle_map_bytes(0) {}
+
+MemoryUsage::MemoryUsage(std::size_t particle_count,
+                         std::size_t particle_bytes,
+                         std::size_t relation_bytes,
+                         std::size_t particle_set_bytes,
+                         std::size_t particle_map_bytes) :
+    particle_count(particle_count),
+    particle_bytes(particle_bytes),
+    relation_bytes(relation_bytes),
+    particle_set_bytes(particle_set_bytes),
+    particle_map_bytes(particle_map_bytes) {}
+
+MemoryUsage& MemoryUsage::operator+=(const MemoryUsage& other) {
+    particle_count += other.particle_count;
+    particle_bytes += other.particle_bytes;
+    relation_bytes += other.relation_bytes;
+    particle_set_bytes += other.particle_set_bytes;
+    particle_map_bytes += other.particle_map_bytes;
+    return *this;
+}
+
+std::size_t MemoryUsage::getParticleCount() const {
+    return particle_count;
+}
+
+std::size_t MemoryUsage::getParticleBytes() const {
+    return particle_bytes;
+}
+
+std::size_t MemoryUsage::getRelationBytes() const {
+    return relation_bytes;
+}
+
+std::size_t MemoryUsage::getParticleSetBytes() const {
+    return particle_set_bytes;
+}
+
+std::size_t MemoryUsage::getParticleMapBytes() const {
+    return particle_map_bytes;
+}
+
+std::size_t MemoryUsage::getTotalBytes() const {
+    return particle_bytes + relation_bytes + particle_set_bytes
+           + particle_map_bytes;
+}
+
+float MemoryUsage::getBytesPerParticle() const {
+    if (particle_count == 0) {
+        return 0.0f;
+    }
+    return static_cast<float>(getTotalBytes())
+           / static_cast<float>(particle_count);
+}
+
+// Estimates how much memory the allocator actually uses for a request of the
+// given size. Modeled after glibc's malloc: a size_t header per chunk, chunks
+// aligned to two size_ts and a minimum chunk size of four size_ts.
+std::size_t MemoryUsage::allocationSize(std::size_t requested) {
+    const std::size_t header = sizeof(std::size_t);
+    const std::size_t alignment = 2 * sizeof(std::size_t);
+    const std::size_t min_size = 4 * sizeof(std::size_t);
+    std::size_t size = (requested + header + alignment - 1)
+                       & ~(alignment - 1);
+    return size < min_size ? min_size : size;
+}
+
+std::ostream& operator<<(std::ostream& stream, const MemoryUsage& usage) {
+    return stream << usage.getParticleCount() << " particles, "
+                  << usage.getTotalBytes() << " bytes ("
+                  << usage.getBytesPerParticle() << " per particle; particles "
+                  << usage.getParticleBytes() << ", relations "
+                  << usage.getRelationBytes() << ", particle set "
+                  << usage.getParticleSetBytes() << ", particle map "
+                  << usage.getParticleMapBytes() << ")";
+}
+
+}
@@ -0,0 +1,66 @@
+#ifndef MEMORYUSAGE_HPP
+#define MEMORYUSAGE_HPP
+
+#include <cstddef>
+#include <ostream>
+
+namespace wotmin2d {
+
+/**
+ * Estimated heap memory used by the particles of a blob, broken down by the
+ * structure holding it. The numbers are estimates derived from container sizes
+ * and bucket counts (assuming a libstdc++/glibc-like layout), not measurements,
+ * but they're good enough to compare bytes per particle between versions.
+ */
+class MemoryUsage {
+    public:
+    MemoryUsage();
+    MemoryUsage(std::size_t particle_count, std::size_t particle_bytes,
+                std::size_t relation_bytes, std::size_t particle_set_bytes,
+                std::size_t particle_map_bytes);
+    MemoryUsage& operator+=(const MemoryUsage& other);
+    std::size_t getParticleCount() const;
+    std::size_t getParticleBytes() const;
+    std::size_t getRelationBytes() const;
+    std::size_t getParticleSetBytes() const;
+    std::size_t getParticleMapBytes() const;
+    std::size_t getTotalBytes() const;
+    float getBytesPerParticle() const;
+    static std::size_t allocationSize(std::size_t requested);
+    template<class C>
+    static std::size_t hashContainerSize(const C& container,
+                                         std::size_t node_size);
+    template<class C>
+    static std::size_t bucketArraySize(const C& container);
+    private:
+    std::size_t particle_count;
+    std::size_t particle_bytes;
+    std::size_t relation_bytes;
+    std::size_t particle_set_bytes;
+    std::size_t particle_map_bytes;
+};
+
+std::ostream& operator<<(std::ostream& stream, const MemoryUsage& usage);
+
+// Estimates the size of a node based hash container with the given size of a
+// node. An empty container with a single bucket is assumed not to allocate.
+template<class C>
+std::size_t MemoryUsage::hashContainerSize(const C& container,
+                                           std::size_t node_size) {
+    return bucketArraySize(container)
+           + container.size() * allocationSize(node_size);
+}
+
+// Estimates the size of the bucket array of a hash container alone, for
+// containers whose nodes are accounted for elsewhere.
+template<class C>
+std::size_t MemoryUsage::bucketArraySize(const C& container) {
+    if (container.bucket_count() <= 1) {
+        return 0;
+    }
+    return allocationSize(container.bucket_count() * sizeof(void*));
+}
+
+}
+
+#endif
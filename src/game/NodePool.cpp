@@ -0,0 +1,75 @@
+#include "NodePool.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace wotmin2d {
+
+constexpr std::size_t NodePool::min_chunk_size;
+
+NodePool::NodePool() :
+    chunks(),
+    size_classes(),
+    capacity(0) {}
+
+void* NodePool::allocate(std::size_t size) {
+    SizeClass& size_class = getSizeClass(size);
+    if (size_class.free_nodes != nullptr) {
+        FreeNode* node = size_class.free_nodes;
+        size_class.free_nodes = node->next;
+        return node;
+    }
+    if (size_class.next_node == size_class.chunk_end) {
+        addChunk(size_class);
+    }
+    void* node = size_class.next_node;
+    size_class.next_node += size_class.size;
+    return node;
+}
+
+void NodePool::deallocate(void* node, std::size_t size) {
+    assert(node != nullptr);
+    SizeClass& size_class = getSizeClass(size);
+    FreeNode* free_node = static_cast<FreeNode*>(node);
+    free_node->next = size_class.free_nodes;
+    size_class.free_nodes = free_node;
+}
+
+std::size_t NodePool::getCapacity() const {
+    return capacity;
+}
+
+std::size_t NodePool::getMemoryUsage() const {
+    return capacity + size_classes.capacity() * sizeof(SizeClass)
+           + chunks.capacity() * sizeof(chunks[0]);
+}
+
+// Containers allocate nodes of only one or two sizes, so a linear search is
+// fast enough. Nodes at least hold the link of the free list, and since chunks
+// are aligned for any type and a node's size is a multiple of its alignment,
+// every node in a chunk is aligned as well.
+NodePool::SizeClass& NodePool::getSizeClass(std::size_t size) {
+    size = std::max(size, sizeof(FreeNode));
+    for (SizeClass& size_class: size_classes) {
+        if (size_class.size == size) {
+            return size_class;
+        }
+    }
+    size_classes.push_back({size, nullptr, nullptr, nullptr, 0});
+    return size_classes.back();
+}
+
+void NodePool::addChunk(SizeClass& size_class) {
+    // Grow geometrically so the number of chunks stays small.
+    std::size_t nodes = std::max(min_chunk_size, size_class.capacity);
+    std::size_t bytes = nodes * size_class.size;
+    std::size_t units = (bytes + sizeof(std::max_align_t) - 1)
+                        / sizeof(std::max_align_t);
+    chunks.emplace_back(new std::max_align_t[units]);
+    size_class.next_node = reinterpret_cast<char*>(chunks.back().get());
+    size_class.chunk_end = size_class.next_node + bytes;
+    size_class.capacity += nodes;
+    capacity += units * sizeof(std::max_align_t);
+}
+
+}
@@ -0,0 +1,81 @@
+#ifndef NODEPOOL_HPP
+#define NODEPOOL_HPP
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+namespace wotmin2d {
+
+/**
+ * Storage for the nodes of node based containers. Nodes are carved from
+ * chunks of contiguous memory, one list of free nodes per node size, and the
+ * nodes a container releases are handed out again instead of being freed.
+ * Chunks are only freed when the pool is destroyed, so a container that is
+ * cleared and refilled to a similar size doesn't allocate.
+ *
+ * Only single objects come from the pool. Arrays (like the bucket arrays of
+ * hash containers) are allocated normally.
+ */
+class NodePool {
+    public:
+    NodePool();
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+    void* allocate(std::size_t size);
+    void deallocate(void* node, std::size_t size);
+    std::size_t getCapacity() const;
+    std::size_t getMemoryUsage() const;
+    private:
+    struct FreeNode {
+        FreeNode* next;
+    };
+    struct SizeClass {
+        std::size_t size;
+        FreeNode* free_nodes;
+        char* next_node;
+        char* chunk_end;
+        std::size_t capacity;
+    };
+    SizeClass& getSizeClass(std::size_t size);
+    void addChunk(SizeClass& size_class);
+    constexpr static std::size_t min_chunk_size = 256;
+    std::vector<std::unique_ptr<std::max_align_t[]>> chunks;
+    std::vector<SizeClass> size_classes;
+    std::size_t capacity;
+};
+
+/**
+ * A standard allocator taking single objects from a NodePool. Rebound copies
+ * share the pool. A default constructed allocator has no pool and allocates
+ * normally, so containers using it can still be created without one.
+ */
+template<class T>
+class NodeAllocator {
+    public:
+    using value_type = T;
+    template<class U>
+    struct rebind {
+        using other = NodeAllocator<U>;
+    };
+    NodeAllocator();
+    explicit NodeAllocator(NodePool& pool);
+    template<class U>
+    NodeAllocator(const NodeAllocator<U>& other);
+    T* allocate(std::size_t count);
+    void deallocate(T* pointer, std::size_t count);
+    NodePool* getPool() const;
+    private:
+    NodePool* pool;
+};
+
+template<class T, class U>
+bool operator==(const NodeAllocator<T>& first, const NodeAllocator<U>& second);
+template<class T, class U>
+bool operator!=(const NodeAllocator<T>& first, const NodeAllocator<U>& second);
+
+}
+
+#include "NodePool.tpp"
+
+#endif
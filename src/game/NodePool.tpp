@@ -0,0 +1,50 @@
+namespace wotmin2d {
+
+template<class T>
+NodeAllocator<T>::NodeAllocator() :
+    pool(nullptr) {}
+
+template<class T>
+NodeAllocator<T>::NodeAllocator(NodePool& pool) :
+    pool(&pool) {}
+
+template<class T>
+template<class U>
+NodeAllocator<T>::NodeAllocator(const NodeAllocator<U>& other) :
+    pool(other.getPool()) {}
+
+template<class T>
+T* NodeAllocator<T>::allocate(std::size_t count) {
+    if (pool == nullptr || count != 1) {
+        return static_cast<T*>(::operator new(count * sizeof(T)));
+    }
+    return static_cast<T*>(pool->allocate(sizeof(T)));
+}
+
+template<class T>
+void NodeAllocator<T>::deallocate(T* pointer, std::size_t count) {
+    if (pool == nullptr || count != 1) {
+        ::operator delete(pointer);
+    } else {
+        pool->deallocate(pointer, sizeof(T));
+    }
+}
+
+template<class T>
+NodePool* NodeAllocator<T>::getPool() const {
+    return pool;
+}
+
+template<class T, class U>
+bool operator==(const NodeAllocator<T>& first,
+                const NodeAllocator<U>& second) {
+    return first.getPool() == second.getPool();
+}
+
+template<class T, class U>
+bool operator!=(const NodeAllocator<T>& first,
+                const NodeAllocator<U>& second) {
+    return !(first == second);
+}
+
+}
@@ -29,12 +29,28 @@ class ParticleTest;
 class BlobStateTest;
 }
 
-class Particle {
+/**
+ * A cell of a blob. All tunable constants of the simulation come from the
+ * config policy C, a class with the same static members as Config. BlobState,
+ * Blob and State take the config of their particle type, so a simulation with
+ * different constants is just a different particle type, e.g.
+ *
+ *     struct HeavyDamage : Config {
+ *         constexpr static int particle_damage = 30;
+ *     };
+ *     State<BasicParticle<HeavyDamage>> state(100, 100);
+ *
+ * and can run in the same program as the default one.
+ */
+template<class C = Config>
+class BasicParticle {
+    public:
+    using Config = C;
     private:
     class BlobStateKey {
         template<class P> friend class BlobState;
         friend class wotmin2d::mock::MockParticle;
-        friend class wotmin2d::test::TestData<Particle>;
+        friend class wotmin2d::test::TestData<BasicParticle>;
         friend class wotmin2d::test::ParticleTest;
         friend class wotmin2d::test::BlobStateTest;
         private:
@@ -43,11 +59,12 @@ class Particle {
         BlobStateKey& operator=(const BlobStateKey&) = delete;
     };
     public:
-    Particle(IntVector position);
+    BasicParticle(IntVector position);
     const IntVector& getPosition() const;
-    Particle* getNeighbor(Direction direction);
-    const Particle* getConstNeighbor(Direction direction) const;
-    void setNeighbor(BlobStateKey, Direction direction, Particle* neighbor);
+    BasicParticle* getNeighbor(Direction direction);
+    const BasicParticle* getConstNeighbor(Direction direction) const;
+    void setNeighbor(BlobStateKey, Direction direction,
+                     BasicParticle* neighbor);
     bool hasNeighbor() const;
     void move(BlobStateKey, Direction direction);
     bool hasPath(std::initializer_list<Direction> directions) const;
@@ -55,48 +72,50 @@ class Particle {
     Direction getPressureDirection() const;
     void advance(BlobStateKey, std::chrono::milliseconds time_delta);
     void setTarget(const IntVector& target, float target_pressure_per_second);
-    void collideWith(BlobStateKey, Particle& forward_neighbor,
+    const IntVector& getTarget() const;
+    float getTargetPressurePerSecond() const;
+    void collideWith(BlobStateKey, BasicParticle& forward_neighbor,
                      Direction collision_direction);
     void killPressureInDirection(BlobStateKey, Direction direction);
     bool canMove() const;
+    float getMobility() const;
+    void updateMobility(BlobStateKey);
     void addFollowers(BlobStateKey,
-                      const std::vector<Particle*>& new_followers);
-    void removeFollower(BlobStateKey, Particle& follower);
-    void removeLeader(BlobStateKey, Particle& leader);
-    std::unordered_set<Particle*>& getFollowers(BlobStateKey);
-    std::unordered_set<Particle*>& getLeaders(BlobStateKey);
+                      const std::vector<BasicParticle*>& new_followers);
+    void removeFollower(BlobStateKey, BasicParticle& follower);
+    void linkFollower(BlobStateKey, BasicParticle& follower);
+    void removeLeader(BlobStateKey, BasicParticle& leader);
+    std::unordered_set<BasicParticle*>& getFollowers(BlobStateKey);
+    std::unordered_set<BasicParticle*>& getLeaders(BlobStateKey);
+    const std::unordered_set<BasicParticle*>& getConstLeaders() const;
     unsigned int getHealth() const;
     void damage(BlobStateKey, unsigned int amount);
+    void restore(BlobStateKey, const FloatVector& pressure,
+                 unsigned int health);
     private:
-    template<class C>
-    void addPressureToFollowers(const C&, float magnitude);
-    void addLeader(Particle& leader);
-    void addFollower(Particle& follower);
-    void removeLeader(Particle& leader);
-    void removeFollower(Particle& follower);
+    template<class Followers>
+    void addPressureToFollowers(const Followers&, float magnitude);
+    void addLeader(BasicParticle& leader);
+    void addFollower(BasicParticle& follower);
+    void removeLeader(BasicParticle& leader);
+    void removeFollower(BasicParticle& follower);
     void reevaluateFollowership();
+    float computeMobility() const;
     IntVector position;
-    std::array<Particle*, 4> neighbors;
+    std::array<BasicParticle*, 4> neighbors;
     IntVector target;
     float target_pressure_per_second;
     FloatVector pressure;
-    std::unordered_set<Particle*> followers;
-    std::unordered_set<Particle*> leaders;
+    std::unordered_set<BasicParticle*> followers;
+    std::unordered_set<BasicParticle*> leaders;
     unsigned int health;
+    float mobility;
 };
 
-template<class C>
-void Particle::addPressureToFollowers(const C& followers,
-                                      float magnitude) {
-    for (Particle* follower: followers) {
-        assert(follower != nullptr);
-        FloatVector to_this = static_cast<FloatVector>(position
-                                                       - follower->position);
-        FloatVector to_this_pressure = to_this * (magnitude / to_this.norm());
-        follower->pressure += to_this_pressure;
-    }
-}
+using Particle = BasicParticle<>;
 
 }
 
+#include "Particle.tpp"
+
 #endif
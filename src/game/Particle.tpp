@@ -1,8 +1,7 @@
-#include "Particle.hpp"
-
 namespace wotmin2d {
 
-Particle::Particle(IntVector position) :
+template<class C>
+BasicParticle<C>::BasicParticle(IntVector position) :
     position(position),
     neighbors(),
     target(0, 0),
@@ -10,37 +9,48 @@ Particle::Particle(IntVector position) :
     pressure(0.0f, 0.0f),
     followers(),
     leaders(),
-    health(Config::particle_health) {}
+    health(Config::particle_health),
+    mobility(-1.0f) {}
 
-const IntVector& Particle::getPosition() const {
+template<class C>
+const IntVector& BasicParticle<C>::getPosition() const {
     return position;
 }
 
-Particle* Particle::getNeighbor(Direction direction) {
+template<class C>
+BasicParticle<C>* BasicParticle<C>::getNeighbor(Direction direction) {
     // Direction is convertible to unsigned integers, starting at 0.
     return neighbors[static_cast<Direction::val_t>(direction)];
 }
 
-const Particle* Particle::getConstNeighbor(Direction direction) const {
+template<class C>
+const BasicParticle<C>* BasicParticle<C>::getConstNeighbor(
+    Direction direction) const
+{
     return neighbors[static_cast<Direction::val_t>(direction)];
 }
 
-void Particle::setNeighbor(BlobStateKey, Direction direction,
-                           Particle* neighbor) {
+template<class C>
+void BasicParticle<C>::setNeighbor(BlobStateKey, Direction direction,
+                                   BasicParticle* neighbor) {
     neighbors[static_cast<Direction::val_t>(direction)] = neighbor;
 }
 
-bool Particle::hasNeighbor() const {
+template<class C>
+bool BasicParticle<C>::hasNeighbor() const {
     return std::any_of(neighbors.begin(), neighbors.end(),
-                       [](const Particle* p) { return p != nullptr; });
+                       [](const BasicParticle* p) { return p != nullptr; });
 }
 
-bool Particle::hasPath(std::initializer_list<Direction> directions) const {
+template<class C>
+bool BasicParticle<C>::hasPath(
+    std::initializer_list<Direction> directions) const
+{
     if (directions.size() == 0) {
         return true;
     }
     auto direction_iter = directions.begin();
-    const Particle* neighbor = getConstNeighbor(*direction_iter);
+    const BasicParticle* neighbor = getConstNeighbor(*direction_iter);
     direction_iter++;
     for (; direction_iter != directions.end(); direction_iter++) {
         if (neighbor == nullptr) {
@@ -51,7 +61,9 @@ bool Particle::hasPath(std::initializer_list<Direction> directions) const {
     return neighbor != nullptr;
 }
 
-void Particle::advance(BlobStateKey, std::chrono::milliseconds time_delta) {
+template<class C>
+void BasicParticle<C>::advance(BlobStateKey,
+                               std::chrono::milliseconds time_delta) {
     // How much target pressure do we need to apply?
     std::chrono::duration<float, std::ratio<1>> second_fraction = time_delta;
     float target_pressure = second_fraction.count()
@@ -85,11 +97,13 @@ void Particle::advance(BlobStateKey, std::chrono::milliseconds time_delta) {
     reevaluateFollowership();
 }
 
-const FloatVector& Particle::getPressure() const {
+template<class C>
+const FloatVector& BasicParticle<C>::getPressure() const {
     return pressure;
 }
 
-Direction Particle::getPressureDirection() const {
+template<class C>
+Direction BasicParticle<C>::getPressureDirection() const {
     const float x = pressure.getX();
     const float y = pressure.getY();
     const float x_abs = std::abs(x);
@@ -109,13 +123,25 @@ Direction Particle::getPressureDirection() const {
     }
 }
 
-void Particle::setTarget(const IntVector& target,
-                         float target_pressure_per_second) {
+template<class C>
+void BasicParticle<C>::setTarget(const IntVector& target,
+                                 float target_pressure_per_second) {
     this->target = target;
     this->target_pressure_per_second = target_pressure_per_second;
 }
 
-void Particle::move(BlobStateKey, Direction direction) {
+template<class C>
+const IntVector& BasicParticle<C>::getTarget() const {
+    return target;
+}
+
+template<class C>
+float BasicParticle<C>::getTargetPressurePerSecond() const {
+    return target_pressure_per_second;
+}
+
+template<class C>
+void BasicParticle<C>::move(BlobStateKey, Direction direction) {
     assert(canMove() && "Particle was asked to move but can't.");
     assert(direction == getPressureDirection() && "Particle was asked to move "
            "in a different direction than the pressure.");
@@ -124,8 +150,10 @@ void Particle::move(BlobStateKey, Direction direction) {
     pressure -= static_cast<FloatVector>(vector);
 }
 
-void Particle::collideWith(BlobStateKey, Particle& forward_neighbor,
-                           Direction collision_direction) {
+template<class C>
+void BasicParticle<C>::collideWith(BlobStateKey,
+                                   BasicParticle& forward_neighbor,
+                                   Direction collision_direction) {
     switch (collision_direction) {
     case Direction::north():
     case Direction::south():
@@ -142,7 +170,7 @@ void Particle::collideWith(BlobStateKey, Particle& forward_neighbor,
     }
     // Pass on our leaders to the particle we collided with, unless it's one of
     // the leaders, then just unfollow.
-    for (Particle* leader: leaders) {
+    for (BasicParticle* leader: leaders) {
         leader->removeFollower(*this);
         if (leader != &forward_neighbor) {
             forward_neighbor.addLeader(*leader);
@@ -152,7 +180,9 @@ void Particle::collideWith(BlobStateKey, Particle& forward_neighbor,
     leaders.clear();
 }
 
-void Particle::killPressureInDirection(BlobStateKey, Direction direction) {
+template<class C>
+void BasicParticle<C>::killPressureInDirection(BlobStateKey,
+                                               Direction direction) {
     switch (direction) {
     case Direction::north():
     case Direction::south():
@@ -165,7 +195,8 @@ void Particle::killPressureInDirection(BlobStateKey, Direction direction) {
     }
 }
 
-bool Particle::canMove() const {
+template<class C>
+bool BasicParticle<C>::canMove() const {
     // TODO Using a constant here only works as long as the movements a particle
     // is asked to make have fixed length (of 1). If that ever changes, this
     // needs to be parameterized on the length of the movement, i.e. "can this
@@ -175,15 +206,36 @@ bool Particle::canMove() const {
               >= Config::min_directed_movement_pressure;
 }
 
-void Particle::addFollowers(BlobStateKey,
-                            const std::vector<Particle*>& new_followers)
+// Returns the mobility as of the last call to updateMobility(): the squared
+// pressure if the particle can move, -1 otherwise. BlobState orders particles by
+// this value and updates it only when it repositions the particle in its
+// index, so the order stays consistent even when a particle changes the
+// pressure of others.
+template<class C>
+float BasicParticle<C>::getMobility() const {
+    return mobility;
+}
+
+template<class C>
+void BasicParticle<C>::updateMobility(BlobStateKey) {
+    mobility = computeMobility();
+}
+
+template<class C>
+float BasicParticle<C>::computeMobility() const {
+    return canMove() ? pressure.squaredNorm() : -1.0f;
+}
+
+template<class C>
+void BasicParticle<C>::addFollowers(
+    BlobStateKey, const std::vector<BasicParticle*>& new_followers)
 {
     static_assert(Config::boost_fraction >= 0.0f
                   && Config::boost_fraction <= 1.0f,
                   "A boost fraction outside [0, 1] will artificially inflate or"
                   " deflate the pressure.");
     this->followers.insert(new_followers.begin(), new_followers.end());
-    for (Particle* new_follower: new_followers) {
+    for (BasicParticle* new_follower: new_followers) {
         new_follower->addLeader(*this);
     }
     float pressure_magnitude = pressure.norm();
@@ -193,42 +245,70 @@ void Particle::addFollowers(BlobStateKey,
     addPressureToFollowers(new_followers, boost_magnitude / divisor);
 }
 
-void Particle::addLeader(Particle& leader) {
+template<class C>
+void BasicParticle<C>::addLeader(BasicParticle& leader) {
     leaders.insert(&leader);
 }
 
-void Particle::addFollower(Particle& follower) {
+template<class C>
+void BasicParticle<C>::addFollower(BasicParticle& follower) {
     followers.insert(&follower);
 }
 
-void Particle::removeLeader(Particle& leader) {
+template<class C>
+void BasicParticle<C>::removeLeader(BasicParticle& leader) {
     leaders.erase(&leader);
 }
 
-void Particle::removeFollower(Particle& follower) {
+template<class C>
+void BasicParticle<C>::removeFollower(BasicParticle& follower) {
     followers.erase(&follower);
 }
 
-void Particle::removeLeader(BlobStateKey, Particle& leader) {
+template<class C>
+void BasicParticle<C>::removeLeader(BlobStateKey, BasicParticle& leader) {
     removeLeader(leader);
 }
 
-void Particle::removeFollower(BlobStateKey, Particle& follower) {
+template<class C>
+void BasicParticle<C>::removeFollower(BlobStateKey, BasicParticle& follower) {
     removeFollower(follower);
 }
 
-std::unordered_set<Particle*>& Particle::getFollowers(BlobStateKey) {
+// Makes follower follow this particle without the boost addFollowers() gives.
+// Used when restoring relations that already existed.
+template<class C>
+void BasicParticle<C>::linkFollower(BlobStateKey, BasicParticle& follower) {
+    addFollower(follower);
+    follower.addLeader(*this);
+}
+
+template<class C>
+std::unordered_set<BasicParticle<C>*>& BasicParticle<C>::getFollowers(
+    BlobStateKey)
+{
     return followers;
 }
 
-std::unordered_set<Particle*>& Particle::getLeaders(BlobStateKey) {
+template<class C>
+std::unordered_set<BasicParticle<C>*>& BasicParticle<C>::getLeaders(
+    BlobStateKey)
+{
+    return leaders;
+}
+
+// Lets anyone look at the leaders, e.g. to show them.
+template<class C>
+const std::unordered_set<BasicParticle<C>*>&
+BasicParticle<C>::getConstLeaders() const {
     return leaders;
 }
 
-void Particle::reevaluateFollowership() {
-    std::vector<Particle*> to_remove;
-    std::vector<Particle*> to_switch;
-    for (Particle* leader: leaders) {
+template<class C>
+void BasicParticle<C>::reevaluateFollowership() {
+    std::vector<BasicParticle*> to_remove;
+    std::vector<BasicParticle*> to_switch;
+    for (BasicParticle* leader: leaders) {
         assert(leader != nullptr);
         if (pressure.dot(leader->pressure) < 0) {
             // The particles are trying to go in opposing directions and neither
@@ -251,11 +331,11 @@ void Particle::reevaluateFollowership() {
             to_switch.push_back(leader);
         }
     }
-    for (Particle* leader: to_remove) {
+    for (BasicParticle* leader: to_remove) {
         leader->removeFollower(*this);
         removeLeader(*leader);
     }
-    for (Particle* leader: to_switch) {
+    for (BasicParticle* leader: to_switch) {
         leader->removeFollower(*this);
         removeLeader(*leader);
         addFollower(*leader);
@@ -263,12 +343,37 @@ void Particle::reevaluateFollowership() {
     }
 }
 
-unsigned int Particle::getHealth() const {
+template<class C>
+unsigned int BasicParticle<C>::getHealth() const {
     return health;
 }
 
-void Particle::damage(BlobStateKey, unsigned int amount) {
+template<class C>
+void BasicParticle<C>::damage(BlobStateKey, unsigned int amount) {
     health = amount < health ? health - amount : 0;
 }
 
+// Sets the state that changes as the particle is advanced, when restoring it
+// from a snapshot.
+template<class C>
+void BasicParticle<C>::restore(BlobStateKey, const FloatVector& pressure,
+                               unsigned int health) {
+    this->pressure = pressure;
+    this->health = health;
+    mobility = computeMobility();
+}
+
+template<class C>
+template<class Followers>
+void BasicParticle<C>::addPressureToFollowers(const Followers& followers,
+                                              float magnitude) {
+    for (BasicParticle* follower: followers) {
+        assert(follower != nullptr);
+        FloatVector to_this = static_cast<FloatVector>(position
+                                                       - follower->position);
+        FloatVector to_this_pressure = to_this * (magnitude / to_this.norm());
+        follower->pressure += to_this_pressure;
+    }
+}
+
 }
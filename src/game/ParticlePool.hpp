@@ -0,0 +1,50 @@
+#ifndef PARTICLEPOOL_HPP
+#define PARTICLEPOOL_HPP
+
+#include <vector>
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <cstddef>
+#include <cassert>
+#include <type_traits>
+
+namespace wotmin2d {
+
+/**
+ * Storage for the particles of a blob. Particles are constructed in chunks of
+ * contiguous memory instead of being allocated one by one, and the slots of
+ * destroyed particles are reused. Chunks are only freed when the pool is
+ * destroyed.
+ *
+ * The pool doesn't keep track of which slots are occupied, whoever creates
+ * particles is responsible for destroying them.
+ */
+template<class P>
+class ParticlePool {
+    public:
+    ParticlePool();
+    ParticlePool(const ParticlePool&) = delete;
+    ParticlePool& operator=(const ParticlePool&) = delete;
+    template<class... Args>
+    P* create(Args&&... args);
+    void destroy(P* particle);
+    void reserve(std::size_t count);
+    std::size_t getCapacity() const;
+    std::size_t getMemoryUsage() const;
+    private:
+    using Slot = typename std::aligned_storage<sizeof(P), alignof(P)>::type;
+    void addChunk(std::size_t size);
+    constexpr static std::size_t min_chunk_size = 256;
+    std::vector<std::unique_ptr<Slot[]>> chunks;
+    std::vector<Slot*> free_slots;
+    Slot* next_slot;
+    Slot* chunk_end;
+    std::size_t capacity;
+};
+
+}
+
+#include "ParticlePool.tpp"
+
+#endif
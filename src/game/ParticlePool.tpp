@@ -0,0 +1,75 @@
+namespace wotmin2d {
+
+template<class P>
+constexpr std::size_t ParticlePool<P>::min_chunk_size;
+
+template<class P>
+ParticlePool<P>::ParticlePool() :
+    chunks(),
+    free_slots(),
+    next_slot(nullptr),
+    chunk_end(nullptr),
+    capacity(0) {}
+
+template<class P>
+template<class... Args>
+P* ParticlePool<P>::create(Args&&... args) {
+    Slot* slot;
+    if (!free_slots.empty()) {
+        slot = free_slots.back();
+        free_slots.pop_back();
+    } else {
+        if (next_slot == chunk_end) {
+            // Grow geometrically so the number of chunks stays small.
+            addChunk(std::max(min_chunk_size, capacity));
+        }
+        slot = next_slot;
+        next_slot++;
+    }
+    return new (slot) P(std::forward<Args>(args)...);
+}
+
+template<class P>
+void ParticlePool<P>::destroy(P* particle) {
+    assert(particle != nullptr);
+    particle->~P();
+    free_slots.push_back(reinterpret_cast<Slot*>(particle));
+}
+
+// Makes sure the next count particles can be created without allocating more
+// than once. If a new chunk is needed, it's big enough to hold all of them
+// contiguously.
+template<class P>
+void ParticlePool<P>::reserve(std::size_t count) {
+    std::size_t available = free_slots.size()
+                            + static_cast<std::size_t>(chunk_end - next_slot);
+    if (available >= count) {
+        return;
+    }
+    addChunk(std::max(count, min_chunk_size));
+}
+
+template<class P>
+std::size_t ParticlePool<P>::getCapacity() const {
+    return capacity;
+}
+
+template<class P>
+std::size_t ParticlePool<P>::getMemoryUsage() const {
+    return capacity * sizeof(Slot)
+           + free_slots.capacity() * sizeof(Slot*);
+}
+
+template<class P>
+void ParticlePool<P>::addChunk(std::size_t size) {
+    // Whatever is left of the current chunk can still be used later.
+    for (; next_slot != chunk_end; next_slot++) {
+        free_slots.push_back(next_slot);
+    }
+    chunks.emplace_back(new Slot[size]);
+    next_slot = chunks.back().get();
+    chunk_end = next_slot + size;
+    capacity += size;
+}
+
+}
@@ -0,0 +1,227 @@
+#include "Shape.hpp"
+
+#include <bitset>
+
+namespace wotmin2d {
+
+Shape::Shape() :
+    origin(0, 0),
+    width(0),
+    height(0),
+    bits(allocateBits(0, 0)) {}
+
+Shape::Shape(const IntVector& origin, unsigned int width, unsigned int height,
+             std::shared_ptr<const std::uint8_t> bits) :
+    origin(origin),
+    width(width),
+    height(height),
+    bits(bits) {
+    assert(this->bits != nullptr && "Shape without bits.");
+}
+
+Shape Shape::circle(const IntVector& center, float radius) {
+    if (radius < 0.0f) {
+        return Shape();
+    }
+    int extent = static_cast<int>(radius);
+    unsigned int diameter = 2 * static_cast<unsigned int>(extent) + 1;
+    std::size_t row_bytes = rowBytes(diameter);
+    std::shared_ptr<std::uint8_t> bits = allocateBits(diameter, diameter);
+    float squared_radius = radius * radius;
+    for (int y = -extent; y <= extent; y++) {
+        for (int x = -extent; x <= extent; x++) {
+            if (IntVector(x, y).squaredNorm() <= squared_radius) {
+                setBit(bits.get(), row_bytes, x + extent, y + extent);
+            }
+        }
+    }
+    return Shape(center - IntVector(extent, extent), diameter, diameter,
+                 bits);
+}
+
+Shape Shape::rectangle(const IntVector& origin, unsigned int width,
+                       unsigned int height) {
+    std::size_t row_bytes = rowBytes(width);
+    std::shared_ptr<std::uint8_t> bits = allocateBits(width, height);
+    for (unsigned int y = 0; y < height; y++) {
+        for (unsigned int x = 0; x < width; x++) {
+            setBit(bits.get(), row_bytes, x, y);
+        }
+    }
+    return Shape(origin, width, height, bits);
+}
+
+// Makes a shape from a mask given row by row, starting at the bottom.
+Shape Shape::fromMask(const IntVector& origin, unsigned int width,
+                      unsigned int height, const std::vector<bool>& mask) {
+    assert(mask.size() == static_cast<std::size_t>(width) * height
+           && "Mask size doesn't match the dimensions.");
+    std::size_t row_bytes = rowBytes(width);
+    std::shared_ptr<std::uint8_t> bits = allocateBits(width, height);
+    for (unsigned int y = 0; y < height; y++) {
+        for (unsigned int x = 0; x < width; x++) {
+            if (mask[static_cast<std::size_t>(y) * width + x]) {
+                setBit(bits.get(), row_bytes, x, y);
+            }
+        }
+    }
+    return Shape(origin, width, height, bits);
+}
+
+std::size_t Shape::rowBytes(unsigned int width) {
+    return (static_cast<std::size_t>(width) + 7) / 8;
+}
+
+bool Shape::operator==(const Shape& other) const {
+    if (origin != other.origin || width != other.width
+        || height != other.height) {
+        return false;
+    }
+    for (unsigned int y = 0; y < height; y++) {
+        for (unsigned int x = 0; x < width; x++) {
+            if (isSet(x, y) != other.isSet(x, y)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool Shape::operator!=(const Shape& other) const {
+    return !(*this == other);
+}
+
+// Returns the part of the shape that lies within an arena of the given
+// dimensions.
+Shape Shape::clipped(unsigned int arena_width,
+                     unsigned int arena_height) const {
+    long left = std::max(0L, static_cast<long>(origin.getX()));
+    long bottom = std::max(0L, static_cast<long>(origin.getY()));
+    long right = std::min(static_cast<long>(arena_width),
+                          static_cast<long>(origin.getX()) + width);
+    long top = std::min(static_cast<long>(arena_height),
+                        static_cast<long>(origin.getY()) + height);
+    if (left >= right || bottom >= top) {
+        return Shape();
+    }
+    if (left == origin.getX() && bottom == origin.getY()
+        && right - left == width && top - bottom == height) {
+        return *this;
+    }
+    unsigned int clipped_width = static_cast<unsigned int>(right - left);
+    unsigned int clipped_height = static_cast<unsigned int>(top - bottom);
+    unsigned int offset_x = static_cast<unsigned int>(left - origin.getX());
+    unsigned int offset_y = static_cast<unsigned int>(bottom - origin.getY());
+    std::size_t row_bytes = rowBytes(clipped_width);
+    std::shared_ptr<std::uint8_t> clipped_bits
+        = allocateBits(clipped_width, clipped_height);
+    for (unsigned int y = 0; y < clipped_height; y++) {
+        for (unsigned int x = 0; x < clipped_width; x++) {
+            if (isSet(x + offset_x, y + offset_y)) {
+                setBit(clipped_bits.get(), row_bytes, x, y);
+            }
+        }
+    }
+    return Shape(IntVector(static_cast<int>(left), static_cast<int>(bottom)),
+                 clipped_width, clipped_height, clipped_bits);
+}
+
+const IntVector& Shape::getOrigin() const {
+    return origin;
+}
+
+unsigned int Shape::getWidth() const {
+    return width;
+}
+
+unsigned int Shape::getHeight() const {
+    return height;
+}
+
+std::size_t Shape::getRowBytes() const {
+    return rowBytes(width);
+}
+
+const std::uint8_t* Shape::getBits() const {
+    return bits.get();
+}
+
+// Whether the cell at the given coordinates relative to the origin is part of
+// the shape.
+bool Shape::isSet(unsigned int x, unsigned int y) const {
+    assert(x < width && y < height && "Cell outside of the shape's bounds.");
+    std::uint8_t byte = bits.get()[y * getRowBytes() + x / 8];
+    return (byte >> (x % 8)) & 1;
+}
+
+// Whether the cell at the given arena position is part of the shape.
+bool Shape::contains(const IntVector& position) const {
+    IntVector relative = position - origin;
+    if (relative.getX() < 0 || relative.getY() < 0
+        || static_cast<unsigned int>(relative.getX()) >= width
+        || static_cast<unsigned int>(relative.getY()) >= height) {
+        return false;
+    }
+    return isSet(relative.getX(), relative.getY());
+}
+
+// Whether any cell is part of both shapes.
+bool Shape::overlaps(const Shape& other) const {
+    long left = std::max(static_cast<long>(origin.getX()),
+                         static_cast<long>(other.origin.getX()));
+    long bottom = std::max(static_cast<long>(origin.getY()),
+                           static_cast<long>(other.origin.getY()));
+    long right = std::min(static_cast<long>(origin.getX()) + width,
+                          static_cast<long>(other.origin.getX())
+                          + other.width);
+    long top = std::min(static_cast<long>(origin.getY()) + height,
+                        static_cast<long>(other.origin.getY())
+                        + other.height);
+    for (long y = bottom; y < top; y++) {
+        for (long x = left; x < right; x++) {
+            IntVector position(static_cast<int>(x), static_cast<int>(y));
+            if (contains(position) && other.contains(position)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Bits past the width in the last byte of a row are padding and aren't
+// counted, whatever they hold.
+std::size_t Shape::count() const {
+    std::size_t row_bytes = getRowBytes();
+    std::uint8_t last_byte_mask = width % 8 == 0
+        ? 0xff : static_cast<std::uint8_t>((1 << (width % 8)) - 1);
+    std::size_t count = 0;
+    for (unsigned int y = 0; y < height; y++) {
+        const std::uint8_t* row = bits.get() + y * row_bytes;
+        for (std::size_t i = 0; i + 1 < row_bytes; i++) {
+            count += std::bitset<8>(row[i]).count();
+        }
+        if (row_bytes > 0) {
+            count += std::bitset<8>(row[row_bytes - 1] & last_byte_mask)
+                         .count();
+        }
+    }
+    return count;
+}
+
+bool Shape::empty() const {
+    return count() == 0;
+}
+
+std::shared_ptr<std::uint8_t> Shape::allocateBits(unsigned int width,
+                                                  unsigned int height) {
+    std::size_t size = rowBytes(width) * height;
+    return std::shared_ptr<std::uint8_t>(new std::uint8_t[size](),
+                                         std::default_delete<std::uint8_t[]>());
+}
+
+void Shape::setBit(std::uint8_t* bits, std::size_t row_bytes, unsigned int x,
+                   unsigned int y) {
+    bits[y * row_bytes + x / 8] |= static_cast<std::uint8_t>(1 << (x % 8));
+}
+
+}
@@ -0,0 +1,62 @@
+#ifndef SHAPE_HPP
+#define SHAPE_HPP
+
+#include "Vector.hpp"
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <cassert>
+
+namespace wotmin2d {
+
+/**
+ * A set of cells in the arena, stored as a bitmap covering the shape's
+ * bounding box. The bitmap consists of rows of getRowBytes() bytes each,
+ * starting with the row at the bottom (lowest y), and the cell at the origin
+ * is the least significant bit of the first byte.
+ *
+ * The bits are shared between copies and never modified, so shapes are cheap
+ * to copy. They may also point into memory owned by something else (e.g. a
+ * memory-mapped file) that is kept alive by the shared pointer.
+ */
+class Shape {
+    public:
+    Shape();
+    Shape(const IntVector& origin, unsigned int width, unsigned int height,
+          std::shared_ptr<const std::uint8_t> bits);
+    static Shape circle(const IntVector& center, float radius);
+    static Shape rectangle(const IntVector& origin, unsigned int width,
+                           unsigned int height);
+    static Shape fromMask(const IntVector& origin, unsigned int width,
+                          unsigned int height, const std::vector<bool>& mask);
+    static std::size_t rowBytes(unsigned int width);
+    bool operator==(const Shape& other) const;
+    bool operator!=(const Shape& other) const;
+    Shape clipped(unsigned int arena_width, unsigned int arena_height) const;
+    const IntVector& getOrigin() const;
+    unsigned int getWidth() const;
+    unsigned int getHeight() const;
+    std::size_t getRowBytes() const;
+    const std::uint8_t* getBits() const;
+    bool isSet(unsigned int x, unsigned int y) const;
+    bool contains(const IntVector& position) const;
+    bool overlaps(const Shape& other) const;
+    std::size_t count() const;
+    bool empty() const;
+    private:
+    static std::shared_ptr<std::uint8_t> allocateBits(unsigned int width,
+                                                      unsigned int height);
+    static void setBit(std::uint8_t* bits, std::size_t row_bytes,
+                       unsigned int x, unsigned int y);
+    IntVector origin;
+    unsigned int width;
+    unsigned int height;
+    std::shared_ptr<const std::uint8_t> bits;
+};
+
+}
+
+#endif
@@ -0,0 +1,119 @@
+#include "Snapshot.hpp"
+
+namespace wotmin2d {
+
+constexpr std::uint32_t ParticleRecord::no_particle;
+constexpr StateSnapshot::PlayerId StateSnapshot::max_player_id;
+
+bool ParticleRecord::operator==(const ParticleRecord& other) const {
+    return x == other.x && y == other.y && target_x == other.target_x
+           && target_y == other.target_y
+           && target_pressure_per_second == other.target_pressure_per_second
+           && pressure_x == other.pressure_x && pressure_y == other.pressure_y
+           && health == other.health && neighbors == other.neighbors
+           && followers_begin == other.followers_begin
+           && followers_end == other.followers_end;
+}
+
+bool ParticleRecord::operator!=(const ParticleRecord& other) const {
+    return !(*this == other);
+}
+
+BlobSnapshot::BlobSnapshot() :
+    particles(),
+    followers() {}
+
+bool BlobSnapshot::operator==(const BlobSnapshot& other) const {
+    return particles == other.particles && followers == other.followers;
+}
+
+bool BlobSnapshot::operator!=(const BlobSnapshot& other) const {
+    return !(*this == other);
+}
+
+std::vector<ParticleRecord>& BlobSnapshot::getParticles() {
+    return particles;
+}
+
+const std::vector<ParticleRecord>& BlobSnapshot::getParticles() const {
+    return particles;
+}
+
+std::vector<std::uint32_t>& BlobSnapshot::getFollowers() {
+    return followers;
+}
+
+const std::vector<std::uint32_t>& BlobSnapshot::getFollowers() const {
+    return followers;
+}
+
+// Empties the snapshot but keeps the memory, so taking the next snapshot of a
+// blob of similar size doesn't allocate.
+void BlobSnapshot::clear() {
+    particles.clear();
+    followers.clear();
+}
+
+StateSnapshot::StateSnapshot() :
+    arena_width(0),
+    arena_height(0),
+    selection_center(0, 0),
+    selection_radius(0.0f),
+    blobs() {}
+
+bool StateSnapshot::operator==(const StateSnapshot& other) const {
+    return arena_width == other.arena_width
+           && arena_height == other.arena_height
+           && selection_center == other.selection_center
+           && selection_radius == other.selection_radius
+           && blobs == other.blobs;
+}
+
+bool StateSnapshot::operator!=(const StateSnapshot& other) const {
+    return !(*this == other);
+}
+
+unsigned int StateSnapshot::getArenaWidth() const {
+    return arena_width;
+}
+
+unsigned int StateSnapshot::getArenaHeight() const {
+    return arena_height;
+}
+
+void StateSnapshot::setArenaSize(unsigned int width, unsigned int height) {
+    arena_width = width;
+    arena_height = height;
+}
+
+const IntVector& StateSnapshot::getSelectionCenter() const {
+    return selection_center;
+}
+
+float StateSnapshot::getSelectionRadius() const {
+    return selection_radius;
+}
+
+void StateSnapshot::setSelection(const IntVector& center, float radius) {
+    selection_center = center;
+    selection_radius = radius;
+}
+
+std::map<StateSnapshot::PlayerId, BlobSnapshot>& StateSnapshot::getBlobs() {
+    return blobs;
+}
+
+const std::map<StateSnapshot::PlayerId, BlobSnapshot>&
+StateSnapshot::getBlobs() const {
+    return blobs;
+}
+
+std::size_t StateSnapshot::getParticleCount() const {
+    std::size_t count = 0;
+    for (const auto& id_blob: blobs) {
+        count += id_blob.second.getParticles().size();
+    }
+    return count;
+}
+
+}
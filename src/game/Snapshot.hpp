@@ -0,0 +1,93 @@
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include "Vector.hpp"
+
+#include <vector>
+#include <map>
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+
+namespace wotmin2d {
+
+/**
+ * A particle without pointers, so that a whole blob can be stored in (and
+ * restored from) flat arrays. Neighbors and followers are indices into the
+ * records of the same blob, leaders aren't stored since they're exactly the
+ * particles that have the particle as a follower.
+ */
+struct ParticleRecord {
+    constexpr static std::uint32_t no_particle
+        = std::numeric_limits<std::uint32_t>::max();
+    bool operator==(const ParticleRecord& other) const;
+    bool operator!=(const ParticleRecord& other) const;
+    std::int32_t x;
+    std::int32_t y;
+    std::int32_t target_x;
+    std::int32_t target_y;
+    float target_pressure_per_second;
+    float pressure_x;
+    float pressure_y;
+    std::uint32_t health;
+    // Indexed by Direction, no_particle if there is no neighbor.
+    std::array<std::uint32_t, 4> neighbors;
+    // The followers are the entries [followers_begin, followers_end) of the
+    // blob's follower array.
+    std::uint32_t followers_begin;
+    std::uint32_t followers_end;
+};
+
+/**
+ * The particles of a blob in the order of the blob's mobility index, so that
+ * restoring them doesn't need to sort.
+ */
+class BlobSnapshot {
+    public:
+    BlobSnapshot();
+    bool operator==(const BlobSnapshot& other) const;
+    bool operator!=(const BlobSnapshot& other) const;
+    std::vector<ParticleRecord>& getParticles();
+    const std::vector<ParticleRecord>& getParticles() const;
+    std::vector<std::uint32_t>& getFollowers();
+    const std::vector<std::uint32_t>& getFollowers() const;
+    void clear();
+    private:
+    std::vector<ParticleRecord> particles;
+    std::vector<std::uint32_t> followers;
+};
+
+/**
+ * Everything needed to continue a battle: the arena dimensions, the selection
+ * and the blob of each player.
+ */
+class StateSnapshot {
+    public:
+    using PlayerId = std::uint8_t;
+    // Renderings store a player's id plus one in a byte, with zero for empty
+    // cells, so that's the highest id a battle can have.
+    constexpr static PlayerId max_player_id = 254;
+    StateSnapshot();
+    bool operator==(const StateSnapshot& other) const;
+    bool operator!=(const StateSnapshot& other) const;
+    unsigned int getArenaWidth() const;
+    unsigned int getArenaHeight() const;
+    void setArenaSize(unsigned int width, unsigned int height);
+    const IntVector& getSelectionCenter() const;
+    float getSelectionRadius() const;
+    void setSelection(const IntVector& center, float radius);
+    std::map<PlayerId, BlobSnapshot>& getBlobs();
+    const std::map<PlayerId, BlobSnapshot>& getBlobs() const;
+    std::size_t getParticleCount() const;
+    private:
+    unsigned int arena_width;
+    unsigned int arena_height;
+    IntVector selection_center;
+    float selection_radius;
+    std::map<PlayerId, BlobSnapshot> blobs;
+};
+
+}
+
+#endif
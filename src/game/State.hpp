@@ -3,10 +3,16 @@
 
 #include "Blob.hpp"
 #include "Vector.hpp"
+#include "MemoryUsage.hpp"
+#include "Snapshot.hpp"
+#include "Command.hpp"
+#include "CircleMask.hpp"
+#include "TickProfile.hpp"
 #include "../Config.hpp"
 
 #include <vector>
 #include <unordered_map>
+#include <map>
 #include <unordered_set>
 #include <queue>
 #include <tuple>
@@ -22,6 +28,7 @@ namespace wotmin2d {
 template<class P = Particle, class B = Blob<P>>
 class State {
     public:
+    using Config = typename P::Config;
     using PlayerId = std::uint_fast8_t;
     class BlobMobilityLess {
         public:
@@ -39,6 +46,15 @@ class State {
     const std::unordered_map<PlayerId, B>& getBlobs() const;
     void selectParticles(const IntVector& center);
     void setTarget(PlayerId player, const IntVector& target);
+    void setBlobTarget(PlayerId player, const IntVector& target,
+                       float pressure_per_second);
+    void execute(const Command& command);
+    std::map<PlayerId, MemoryUsage> getMemoryUsage() const;
+    void snapshot(StateSnapshot& snapshot) const;
+    void restore(const StateSnapshot& snapshot);
+    void setChangeLogging(bool enabled);
+    void setDensityTracking(bool enabled);
+    const TickProfile& getProfile() const;
     private:
     using CollidingParticle = std::tuple<P*, PlayerId, Direction>;
     const unsigned int arena_width;
@@ -46,6 +62,9 @@ class State {
     std::unordered_map<PlayerId, B> blobs;
     IntVector selection_center;
     float selection_radius;
+    // Built for selection_radius when it's first needed after a change.
+    CircleMask selection_mask;
+    TickProfile profile;
     bool isMovementOutOfBounds(const IntVector& position,
                                Direction movement_direction) const;
     bool isHostileCollision(const P& particle, Direction movement_direction,
@@ -6,18 +6,33 @@ State<P, B>::State(unsigned int arena_width, unsigned int arena_height) :
     arena_height(arena_height),
     blobs(),
     selection_center(),
-    selection_radius(5.0f) {}
+    selection_radius(5.0f),
+    selection_mask(),
+    profile() {}
 
 template<class P, class B>
 void State<P, B>::advance(std::chrono::milliseconds time_delta) {
+    using Clock = TickProfile::Clock;
+    Clock::time_point start = Clock::now();
     for (auto& id_blob: blobs) {
         id_blob.second.advanceParticles(time_delta);
     }
+    Clock::time_point pressure_advanced = Clock::now();
     std::vector<CollidingParticle> colliding_particles;
+    profile.moves = 0;
     doParticleMovement(colliding_particles);
+    Clock::time_point moved = Clock::now();
     resolveCollisions(colliding_particles);
+    profile.pressure = pressure_advanced - start;
+    profile.movement = moved - pressure_advanced;
+    profile.collisions = Clock::now() - moved;
+    profile.hostile_collisions = colliding_particles.size();
 }
 
+// Moves the most mobile particle of all blobs until none can move. Blobs are
+// compared by the mobility cached in their particles (see
+// Particle::getMobility()), the same value their indices are ordered by, so
+// the blob whose turn it is always holds the most mobile particle.
 template<class P, class B>
 void State<P, B>::doParticleMovement(
     std::vector<CollidingParticle>& colliding_particles)
@@ -34,16 +49,16 @@ void State<P, B>::doParticleMovement(
         blob_queue(BlobMobilityLess(), blob_pointers);
     IdBlob current_blob = blob_queue.top();
     blob_queue.pop();
-    float second_pressure;
+    float second_mobility;
     if (blob_queue.empty()) {
-        second_pressure = -std::numeric_limits<float>::infinity();
+        second_mobility = -std::numeric_limits<float>::infinity();
     } else {
         P* second_particle
             = blob_queue.top().second->getHighestMobilityParticle();
         if (second_particle == nullptr) {
-            second_pressure = -std::numeric_limits<float>::infinity();
+            second_mobility = -std::numeric_limits<float>::infinity();
         } else {
-            second_pressure = second_particle->getPressure().squaredNorm();
+            second_mobility = second_particle->getMobility();
         }
     }
     P* particle = current_blob.second->getHighestMobilityParticle();
@@ -58,30 +73,29 @@ void State<P, B>::doParticleMovement(
         // pressure particle will remain the highest pressure one even after
         // moving n times.
         particle = current_blob.second->getHighestMobilityParticle();
-        if (particle->getPressure().squaredNorm() < second_pressure) {
+        if (particle->getMobility() < second_mobility) {
             // After moving, the highest mobility particle of the current blob
             // has lower mobility than the blob with next highest mobility.
             // Switch blobs.
             IdBlob new_blob = blob_queue.top();
             assert(new_blob.second != nullptr && "Blob was null.");
-            assert(new_blob.second->getHighestMobilityParticle()->getPressure()
-                       .squaredNorm() == second_pressure
-                   && "Pressure of the second most mobile particle not as "
+            assert(new_blob.second->getHighestMobilityParticle()
+                       ->getMobility() == second_mobility
+                   && "Mobility of the second most mobile particle not as "
                       "expected.");
             blob_queue.pop();
             blob_queue.push(current_blob);
             current_blob = new_blob;
             particle = current_blob.second->getHighestMobilityParticle();
             if (blob_queue.empty()) {
-                second_pressure = -std::numeric_limits<float>::infinity();
+                second_mobility = -std::numeric_limits<float>::infinity();
             } else {
                 P* second_particle
                     = blob_queue.top().second->getHighestMobilityParticle();
                 if (second_particle == nullptr) {
-                    second_pressure = -std::numeric_limits<float>::infinity();
+                    second_mobility = -std::numeric_limits<float>::infinity();
                 } else {
-                    second_pressure = second_particle->getPressure()
-                        .squaredNorm();
+                    second_mobility = second_particle->getMobility();
                 }
             }
         }
@@ -104,7 +118,9 @@ void State<P, B>::handleParticle(
         blob.collideParticleWithWall(particle, movement_direction);
         return;
     }
-    blob.handleParticle(particle, movement_direction);
+    if (blob.handleParticle(particle, movement_direction)) {
+        profile.moves++;
+    }
 }
 
 template<class P, class B>
@@ -198,6 +214,12 @@ void State<P, B>::changeSelectionRadius(float difference) {
     }
 }
 
+// Returns how the last advance() went.
+template<class P, class B>
+const TickProfile& State<P, B>::getProfile() const {
+    return profile;
+}
+
 template<class P, class B>
 const std::unordered_map<typename State<P, B>::PlayerId, B>&
 State<P, B>::getBlobs() const {
@@ -211,8 +233,108 @@ void State<P, B>::selectParticles(const IntVector& center) {
 
 template<class P, class B>
 void State<P, B>::setTarget(PlayerId player, const IntVector& target) {
+    selection_mask.update(selection_radius);
     // TODO Unhardcode pressure.
-    blobs[player].setTarget(target, 20.0f, selection_center, selection_radius);
+    blobs[player].setTarget(target, 20.0f, selection_center, selection_mask);
+}
+
+// Sets the target of all particles of a player's blob, regardless of the
+// selection.
+template<class P, class B>
+void State<P, B>::setBlobTarget(PlayerId player, const IntVector& target,
+                                float pressure_per_second) {
+    assert(blobs.count(player) > 0);
+    blobs.at(player).setTarget(target, pressure_per_second);
+}
+
+template<class P, class B>
+void State<P, B>::execute(const Command& command) {
+    switch (command.getType()) {
+    case Command::Type::select_particles:
+        selectParticles(command.getPosition());
+        break;
+    case Command::Type::set_target:
+        setTarget(command.getPlayerId(), command.getPosition());
+        break;
+    case Command::Type::change_selection_radius:
+        changeSelectionRadius(command.getDifference());
+        break;
+    }
+}
+
+template<class P, class B>
+std::map<typename State<P, B>::PlayerId, MemoryUsage>
+State<P, B>::getMemoryUsage() const {
+    std::map<PlayerId, MemoryUsage> usage;
+    for (const auto& id_blob: blobs) {
+        usage.emplace(id_blob.first, id_blob.second.getMemoryUsage());
+    }
+    return usage;
+}
+
+// Writes the state into the snapshot. Blob snapshots that are already there
+// are overwritten, so their memory is reused.
+template<class P, class B>
+void State<P, B>::snapshot(StateSnapshot& snapshot) const {
+    snapshot.setArenaSize(arena_width, arena_height);
+    snapshot.setSelection(selection_center, selection_radius);
+    std::map<StateSnapshot::PlayerId, BlobSnapshot>& blob_snapshots
+        = snapshot.getBlobs();
+    for (auto iter = blob_snapshots.begin(); iter != blob_snapshots.end();) {
+        if (blobs.count(iter->first) == 0) {
+            iter = blob_snapshots.erase(iter);
+        } else {
+            iter++;
+        }
+    }
+    for (const auto& id_blob: blobs) {
+        id_blob.second.snapshot(blob_snapshots[id_blob.first]);
+    }
+}
+
+// Replaces the blobs and selection with the ones in the snapshot, which must
+// have been taken of a state with the same arena dimensions. Blobs of players
+// that are in both are restored in place, so their memory is reused.
+template<class P, class B>
+void State<P, B>::restore(const StateSnapshot& snapshot) {
+    assert(snapshot.getArenaWidth() == arena_width
+           && snapshot.getArenaHeight() == arena_height
+           && "Snapshot doesn't have the dimensions of the state.");
+    selection_center = snapshot.getSelectionCenter();
+    selection_radius = snapshot.getSelectionRadius();
+    const std::map<StateSnapshot::PlayerId, BlobSnapshot>& blob_snapshots
+        = snapshot.getBlobs();
+    for (auto iter = blobs.begin(); iter != blobs.end();) {
+        if (blob_snapshots.count(iter->first) == 0) {
+            iter = blobs.erase(iter);
+        } else {
+            iter++;
+        }
+    }
+    for (const auto& id_blob: blob_snapshots) {
+        blobs[id_blob.first].restore(id_blob.second);
+    }
+}
+
+// Makes all blobs log the changes to their particles during each tick (see
+// Blob::getChanges()). Blobs added later, also by restore() if the player
+// didn't have a blob before, don't log.
+template<class P, class B>
+void State<P, B>::setChangeLogging(bool enabled) {
+    for (auto& id_blob: blobs) {
+        id_blob.second.setChangeLogging(enabled);
+    }
+}
+
+// Makes all blobs count their particles in a DensityPyramid covering the arena
+// (see Blob::getDensity()). Like change logging, this only applies to the
+// blobs there are.
+template<class P, class B>
+void State<P, B>::setDensityTracking(bool enabled) {
+    for (auto& id_blob: blobs) {
+        id_blob.second.setDensityTracking(enabled ? arena_width : 0,
+                                          enabled ? arena_height : 0);
+    }
 }
 
 template<class P, class B>
@@ -0,0 +1,47 @@
+#ifndef STATEFORK_HPP
+#define STATEFORK_HPP
+
+#include "State.hpp"
+#include "Snapshot.hpp"
+#include "Blob.hpp"
+#include "Particle.hpp"
+
+#include <chrono>
+#include <cstdint>
+
+namespace wotmin2d {
+
+/**
+ * A private copy of a state that can be advanced and changed without affecting
+ * the original, e.g. to try out a move and look at the result a few ticks
+ * later.
+ *
+ * States can't be copied directly since particles point at each other, so a
+ * fork goes through a snapshot instead. A fork is meant to be kept and reset
+ * over and over: both the snapshot and the blobs of the copy keep their memory
+ * between resets, so forking a battle that didn't change much in size doesn't
+ * allocate anything for particles. Whoever forks the same state many times
+ * (e.g. once per move to try) should take one snapshot of it and reset all
+ * forks from that, so that the live state is only walked once.
+ */
+template<class P = Particle, class B = Blob<P>>
+class StateFork {
+    public:
+    StateFork(unsigned int arena_width, unsigned int arena_height);
+    StateFork(const StateFork&) = delete;
+    StateFork& operator=(const StateFork&) = delete;
+    void reset(const State<P, B>& source);
+    void reset(const StateSnapshot& source);
+    void advance(std::chrono::milliseconds time_delta, std::uint64_t ticks);
+    State<P, B>& getState();
+    const State<P, B>& getState() const;
+    private:
+    StateSnapshot snapshot;
+    State<P, B> state;
+};
+
+}
+
+#include "StateFork.tpp"
+
+#endif
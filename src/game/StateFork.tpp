@@ -0,0 +1,42 @@
+namespace wotmin2d {
+
+template<class P, class B>
+StateFork<P, B>::StateFork(unsigned int arena_width,
+                           unsigned int arena_height) :
+    snapshot(),
+    state(arena_width, arena_height) {}
+
+// Makes the fork a copy of the source, which must have the same arena
+// dimensions. Whatever happened to the fork before is forgotten.
+template<class P, class B>
+void StateFork<P, B>::reset(const State<P, B>& source) {
+    source.snapshot(snapshot);
+    state.restore(snapshot);
+}
+
+// Makes the fork a copy of the state the snapshot was taken of, which must
+// have the same arena dimensions.
+template<class P, class B>
+void StateFork<P, B>::reset(const StateSnapshot& source) {
+    state.restore(source);
+}
+
+template<class P, class B>
+void StateFork<P, B>::advance(std::chrono::milliseconds time_delta,
+                              std::uint64_t ticks) {
+    for (std::uint64_t i = 0; i < ticks; i++) {
+        state.advance(time_delta);
+    }
+}
+
+template<class P, class B>
+State<P, B>& StateFork<P, B>::getState() {
+    return state;
+}
+
+template<class P, class B>
+const State<P, B>& StateFork<P, B>::getState() const {
+    return state;
+}
+
+}
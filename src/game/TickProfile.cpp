@@ -0,0 +1,16 @@
+#include "TickProfile.hpp"
+
+namespace wotmin2d {
+
+TickProfile::TickProfile() :
+    pressure(Clock::duration::zero()),
+    movement(Clock::duration::zero()),
+    collisions(Clock::duration::zero()),
+    moves(0),
+    hostile_collisions(0) {}
+
+TickProfile::Clock::duration TickProfile::getTotal() const {
+    return pressure + movement + collisions;
+}
+
+}
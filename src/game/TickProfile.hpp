@@ -0,0 +1,31 @@
+#ifndef TICKPROFILE_HPP
+#define TICKPROFILE_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+namespace wotmin2d {
+
+/**
+ * Where the time of the last State::advance() went, by phase, and how much
+ * happened in it. Measuring takes a few clock reads per tick, so it's always
+ * on.
+ */
+struct TickProfile {
+    using Clock = std::chrono::steady_clock;
+    TickProfile();
+    Clock::duration getTotal() const;
+    // Advancing the pressure of all particles.
+    Clock::duration pressure;
+    // Moving the particles with the highest mobility, one at a time.
+    Clock::duration movement;
+    // Damaging particles that ran into another blob.
+    Clock::duration collisions;
+    std::uint64_t moves;
+    std::size_t hostile_collisions;
+};
+
+}
+
+#endif
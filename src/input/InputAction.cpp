@@ -2,30 +2,106 @@
 
 namespace wotmin2d {
 
-InputAction::~InputAction() {}
+InputAction::InputAction(Type type, const IntVector& coordinate,
+                         float difference, int number,
+                         Clock::time_point time) :
+    type(type),
+    coordinate(coordinate),
+    difference(difference),
+    number(number),
+    time(time) {}
 
-ExitAction::~ExitAction() {}
+// An action of type none, which asks for nothing. Only there so that actions
+// can be kept in containers that need default values.
+InputAction::InputAction() :
+    InputAction(Type::none, IntVector(0, 0), 0.0f, 0, Clock::time_point()) {}
 
-AbstractCoordinateAction::AbstractCoordinateAction(const IntVector& coordinate):
-    coordinate(coordinate) {}
+InputAction InputAction::exit(Clock::time_point time) {
+    return InputAction(Type::exit, IntVector(0, 0), 0.0f, 0, time);
+}
 
-AbstractCoordinateAction::~AbstractCoordinateAction() {}
+InputAction InputAction::memoryReport(Clock::time_point time) {
+    return InputAction(Type::memory_report, IntVector(0, 0), 0.0f, 0, time);
+}
 
-const IntVector& AbstractCoordinateAction::getCoordinate() const {
-    return coordinate;
+InputAction InputAction::snapshot(Clock::time_point time) {
+    return InputAction(Type::snapshot, IntVector(0, 0), 0.0f, 0, time);
+}
+
+InputAction InputAction::rewind(Clock::time_point time) {
+    return InputAction(Type::rewind, IntVector(0, 0), 0.0f, 0, time);
 }
 
-ParticleSelectionAction::ParticleSelectionAction(const IntVector& coordinate):
-    AbstractCoordinateAction(coordinate) {}
+InputAction InputAction::selectParticles(const IntVector& coordinate,
+                                         Clock::time_point time) {
+    return InputAction(Type::select_particles, coordinate, 0.0f, 0, time);
+}
 
-TargetSettingAction::TargetSettingAction(const IntVector& coordinate):
-    AbstractCoordinateAction(coordinate) {}
+InputAction InputAction::setTarget(const IntVector& coordinate,
+                                   Clock::time_point time) {
+    return InputAction(Type::set_target, coordinate, 0.0f, 0, time);
+}
 
-SelectionSizeChangeAction::SelectionSizeChangeAction(float difference):
-    difference(difference) {}
+InputAction InputAction::changeSelectionSize(float difference,
+                                             Clock::time_point time) {
+    return InputAction(Type::change_selection_size, IntVector(0, 0),
+                       difference, 0, time);
+}
 
-float SelectionSizeChangeAction::getDifference() const {
+// Pans the view, the direction has y pointing up.
+InputAction InputAction::pan(const IntVector& direction,
+                             Clock::time_point time) {
+    return InputAction(Type::pan, direction, 0.0f, 0, time);
+}
+
+// Zooms in (positive steps) or out around the given coordinate.
+InputAction InputAction::zoom(int steps, const IntVector& coordinate,
+                              Clock::time_point time) {
+    return InputAction(Type::zoom, coordinate, 0.0f, steps, time);
+}
+
+// Turns a debug layer (see DebugSnapshot) on or off.
+InputAction InputAction::toggleLayer(unsigned int layer,
+                                     Clock::time_point time) {
+    return InputAction(Type::toggle_layer, IntVector(0, 0), 0.0f,
+                       static_cast<int>(layer), time);
+}
+
+// Shows or hides the performance overlay.
+InputAction InputAction::toggleHud(Clock::time_point time) {
+    return InputAction(Type::toggle_hud, IntVector(0, 0), 0.0f, 0, time);
+}
+
+// Returns a copy of the action with the coordinate replaced, e.g. converted
+// from window to arena coordinates.
+InputAction InputAction::withCoordinate(const IntVector& coordinate) const {
+    return InputAction(type, coordinate, difference, number, time);
+}
+
+InputAction::Type InputAction::getType() const {
+    return type;
+}
+
+const IntVector& InputAction::getCoordinate() const {
+    return coordinate;
+}
+
+float InputAction::getDifference() const {
     return difference;
 }
 
+// Returns the steps of a zoom action.
+int InputAction::getSteps() const {
+    return number;
+}
+
+// Returns the layer of a toggle_layer action.
+unsigned int InputAction::getLayer() const {
+    return static_cast<unsigned int>(number);
+}
+
+InputAction::Clock::time_point InputAction::getTime() const {
+    return time;
+}
+
 }
@@ -3,43 +3,58 @@
 
 #include "../game/Vector.hpp"
 
+#include <chrono>
+#include <cstdint>
+
 namespace wotmin2d {
 
+/**
+ * Something the user asked for, with the time it happened. Actions are small
+ * plain values, so they can be collected in reused buffers and passed between
+ * threads without allocating, and are told apart by their type.
+ *
+ * Coordinates are in window coordinates as they come from the parser, until
+ * whoever owns the screen converts them (see withCoordinate()).
+ */
 class InputAction {
     public:
-    virtual ~InputAction() = 0;
-};
-
-class ExitAction : public InputAction {
-    public:
-    virtual ~ExitAction();
-};
-
-class AbstractCoordinateAction : public InputAction {
-    public:
-    AbstractCoordinateAction(const IntVector& coordinate);
-    virtual ~AbstractCoordinateAction() = 0;
+    using Clock = std::chrono::steady_clock;
+    enum class Type : std::uint8_t { none, exit, memory_report, snapshot,
+                                     rewind, select_particles, set_target,
+                                     change_selection_size, pan, zoom,
+                                     toggle_layer, toggle_hud };
+    InputAction();
+    static InputAction exit(Clock::time_point time);
+    static InputAction memoryReport(Clock::time_point time);
+    static InputAction snapshot(Clock::time_point time);
+    static InputAction rewind(Clock::time_point time);
+    static InputAction selectParticles(const IntVector& coordinate,
+                                       Clock::time_point time);
+    static InputAction setTarget(const IntVector& coordinate,
+                                 Clock::time_point time);
+    static InputAction changeSelectionSize(float difference,
+                                           Clock::time_point time);
+    static InputAction pan(const IntVector& direction, Clock::time_point time);
+    static InputAction zoom(int steps, const IntVector& coordinate,
+                            Clock::time_point time);
+    static InputAction toggleLayer(unsigned int layer, Clock::time_point time);
+    static InputAction toggleHud(Clock::time_point time);
+    InputAction withCoordinate(const IntVector& coordinate) const;
+    Type getType() const;
     const IntVector& getCoordinate() const;
-    private:
-    const IntVector coordinate;
-};
-
-class ParticleSelectionAction : public AbstractCoordinateAction {
-    public:
-    ParticleSelectionAction(const IntVector& coordinate);
-};
-
-class TargetSettingAction : public AbstractCoordinateAction {
-    public:
-    TargetSettingAction(const IntVector& coordinate);
-};
-
-class SelectionSizeChangeAction : public InputAction {
-    public:
-    SelectionSizeChangeAction(float difference);
     float getDifference() const;
+    int getSteps() const;
+    unsigned int getLayer() const;
+    Clock::time_point getTime() const;
     private:
-    const float difference;
+    InputAction(Type type, const IntVector& coordinate, float difference,
+                int number, Clock::time_point time);
+    Type type;
+    IntVector coordinate;
+    float difference;
+    // The steps of a zoom or the layer to toggle.
+    int number;
+    Clock::time_point time;
 };
 
 }
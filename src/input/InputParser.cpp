@@ -2,7 +2,10 @@
 
 namespace wotmin2d {
 
-InputParser::InputParser(): event_buffer(nullptr) {
+InputParser::InputParser():
+    event_buffer(nullptr),
+    sdl_now(0),
+    now() {
     event_buffer = new SDL_Event[batch_size];
 }
 
@@ -10,19 +13,22 @@ InputParser::~InputParser() {
     delete[] event_buffer;
 }
 
-std::vector<std::unique_ptr<InputAction>> InputParser::parseInput() {
-    std::vector<std::unique_ptr<InputAction>> actions;
+// Replaces the contents of actions with the actions since the last call. The
+// vector is meant to be reused, so that parsing doesn't allocate once it has
+// grown to the largest burst of input.
+void InputParser::parseInput(std::vector<InputAction>& actions) {
+    actions.clear();
     SDL_PumpEvents();
+    sdl_now = SDL_GetTicks();
+    now = InputAction::Clock::now();
     // Get rid of anything that isn't interesting.
     std::initializer_list<std::uint32_t> interesting = {
         SDL_MOUSEBUTTONDOWN, SDL_KEYDOWN, SDL_MOUSEWHEEL
     };
     SDL_FilterEvents(&isAnyOf, &interesting);
-    addActions(SDL_KEYDOWN, &parseKeyDown, std::back_inserter(actions));
-    addActions(SDL_MOUSEBUTTONDOWN, &parseMouseDown,
-               std::back_inserter(actions));
-    addActions(SDL_MOUSEWHEEL, &parseMouseWheel, std::back_inserter(actions));
-    return actions;
+    addActions(SDL_KEYDOWN, &parseKeyDown, actions);
+    addActions(SDL_MOUSEBUTTONDOWN, &parseMouseDown, actions);
+    addActions(SDL_MOUSEWHEEL, &parseMouseWheel, actions);
 }
 
 int InputParser::isAnyOf(void* data, SDL_Event* event) {
@@ -37,38 +43,98 @@ int InputParser::isAnyOf(void* data, SDL_Event* event) {
     return false;
 }
 
-std::unique_ptr<InputAction> InputParser::parseKeyDown(SDL_Event& event) {
-    SDL_KeyboardEvent& key_event = event.key;
-    if (key_event.keysym.sym == SDLK_ESCAPE) {
-        return std::unique_ptr<InputAction>(new ExitAction);
+bool InputParser::parseKeyDown(const SDL_Event& event, Time time,
+                               InputAction& action) {
+    const SDL_KeyboardEvent& key_event = event.key;
+    switch (key_event.keysym.sym) {
+    case SDLK_ESCAPE:
+        action = InputAction::exit(time);
+        return true;
+    case SDLK_m:
+        action = InputAction::memoryReport(time);
+        return true;
+    case SDLK_s:
+        action = InputAction::snapshot(time);
+        return true;
+    case SDLK_BACKSPACE:
+        action = InputAction::rewind(time);
+        return true;
+    case SDLK_LEFT:
+        action = InputAction::pan(IntVector(-1, 0), time);
+        return true;
+    case SDLK_RIGHT:
+        action = InputAction::pan(IntVector(1, 0), time);
+        return true;
+    case SDLK_UP:
+        action = InputAction::pan(IntVector(0, 1), time);
+        return true;
+    case SDLK_DOWN:
+        action = InputAction::pan(IntVector(0, -1), time);
+        return true;
+    case SDLK_PLUS:
+    case SDLK_EQUALS:
+        action = InputAction::zoom(1, getMousePosition(), time);
+        return true;
+    case SDLK_MINUS:
+        action = InputAction::zoom(-1, getMousePosition(), time);
+        return true;
+    case SDLK_F1:
+        action = InputAction::toggleLayer(DebugSnapshot::pressure_layer, time);
+        return true;
+    case SDLK_F2:
+        action = InputAction::toggleLayer(DebugSnapshot::strength_layer, time);
+        return true;
+    case SDLK_F3:
+        action = InputAction::toggleLayer(DebugSnapshot::leadership_layer,
+                                          time);
+        return true;
+    case SDLK_F4:
+        action = InputAction::toggleHud(time);
+        return true;
     }
-    return nullptr;
+    return false;
+}
+
+IntVector InputParser::getMousePosition() {
+    int x, y;
+    SDL_GetMouseState(&x, &y);
+    return IntVector(x, y);
 }
 
-std::unique_ptr<InputAction> InputParser::parseMouseDown(SDL_Event& event) {
-    SDL_MouseButtonEvent& mouse_event = event.button;
-    int x = mouse_event.x;
-    int y = mouse_event.y;
+bool InputParser::parseMouseDown(const SDL_Event& event, Time time,
+                                 InputAction& action) {
+    const SDL_MouseButtonEvent& mouse_event = event.button;
+    IntVector coordinate(mouse_event.x, mouse_event.y);
     switch (mouse_event.button) {
     case SDL_BUTTON_LEFT:
-        return std::unique_ptr<InputAction>(
-            new ParticleSelectionAction(IntVector(x, y)));
-        break;
+        action = InputAction::selectParticles(coordinate, time);
+        return true;
     case SDL_BUTTON_RIGHT:
-        return std::unique_ptr<InputAction>(
-            new TargetSettingAction(IntVector(x, y)));
-        break;
+        action = InputAction::setTarget(coordinate, time);
+        return true;
     }
-    return nullptr;
+    return false;
 }
 
-std::unique_ptr<InputAction> InputParser::parseMouseWheel(SDL_Event& event) {
-    SDL_MouseWheelEvent wheel_event = event.wheel;
+bool InputParser::parseMouseWheel(const SDL_Event& event, Time time,
+                                  InputAction& action) {
+    const SDL_MouseWheelEvent& wheel_event = event.wheel;
     int y = wheel_event.y;
     float difference = static_cast<float>(y)
                        * Config::selection_change_multiplier;
-    return std::unique_ptr<InputAction>(
-        new SelectionSizeChangeAction(difference));
+    action = InputAction::changeSelectionSize(difference, time);
+    return true;
+}
+
+// SDL timestamps events in milliseconds since SDL was initialized. Differences
+// are taken modulo 2^32, so the wrap-around after 49 days doesn't matter.
+// Events stamped after parsing started count as happening right then.
+InputParser::Time InputParser::toClockTime(std::uint32_t timestamp) const {
+    std::uint32_t age = sdl_now - timestamp;
+    if (age > std::numeric_limits<std::uint32_t>::max() / 2) {
+        age = 0;
+    }
+    return now - std::chrono::milliseconds(age);
 }
 
 int InputParser::getEvents(std::uint32_t type) {
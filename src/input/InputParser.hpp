@@ -3,11 +3,14 @@
 
 #include "InputAction.hpp"
 #include "../game/State.hpp"
+#include "../display/DebugSnapshot.hpp"
 
 #include <SDL.h>
-#include <memory>
+#include <limits>
+#include <chrono>
 #include <cstdint>
-#include <iterator>
+#include <vector>
+#include <cassert>
 #include <initializer_list>
 
 namespace wotmin2d {
@@ -19,34 +22,46 @@ class InputParser {
     InputParser(const InputParser&) = delete;
     InputParser& operator=(const InputParser&) = delete;
     // Needs to be called from the main loop.
-    std::vector<std::unique_ptr<InputAction>> parseInput();
+    void parseInput(std::vector<InputAction>& actions);
     private:
+    using Time = InputAction::Clock::time_point;
     static int isAnyOf(void*, SDL_Event* event);
-    static std::unique_ptr<InputAction> parseMouseDown(SDL_Event& event);
-    static std::unique_ptr<InputAction> parseKeyDown(SDL_Event& event);
-    static std::unique_ptr<InputAction> parseMouseWheel(SDL_Event& event);
-    template<class P, class I>
-    void addActions(std::uint32_t type, P parser, I inserter);
+    static bool parseMouseDown(const SDL_Event& event, Time time,
+                               InputAction& action);
+    static bool parseKeyDown(const SDL_Event& event, Time time,
+                             InputAction& action);
+    static bool parseMouseWheel(const SDL_Event& event, Time time,
+                                InputAction& action);
+    static IntVector getMousePosition();
+    template<class P>
+    void addActions(std::uint32_t type, P parser,
+                    std::vector<InputAction>& actions);
+    Time toClockTime(std::uint32_t timestamp) const;
     int getEvents(std::uint32_t type);
     constexpr static int batch_size = 10;
     SDL_Event* event_buffer;
+    // SDL's and the steady clock's time when parsing started, to convert
+    // event timestamps.
+    std::uint32_t sdl_now;
+    Time now;
 };
 
-template<class P, class I>
-void InputParser::addActions(std::uint32_t type, P parser, I inserter) {
+template<class P>
+void InputParser::addActions(std::uint32_t type, P parser,
+                             std::vector<InputAction>& actions) {
     int num_events = getEvents(type);
     while (num_events > 0) {
         assert(num_events >= 0);
         unsigned int unsigned_num_events = num_events;
         for (unsigned int i = 0; i < unsigned_num_events; i++) {
-            std::unique_ptr<InputAction> action = parser(event_buffer[i]);
-            if (action != nullptr) {
-                inserter = parser(event_buffer[i]);
+            const SDL_Event& event = event_buffer[i];
+            InputAction action;
+            if (parser(event, toClockTime(event.common.timestamp), action)) {
+                actions.push_back(action);
             }
         }
         num_events = getEvents(type);
     }
-
 }
 
 }
@@ -0,0 +1,63 @@
+#ifndef BACKGROUNDWRITER_HPP
+#define BACKGROUNDWRITER_HPP
+
+#include "IoException.hpp"
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <utility>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstddef>
+
+namespace wotmin2d {
+
+/**
+ * A thread that writes items in the order they're queued, so that whoever
+ * produces them doesn't wait for the disk. How an item is written is up to
+ * the write function, which runs on the thread. Written items are kept to be
+ * reused (see takeSpare()), so items that hold buffers stop allocating once
+ * enough of them have reached their size.
+ *
+ * If the thread falls more than max_pending items behind, enqueue() blocks
+ * until it catches up, so nothing is lost. Once the write function has thrown
+ * an IoException, the items that follow are dropped, and the error is thrown
+ * by the next call to enqueue(), flush() or checkError().
+ */
+template<class Item>
+class BackgroundWriter {
+    public:
+    // Gets the item and whether there were no more items pending when it was
+    // taken from the queue.
+    using WriteFunction = std::function<void(const Item&, bool)>;
+    BackgroundWriter(std::size_t max_pending, WriteFunction write_function);
+    BackgroundWriter(const BackgroundWriter&) = delete;
+    BackgroundWriter& operator=(const BackgroundWriter&) = delete;
+    ~BackgroundWriter();
+    Item takeSpare();
+    void enqueue(Item&& item);
+    void flush();
+    void checkError();
+    private:
+    void run();
+    const std::size_t max_pending;
+    const WriteFunction write_function;
+    std::mutex mutex;
+    std::condition_variable work_available;
+    std::condition_variable work_done;
+    std::deque<Item> pending;
+    std::vector<Item> spares;
+    bool writing;
+    bool stopping;
+    std::string error;
+    std::thread thread;
+};
+
+}
+
+#include "BackgroundWriter.tpp"
+
+#endif
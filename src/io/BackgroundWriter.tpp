@@ -0,0 +1,112 @@
+namespace wotmin2d {
+
+template<class Item>
+BackgroundWriter<Item>::BackgroundWriter(std::size_t max_pending,
+                                         WriteFunction write_function) :
+    max_pending(max_pending),
+    write_function(std::move(write_function)),
+    mutex(),
+    work_available(),
+    work_done(),
+    pending(),
+    spares(),
+    writing(false),
+    stopping(false),
+    error(),
+    thread(&BackgroundWriter::run, this) {}
+
+// Writes the items that are still pending before returning. Errors are
+// ignored, call flush() first to find out about them.
+template<class Item>
+BackgroundWriter<Item>::~BackgroundWriter() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    work_available.notify_one();
+    thread.join();
+}
+
+// Returns an item that has been written, or a new one if there is none, to be
+// filled and queued again.
+template<class Item>
+Item BackgroundWriter<Item>::takeSpare() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (spares.empty()) {
+        return Item();
+    }
+    Item item = std::move(spares.back());
+    spares.pop_back();
+    return item;
+}
+
+template<class Item>
+void BackgroundWriter<Item>::enqueue(Item&& item) {
+    checkError();
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        work_done.wait(lock, [this]() {
+            return pending.size() < max_pending;
+        });
+        pending.push_back(std::move(item));
+    }
+    work_available.notify_one();
+}
+
+// Waits until all items are written.
+template<class Item>
+void BackgroundWriter<Item>::flush() {
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        work_done.wait(lock, [this]() {
+            return pending.empty() && !writing;
+        });
+    }
+    checkError();
+}
+
+template<class Item>
+void BackgroundWriter<Item>::checkError() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!error.empty()) {
+        throw IoException(error);
+    }
+}
+
+// Runs on the background thread. After an error, items are still taken from
+// the queue so that enqueue() doesn't block, but they are dropped.
+template<class Item>
+void BackgroundWriter<Item>::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        work_available.wait(lock, [this]() {
+            return !pending.empty() || stopping;
+        });
+        if (pending.empty()) {
+            return;
+        }
+        Item item = std::move(pending.front());
+        pending.pop_front();
+        writing = true;
+        bool failed = !error.empty();
+        bool idle = pending.empty();
+        lock.unlock();
+        std::string write_error;
+        if (!failed) {
+            try {
+                write_function(item, idle);
+            } catch (const IoException& e) {
+                write_error = e.what();
+            }
+        }
+        lock.lock();
+        if (!write_error.empty()) {
+            error = write_error;
+        }
+        spares.push_back(std::move(item));
+        writing = false;
+        work_done.notify_all();
+    }
+}
+
+}
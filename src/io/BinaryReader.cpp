@@ -0,0 +1,97 @@
+#include "BinaryReader.hpp"
+
+namespace wotmin2d {
+
+// The owner is kept alive as long as the reader or any of the shared pointers
+// returned by readShared() exists.
+BinaryReader::BinaryReader(const std::uint8_t* data, std::size_t size,
+                           std::shared_ptr<const void> owner) :
+    data(data),
+    size(size),
+    offset(0),
+    owner(owner) {}
+
+BinaryReader::BinaryReader(std::shared_ptr<const MappedFile> file) :
+    BinaryReader(file->getData(), file->getSize(), file) {}
+
+// Returns a pointer to the next count bytes without copying them. It's only
+// valid as long as the underlying memory is.
+const std::uint8_t* BinaryReader::readBytes(std::size_t count) {
+    require(count);
+    const std::uint8_t* bytes = data + offset;
+    offset += count;
+    return bytes;
+}
+
+// Like readBytes(), but the returned pointer keeps the underlying memory
+// alive. If the reader doesn't have an owner for its memory, the bytes are
+// copied.
+std::shared_ptr<const std::uint8_t> BinaryReader::readShared(
+    std::size_t count)
+{
+    const std::uint8_t* bytes = readBytes(count);
+    if (owner != nullptr) {
+        return std::shared_ptr<const std::uint8_t>(owner, bytes);
+    }
+    std::shared_ptr<std::uint8_t> copy(new std::uint8_t[count],
+                                       std::default_delete<std::uint8_t[]>());
+    if (count > 0) {
+        std::memcpy(copy.get(), bytes, count);
+    }
+    return copy;
+}
+
+// Reads and checks a header written by BinaryWriter::writeHeader() and
+// returns the version of the format.
+std::uint32_t BinaryReader::readHeader(const char (&magic)[8],
+                                       std::uint32_t max_version) {
+    const std::uint8_t* file_magic = readBytes(sizeof(magic));
+    if (std::memcmp(file_magic, magic, sizeof(magic)) != 0) {
+        throw IoException("Unknown file type, expected "
+                          + std::string(magic) + ".");
+    }
+    if (read<std::uint32_t>() != 0x01020304) {
+        throw IoException("File was written with a different byte order.");
+    }
+    std::uint32_t version = read<std::uint32_t>();
+    if (version == 0 || version > max_version) {
+        throw IoException("Unsupported version " + std::to_string(version)
+                          + " of " + std::string(magic) + ".");
+    }
+    return version;
+}
+
+// Skips padding up to the next offset that is a multiple of alignment.
+void BinaryReader::align(std::size_t alignment) {
+    std::size_t misalignment = offset % alignment;
+    if (misalignment != 0) {
+        readBytes(alignment - misalignment);
+    }
+}
+
+void BinaryReader::seek(std::size_t offset) {
+    if (offset > size) {
+        throw IoException("Attempt to seek past the end of the file.");
+    }
+    this->offset = offset;
+}
+
+std::size_t BinaryReader::getOffset() const {
+    return offset;
+}
+
+std::size_t BinaryReader::getSize() const {
+    return size;
+}
+
+std::size_t BinaryReader::getRemaining() const {
+    return size - offset;
+}
+
+void BinaryReader::require(std::size_t count) const {
+    if (count > size - offset) {
+        throw IoException("Unexpected end of file.");
+    }
+}
+
+}
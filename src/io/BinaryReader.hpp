@@ -0,0 +1,73 @@
+#ifndef BINARYREADER_HPP
+#define BINARYREADER_HPP
+
+#include "IoException.hpp"
+#include "MappedFile.hpp"
+
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+namespace wotmin2d {
+
+/**
+ * Reads values in the layout written by BinaryWriter from a range of memory,
+ * usually a MappedFile. Reading past the end throws an IoException.
+ *
+ * Values are read in host byte order, files contain a byte order mark in their
+ * header (see readHeader()) so that files from a machine with different byte
+ * order are rejected instead of misread.
+ */
+class BinaryReader {
+    public:
+    BinaryReader(const std::uint8_t* data, std::size_t size,
+                 std::shared_ptr<const void> owner = nullptr);
+    explicit BinaryReader(std::shared_ptr<const MappedFile> file);
+    template<class T>
+    T read();
+    template<class T>
+    void readArray(T* destination, std::size_t count);
+    const std::uint8_t* readBytes(std::size_t count);
+    std::shared_ptr<const std::uint8_t> readShared(std::size_t count);
+    std::uint32_t readHeader(const char (&magic)[8],
+                             std::uint32_t max_version);
+    void align(std::size_t alignment);
+    void seek(std::size_t offset);
+    std::size_t getOffset() const;
+    std::size_t getSize() const;
+    std::size_t getRemaining() const;
+    private:
+    void require(std::size_t count) const;
+    const std::uint8_t* data;
+    std::size_t size;
+    std::size_t offset;
+    std::shared_ptr<const void> owner;
+};
+
+template<class T>
+T BinaryReader::read() {
+    static_assert(std::is_trivially_copyable<T>::value, "Only trivially "
+                  "copyable values can be read.");
+    T value;
+    readArray(&value, 1);
+    return value;
+}
+
+template<class T>
+void BinaryReader::readArray(T* destination, std::size_t count) {
+    static_assert(std::is_trivially_copyable<T>::value, "Only trivially "
+                  "copyable values can be read.");
+    std::size_t byte_count = count * sizeof(T);
+    require(byte_count);
+    if (byte_count > 0) {
+        std::memcpy(destination, data + offset, byte_count);
+    }
+    offset += byte_count;
+}
+
+}
+
+#endif
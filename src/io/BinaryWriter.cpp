@@ -0,0 +1,51 @@
+#include "BinaryWriter.hpp"
+
+namespace wotmin2d {
+
+BinaryWriter::BinaryWriter(std::ostream& stream) :
+    stream(stream),
+    offset(0) {}
+
+void BinaryWriter::writeBytes(const void* bytes, std::size_t count) {
+    stream.write(static_cast<const char*>(bytes),
+                 static_cast<std::streamsize>(count));
+    if (!stream) {
+        throw IoException("Error writing to file.");
+    }
+    offset += count;
+}
+
+// Writes the magic identifying the file type, a byte order mark and the
+// version of the format.
+void BinaryWriter::writeHeader(const char (&magic)[8], std::uint32_t version) {
+    writeBytes(magic, sizeof(magic));
+    write<std::uint32_t>(0x01020304);
+    write(version);
+}
+
+// Writes zeros up to the next offset that is a multiple of alignment.
+void BinaryWriter::align(std::size_t alignment) {
+    const char zeros[16] = {};
+    std::size_t misalignment = offset % alignment;
+    if (misalignment == 0) {
+        return;
+    }
+    std::size_t padding = alignment - misalignment;
+    for (; padding > sizeof(zeros); padding -= sizeof(zeros)) {
+        writeBytes(zeros, sizeof(zeros));
+    }
+    writeBytes(zeros, padding);
+}
+
+void BinaryWriter::flush() {
+    stream.flush();
+    if (!stream) {
+        throw IoException("Error flushing file.");
+    }
+}
+
+std::uint64_t BinaryWriter::getOffset() const {
+    return offset;
+}
+
+}
@@ -0,0 +1,48 @@
+#ifndef BINARYWRITER_HPP
+#define BINARYWRITER_HPP
+
+#include "IoException.hpp"
+
+#include <ostream>
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+
+namespace wotmin2d {
+
+/**
+ * Writes values in host byte order to a stream, in a layout that can be read
+ * back by BinaryReader.
+ */
+class BinaryWriter {
+    public:
+    BinaryWriter(std::ostream& stream);
+    template<class T>
+    void write(const T& value);
+    template<class T>
+    void writeArray(const T* values, std::size_t count);
+    void writeBytes(const void* bytes, std::size_t count);
+    void writeHeader(const char (&magic)[8], std::uint32_t version);
+    void align(std::size_t alignment);
+    void flush();
+    std::uint64_t getOffset() const;
+    private:
+    std::ostream& stream;
+    std::uint64_t offset;
+};
+
+template<class T>
+void BinaryWriter::write(const T& value) {
+    writeArray(&value, 1);
+}
+
+template<class T>
+void BinaryWriter::writeArray(const T* values, std::size_t count) {
+    static_assert(std::is_trivially_copyable<T>::value, "Only trivially "
+                  "copyable values can be written.");
+    writeBytes(values, count * sizeof(T));
+}
+
+}
+
+#endif
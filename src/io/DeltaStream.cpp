@@ -0,0 +1,221 @@
+#include "DeltaStream.hpp"
+
+#include <memory>
+
+namespace wotmin2d {
+
+namespace {
+
+constexpr char magic[8] = "WM2DDLT";
+constexpr std::uint32_t version = 1;
+
+void writeVarint(std::vector<std::uint8_t>& buffer, std::uint64_t value) {
+    while (value >= 0x80) {
+        buffer.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    buffer.push_back(static_cast<std::uint8_t>(value));
+}
+
+// Zigzag encoding, so that small negative numbers are small as well.
+void writeSignedVarint(std::vector<std::uint8_t>& buffer, std::int64_t value) {
+    writeVarint(buffer, (static_cast<std::uint64_t>(value) << 1)
+                        ^ static_cast<std::uint64_t>(value >> 63));
+}
+
+std::uint64_t readVarint(BinaryReader& reader) {
+    std::uint64_t value = 0;
+    for (unsigned int shift = 0; shift < 64; shift += 7) {
+        std::uint8_t byte = reader.read<std::uint8_t>();
+        value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+            return value;
+        }
+    }
+    throw IoException("Delta stream has an invalid number.");
+}
+
+std::int64_t readSignedVarint(BinaryReader& reader) {
+    std::uint64_t value = readVarint(reader);
+    return static_cast<std::int64_t>(value >> 1)
+           ^ -static_cast<std::int64_t>(value & 1);
+}
+
+// Consecutive changes of the same type (and for moves, direction) form a run
+// that shares one header.
+bool sameRun(const ChangeLog::Change& first, const ChangeLog::Change& second) {
+    return first.getType() == second.getType()
+           && (first.getType() != ChangeLog::Change::Type::move
+               || first.getDirection() == second.getDirection());
+}
+
+Direction decodeDirection(std::uint64_t value) {
+    for (Direction direction: Direction::all()) {
+        if (static_cast<Direction::val_t>(direction) == value) {
+            return direction;
+        }
+    }
+    assert(false && "Two bits are always a direction.");
+    return Direction::north();
+}
+
+}
+
+constexpr std::size_t DeltaStreamWriter::max_pending;
+
+// Layout (fixed size values in host byte order):
+// header, the initial state (see SnapshotFile), padding to 8 bytes, then one
+// frame per tick with changes, all numbers as LEB128 varints, signed ones
+// zigzag encoded:
+//     tick minus tick of the previous frame, number of blobs, then per blob
+//     player id, number of changes, then runs of changes:
+//         run length << 4 | type << 2 | direction
+//         per change: x and y (signed) relative to the position of the
+//         previous change in the blob (the origin for the first), health if
+//         the type is damage
+DeltaStreamWriter::DeltaStreamWriter(const std::string& path,
+                                     const StateSnapshot& initial_state) :
+    stream(path, std::ios::binary | std::ios::trunc),
+    writer(stream),
+    blob_changes(),
+    last_tick(0),
+    background(max_pending,
+               [this](const std::vector<std::uint8_t>& buffer, bool idle) {
+                   write(buffer, idle);
+               }) {
+    if (!stream) {
+        throw IoException("Error opening " + path + " for writing.");
+    }
+    writer.writeHeader(magic, version);
+    SnapshotFile::write(initial_state, writer);
+    writer.align(8);
+    writer.flush();
+}
+
+// Waits until all ticks are written to the file.
+void DeltaStreamWriter::flush() {
+    background.flush();
+}
+
+void DeltaStreamWriter::encodeTick(std::uint64_t tick,
+                                   std::vector<std::uint8_t>& buffer) {
+    buffer.clear();
+    writeVarint(buffer, tick - last_tick);
+    writeVarint(buffer, blob_changes.size());
+    for (const auto& id_changes: blob_changes) {
+        const std::vector<ChangeLog::Change>& changes
+            = id_changes.second->getChanges();
+        writeVarint(buffer, id_changes.first);
+        writeVarint(buffer, changes.size());
+        IntVector last_position(0, 0);
+        for (auto run = changes.begin(); run != changes.end();) {
+            auto run_end = std::find_if(run + 1, changes.end(),
+                [&](const ChangeLog::Change& change) {
+                    return !sameRun(*run, change);
+                });
+            writeVarint(buffer,
+                static_cast<std::uint64_t>(run_end - run) << 4
+                | static_cast<std::uint64_t>(run->getType()) << 2
+                | static_cast<Direction::val_t>(run->getDirection()));
+            for (; run != run_end; run++) {
+                const IntVector& position = run->getPosition();
+                writeSignedVarint(buffer,
+                                  position.getX() - last_position.getX());
+                writeSignedVarint(buffer,
+                                  position.getY() - last_position.getY());
+                if (run->getType() == ChangeLog::Change::Type::damage) {
+                    writeVarint(buffer, run->getHealth());
+                }
+                last_position = position;
+            }
+        }
+    }
+}
+
+// Runs on the background thread.
+void DeltaStreamWriter::write(const std::vector<std::uint8_t>& buffer,
+                              bool idle) {
+    writer.writeBytes(buffer.data(), buffer.size());
+    // Only flush once the queue is empty, a crash loses at most what was
+    // written since.
+    if (idle) {
+        writer.flush();
+    }
+}
+
+DeltaStreamReader::DeltaStreamReader(const std::string& path) :
+    reader(std::make_shared<const MappedFile>(path)),
+    initial_state(),
+    last_tick(0) {
+    reader.readHeader(magic, version);
+    SnapshotFile::read(reader, initial_state);
+    reader.align(8);
+}
+
+const StateSnapshot& DeltaStreamReader::getInitialState() const {
+    return initial_state;
+}
+
+// Reads the changes of the next tick that had any. Returns false at the end of
+// the stream.
+bool DeltaStreamReader::readTick(std::uint64_t& tick, TickChanges& changes) {
+    if (reader.getRemaining() == 0) {
+        return false;
+    }
+    changes.clear();
+    last_tick += readVarint(reader);
+    tick = last_tick;
+    std::uint64_t blob_count = readVarint(reader);
+    for (std::uint64_t i = 0; i < blob_count; i++) {
+        std::uint64_t player_id = readVarint(reader);
+        if (player_id > 0xff || changes.count(player_id) > 0) {
+            throw IoException("Delta stream has an invalid player.");
+        }
+        std::vector<ChangeLog::Change>& blob_changes
+            = changes[static_cast<PlayerId>(player_id)];
+        std::uint64_t change_count = readVarint(reader);
+        // Every change takes at least two bytes.
+        if (change_count > reader.getRemaining() / 2) {
+            throw IoException("Delta stream is truncated.");
+        }
+        blob_changes.reserve(change_count);
+        IntVector position(0, 0);
+        while (blob_changes.size() < change_count) {
+            std::uint64_t run_header = readVarint(reader);
+            std::uint64_t run_length = run_header >> 4;
+            std::uint64_t type = (run_header >> 2) & 3;
+            Direction direction = decodeDirection(run_header & 3);
+            if (run_length == 0
+                || run_length > change_count - blob_changes.size()
+                || type > static_cast<std::uint64_t>(
+                              ChangeLog::Change::Type::death)) {
+                throw IoException("Delta stream has an invalid change.");
+            }
+            for (std::uint64_t j = 0; j < run_length; j++) {
+                int x = static_cast<int>(position.getX()
+                                         + readSignedVarint(reader));
+                int y = static_cast<int>(position.getY()
+                                         + readSignedVarint(reader));
+                position = IntVector(x, y);
+                switch (static_cast<ChangeLog::Change::Type>(type)) {
+                case ChangeLog::Change::Type::move:
+                    blob_changes.push_back(
+                        ChangeLog::Change::move(position, direction));
+                    break;
+                case ChangeLog::Change::Type::damage:
+                    blob_changes.push_back(ChangeLog::Change::damage(
+                        position,
+                        static_cast<unsigned int>(readVarint(reader))));
+                    break;
+                case ChangeLog::Change::Type::death:
+                    blob_changes.push_back(
+                        ChangeLog::Change::death(position));
+                    break;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+}
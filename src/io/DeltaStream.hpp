@@ -0,0 +1,111 @@
+#ifndef DELTASTREAM_HPP
+#define DELTASTREAM_HPP
+
+#include "BinaryReader.hpp"
+#include "BinaryWriter.hpp"
+#include "IoException.hpp"
+#include "BackgroundWriter.hpp"
+#include "MappedFile.hpp"
+#include "SnapshotFile.hpp"
+#include "../game/ChangeLog.hpp"
+#include "../game/Snapshot.hpp"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <utility>
+#include <algorithm>
+#include <fstream>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+namespace wotmin2d {
+
+/**
+ * Writes a complete log of a battle: a snapshot of the state it started with,
+ * then for each tick only the particles that moved, were damaged or died (see
+ * ChangeLog). Changes are stored as small position differences in a variable
+ * length encoding, and consecutive changes of the same kind share a header,
+ * so a tick in which a few hundred particles move costs a few hundred bytes.
+ *
+ * Ticks are encoded by the caller, but written to the file by a
+ * BackgroundWriter, so the simulation doesn't wait for the disk. If the
+ * thread falls more than max_pending ticks behind, writeTick() blocks until it
+ * catches up. Errors of the background thread are thrown as IoException by the
+ * next call to writeTick() or flush().
+ */
+class DeltaStreamWriter {
+    public:
+    using PlayerId = StateSnapshot::PlayerId;
+    DeltaStreamWriter(const std::string& path,
+                      const StateSnapshot& initial_state);
+    DeltaStreamWriter(const DeltaStreamWriter&) = delete;
+    DeltaStreamWriter& operator=(const DeltaStreamWriter&) = delete;
+    template<class S>
+    void writeTick(std::uint64_t tick, const S& state);
+    void flush();
+    constexpr static std::size_t max_pending = 64;
+    private:
+    using BlobChanges = std::vector<std::pair<PlayerId, const ChangeLog*>>;
+    void encodeTick(std::uint64_t tick, std::vector<std::uint8_t>& buffer);
+    void write(const std::vector<std::uint8_t>& buffer, bool idle);
+    std::ofstream stream;
+    BinaryWriter writer;
+    BlobChanges blob_changes;
+    std::uint64_t last_tick;
+    // Declared last, so its thread is stopped before anything it uses.
+    BackgroundWriter<std::vector<std::uint8_t>> background;
+};
+
+/**
+ * Reads a file written by DeltaStreamWriter tick by tick. Applying the changes
+ * of each tick to the initial state in order gives the positions and health of
+ * all particles after that tick.
+ */
+class DeltaStreamReader {
+    public:
+    using PlayerId = StateSnapshot::PlayerId;
+    using TickChanges = std::map<PlayerId, std::vector<ChangeLog::Change>>;
+    DeltaStreamReader(const std::string& path);
+    const StateSnapshot& getInitialState() const;
+    bool readTick(std::uint64_t& tick, TickChanges& changes);
+    private:
+    BinaryReader reader;
+    StateSnapshot initial_state;
+    std::uint64_t last_tick;
+};
+
+// Writes the changes of all blobs of the state during the given tick. Nothing
+// is written if there weren't any. Change logging must have been enabled on
+// the state before the tick started.
+template<class S>
+void DeltaStreamWriter::writeTick(std::uint64_t tick, const S& state) {
+    assert(tick >= last_tick && "Ticks must be written in order.");
+    background.checkError();
+    blob_changes.clear();
+    for (const auto& id_blob: state.getBlobs()) {
+        const ChangeLog& changes = id_blob.second.getChanges();
+        if (!changes.getChanges().empty()) {
+            blob_changes.emplace_back(id_blob.first, &changes);
+        }
+    }
+    if (blob_changes.empty()) {
+        return;
+    }
+    // The blobs of a state aren't ordered, but the file should be the same
+    // for the same battle.
+    std::sort(blob_changes.begin(), blob_changes.end(),
+              [](const std::pair<PlayerId, const ChangeLog*>& first,
+                 const std::pair<PlayerId, const ChangeLog*>& second) {
+                  return first.first < second.first;
+              });
+    std::vector<std::uint8_t> buffer = background.takeSpare();
+    encodeTick(tick, buffer);
+    last_tick = tick;
+    background.enqueue(std::move(buffer));
+}
+
+}
+
+#endif
@@ -0,0 +1,183 @@
+#include "FrameRing.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace wotmin2d {
+
+namespace {
+
+constexpr char magic[8] = "WM2DFRM";
+constexpr std::uint32_t version = 1;
+constexpr std::size_t cache_line = 64;
+
+// Readers in other processes only see the memory, so the atomics must not
+// need a lock living somewhere else.
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2,
+              "Frame rings need lock-free 64-bit atomics.");
+
+std::size_t alignToCacheLine(std::size_t size) {
+    return (size + cache_line - 1) / cache_line * cache_line;
+}
+
+std::size_t headerSize() {
+    return alignToCacheLine(sizeof(FrameRingHeader));
+}
+
+}
+
+constexpr unsigned int FrameRingWriter::default_slot_count;
+
+// Creates the shared memory object with the given name (which starts with a
+// slash, see shm_open()), replacing one that is left over.
+FrameRingWriter::FrameRingWriter(const std::string& name,
+                                 unsigned int max_width,
+                                 unsigned int max_height,
+                                 unsigned int slot_count) :
+    name(name),
+    size(0),
+    header(nullptr),
+    writing(nullptr) {
+    assert(slot_count > 0);
+    std::size_t slot_size = alignToCacheLine(
+        sizeof(FrameRingSlot)
+        + static_cast<std::size_t>(max_width) * max_height * 3);
+    size = headerSize() + slot_count * slot_size;
+    int fd = shm_open(name.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0600);
+    if (fd == -1) {
+        throw IoException("Error creating shared memory " + name + ".",
+                          errno);
+    }
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        int error_number = errno;
+        close(fd);
+        shm_unlink(name.c_str());
+        throw IoException("Error resizing shared memory " + name + ".",
+                          error_number);
+    }
+    void* address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                         fd, 0);
+    int error_number = errno;
+    close(fd);
+    if (address == MAP_FAILED) {
+        shm_unlink(name.c_str());
+        throw IoException("Error mapping shared memory " + name + ".",
+                          error_number);
+    }
+    // The memory is zero, so frames and sequences start at 0.
+    header = new (address) FrameRingHeader;
+    std::memcpy(header->magic, magic, sizeof(magic));
+    header->version = version;
+    header->slot_count = slot_count;
+    header->max_width = max_width;
+    header->max_height = max_height;
+    header->slot_size = slot_size;
+    header->frames.store(0, std::memory_order_relaxed);
+    std::uint8_t* slots = static_cast<std::uint8_t*>(address) + headerSize();
+    for (unsigned int i = 0; i < slot_count; i++) {
+        FrameRingSlot* slot
+            = new (slots + i * slot_size) FrameRingSlot;
+        slot->sequence.store(0, std::memory_order_relaxed);
+        slot->frame = 0;
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+FrameRingWriter::~FrameRingWriter() {
+    munmap(header, size);
+    shm_unlink(name.c_str());
+}
+
+// Returns where to put the pixels of the next frame, or nullptr if it's larger
+// than the maximum size. Readers skip the slot until endFrame() is called.
+std::uint8_t* FrameRingWriter::beginFrame(unsigned int width,
+                                          unsigned int height) {
+    assert(writing == nullptr && "Frame begun twice.");
+    if (width > header->max_width || height > header->max_height) {
+        return nullptr;
+    }
+    std::uint64_t frame = header->frames.load(std::memory_order_relaxed) + 1;
+    writing = reinterpret_cast<FrameRingSlot*>(
+        reinterpret_cast<std::uint8_t*>(header) + headerSize()
+        + (frame % header->slot_count) * header->slot_size);
+    std::uint64_t sequence
+        = writing->sequence.load(std::memory_order_relaxed);
+    writing->sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    writing->frame = frame;
+    writing->width = width;
+    writing->height = height;
+    return reinterpret_cast<std::uint8_t*>(writing + 1);
+}
+
+void FrameRingWriter::endFrame() {
+    assert(writing != nullptr && "Frame ended without beginning it.");
+    std::uint64_t sequence
+        = writing->sequence.load(std::memory_order_relaxed);
+    writing->sequence.store(sequence + 1, std::memory_order_release);
+    header->frames.store(writing->frame, std::memory_order_release);
+    writing = nullptr;
+}
+
+std::uint64_t FrameRingWriter::getFrameCount() const {
+    return header->frames.load(std::memory_order_relaxed);
+}
+
+// Maps the ring read-only.
+FrameRingReader::FrameRingReader(const std::string& name) :
+    size(0),
+    header(nullptr) {
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd == -1) {
+        throw IoException("Error opening shared memory " + name + ".", errno);
+    }
+    struct stat memory_stat;
+    if (fstat(fd, &memory_stat) != 0) {
+        int error_number = errno;
+        close(fd);
+        throw IoException("Error getting the size of shared memory " + name
+                          + ".", error_number);
+    }
+    size = static_cast<std::size_t>(memory_stat.st_size);
+    if (size < headerSize()) {
+        close(fd);
+        throw IoException("Shared memory " + name + " is no frame ring.");
+    }
+    void* address = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    int error_number = errno;
+    close(fd);
+    if (address == MAP_FAILED) {
+        throw IoException("Error mapping shared memory " + name + ".",
+                          error_number);
+    }
+    header = static_cast<const FrameRingHeader*>(address);
+    if (std::memcmp(header->magic, magic, sizeof(magic)) != 0
+        || header->version != version
+        || size < headerSize() + header->slot_count * header->slot_size) {
+        munmap(address, size);
+        throw IoException("Shared memory " + name + " is no frame ring.");
+    }
+}
+
+FrameRingReader::~FrameRingReader() {
+    munmap(const_cast<FrameRingHeader*>(header), size);
+}
+
+// Returns the number of the last frame that was completely written, 0 if there
+// is none yet.
+std::uint64_t FrameRingReader::getLatestFrame() const {
+    return header->frames.load(std::memory_order_acquire);
+}
+
+const FrameRingSlot& FrameRingReader::getSlot(std::uint64_t frame) const {
+    return *reinterpret_cast<const FrameRingSlot*>(
+        reinterpret_cast<const std::uint8_t*>(header) + headerSize()
+        + (frame % header->slot_count) * header->slot_size);
+}
+
+}
@@ -0,0 +1,112 @@
+#ifndef FRAMERING_HPP
+#define FRAMERING_HPP
+
+#include "IoException.hpp"
+
+#include <string>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+namespace wotmin2d {
+
+/**
+ * The layout of a frame ring in shared memory: this header, then slot_count
+ * slots of slot_size bytes each, every one a FrameRingSlot followed by the
+ * pixels. Both are aligned to cache lines.
+ */
+struct FrameRingHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t slot_count;
+    std::uint32_t max_width;
+    std::uint32_t max_height;
+    std::uint64_t slot_size;
+    // The number of the last frame that was completely written.
+    std::atomic<std::uint64_t> frames;
+};
+
+struct FrameRingSlot {
+    // Odd while the slot is being written.
+    std::atomic<std::uint64_t> sequence;
+    std::uint64_t frame;
+    std::uint32_t width;
+    std::uint32_t height;
+};
+
+/**
+ * Publishes frames through POSIX shared memory, so that other processes on the
+ * same machine (e.g. a monitor or a recorder) can read them in place, without
+ * sockets, copies or encoding.
+ *
+ * The shared memory holds a ring of slots, each big enough for a frame of the
+ * maximum size. Frames are numbered from 1, frame n goes into slot n %
+ * slot_count. Each slot is guarded by a sequence number that is odd while it's
+ * being written (a seqlock), so the writer never waits for readers: a reader
+ * that was overtaken finds that the sequence changed and skips the frame.
+ *
+ * Pixels are 8-bit RGB in rows starting at the top, like for FrameWriter. The
+ * shared memory object is removed when the writer is destroyed.
+ */
+class FrameRingWriter {
+    public:
+    FrameRingWriter(const std::string& name, unsigned int max_width,
+                    unsigned int max_height,
+                    unsigned int slot_count = default_slot_count);
+    FrameRingWriter(const FrameRingWriter&) = delete;
+    FrameRingWriter& operator=(const FrameRingWriter&) = delete;
+    ~FrameRingWriter();
+    std::uint8_t* beginFrame(unsigned int width, unsigned int height);
+    void endFrame();
+    std::uint64_t getFrameCount() const;
+    constexpr static unsigned int default_slot_count = 4;
+    private:
+    const std::string name;
+    std::size_t size;
+    FrameRingHeader* header;
+    FrameRingSlot* writing;
+};
+
+/**
+ * Reads frames published by a FrameRingWriter in another process (or the same
+ * one). The ring has to exist already.
+ */
+class FrameRingReader {
+    public:
+    explicit FrameRingReader(const std::string& name);
+    FrameRingReader(const FrameRingReader&) = delete;
+    FrameRingReader& operator=(const FrameRingReader&) = delete;
+    ~FrameRingReader();
+    std::uint64_t getLatestFrame() const;
+    template<class Visitor>
+    bool readFrame(std::uint64_t frame, Visitor visit) const;
+    private:
+    const FrameRingSlot& getSlot(std::uint64_t frame) const;
+    std::size_t size;
+    const FrameRingHeader* header;
+};
+
+// Calls visit(pixels, width, height) with the pixels of the frame where they
+// are, in shared memory. The writer may overwrite them meanwhile, so whatever
+// the visitor made of them is only valid if this returns true. Returns false
+// without visiting if the frame isn't (or no longer) in the ring.
+template<class Visitor>
+bool FrameRingReader::readFrame(std::uint64_t frame, Visitor visit) const {
+    if (frame == 0 || frame > getLatestFrame()) {
+        return false;
+    }
+    const FrameRingSlot& slot = getSlot(frame);
+    std::uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+    if (sequence % 2 == 1 || slot.frame != frame) {
+        return false;
+    }
+    visit(reinterpret_cast<const std::uint8_t*>(&slot + 1), slot.width,
+          slot.height);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.sequence.load(std::memory_order_relaxed) == sequence;
+}
+
+}
+
+#endif
@@ -0,0 +1,60 @@
+#include "FrameWriter.hpp"
+
+namespace wotmin2d {
+
+constexpr std::size_t FrameWriter::max_pending;
+
+FrameWriter::FrameWriter(const std::string& path_prefix) :
+    path_prefix(path_prefix),
+    frame_count(0),
+    background(max_pending, [this](const Frame& frame, bool) {
+        write(frame);
+    }) {}
+
+// Returns the buffer of a frame that has been written, or an empty one if
+// there is none, to be filled with the next frame.
+std::vector<std::uint8_t> FrameWriter::takeBuffer() {
+    return std::move(background.takeSpare().pixels);
+}
+
+// Takes 3 bytes per pixel.
+void FrameWriter::writeFrame(std::vector<std::uint8_t>&& pixels,
+                             unsigned int width, unsigned int height) {
+    assert(pixels.size() == static_cast<std::size_t>(width) * height * 3);
+    background.enqueue({ frame_count, width, height, std::move(pixels) });
+    frame_count++;
+}
+
+// Waits until all frames are written.
+void FrameWriter::flush() {
+    background.flush();
+}
+
+std::uint64_t FrameWriter::getFrameCount() const {
+    return frame_count;
+}
+
+std::string FrameWriter::framePath(const std::string& path_prefix,
+                                   std::uint64_t frame) {
+    std::ostringstream path;
+    path << path_prefix << std::setw(6) << std::setfill('0') << frame
+         << ".ppm";
+    return path.str();
+}
+
+void FrameWriter::write(const Frame& frame) const {
+    std::string path = framePath(path_prefix, frame.number);
+    std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+    if (!stream) {
+        throw IoException("Error opening " + path + " for writing.");
+    }
+    stream << "P6\n" << frame.width << ' ' << frame.height << "\n255\n";
+    stream.write(reinterpret_cast<const char*>(frame.pixels.data()),
+                 static_cast<std::streamsize>(frame.pixels.size()));
+    stream.close();
+    if (!stream) {
+        throw IoException("Error writing " + path + ".");
+    }
+}
+
+}
@@ -0,0 +1,59 @@
+#ifndef FRAMEWRITER_HPP
+#define FRAMEWRITER_HPP
+
+#include "IoException.hpp"
+#include "BackgroundWriter.hpp"
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+namespace wotmin2d {
+
+/**
+ * Writes a sequence of frames as numbered binary PPM images (the path prefix
+ * followed by the frame number with six digits and ".ppm"), which tools like
+ * ffmpeg turn into a video. Pixels are 8-bit RGB, in rows starting at the top.
+ *
+ * Frames are written by a BackgroundWriter, so whoever draws them doesn't wait
+ * for the disk. Their buffers are reused once written (see takeBuffer()). If
+ * the thread falls more than max_pending frames behind, writeFrame() blocks
+ * until it catches up, so no frame is lost. Errors of the background thread
+ * are thrown as IoException by the next call to writeFrame() or flush().
+ */
+class FrameWriter {
+    public:
+    explicit FrameWriter(const std::string& path_prefix);
+    FrameWriter(const FrameWriter&) = delete;
+    FrameWriter& operator=(const FrameWriter&) = delete;
+    std::vector<std::uint8_t> takeBuffer();
+    void writeFrame(std::vector<std::uint8_t>&& pixels, unsigned int width,
+                    unsigned int height);
+    void flush();
+    std::uint64_t getFrameCount() const;
+    static std::string framePath(const std::string& path_prefix,
+                                 std::uint64_t frame);
+    constexpr static std::size_t max_pending = 8;
+    private:
+    struct Frame {
+        std::uint64_t number;
+        unsigned int width;
+        unsigned int height;
+        std::vector<std::uint8_t> pixels;
+    };
+    void write(const Frame& frame) const;
+    const std::string path_prefix;
+    std::uint64_t frame_count;
+    // Declared last, so its thread is stopped before anything it uses.
+    BackgroundWriter<Frame> background;
+};
+
+}
+
+#endif
@@ -0,0 +1,14 @@
+#include "IoException.hpp"
+
+namespace wotmin2d {
+
+IoException::IoException(const std::string& what_arg, int error_number) :
+    std::runtime_error(what_arg),
+    error_number(error_number) {
+}
+
+int IoException::errorNumber() const noexcept {
+    return error_number;
+}
+
+}
@@ -0,0 +1,19 @@
+#ifndef IOEXCEPTION_HPP
+#define IOEXCEPTION_HPP
+
+#include <stdexcept>
+#include <string>
+
+namespace wotmin2d {
+
+class IoException : public std::runtime_error {
+    public:
+    IoException(const std::string& what_arg, int error_number = 0);
+    int errorNumber() const noexcept;
+    private:
+    int error_number;
+};
+
+}
+
+#endif
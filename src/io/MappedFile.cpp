@@ -0,0 +1,56 @@
+#include "MappedFile.hpp"
+
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace wotmin2d {
+
+MappedFile::MappedFile(const std::string& path) :
+    data(nullptr),
+    size(0)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        throw IoException("Error opening " + path + ".", errno);
+    }
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0) {
+        int error_number = errno;
+        close(fd);
+        throw IoException("Error getting the size of " + path + ".",
+                          error_number);
+    }
+    size = static_cast<std::size_t>(file_stat.st_size);
+    if (size == 0) {
+        // Can't map empty files, but there's nothing to read anyway.
+        close(fd);
+        return;
+    }
+    void* address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping stays valid after closing the file.
+    int error_number = errno;
+    close(fd);
+    if (address == MAP_FAILED) {
+        throw IoException("Error mapping " + path + ".", error_number);
+    }
+    data = static_cast<const std::uint8_t*>(address);
+}
+
+MappedFile::~MappedFile() {
+    if (data != nullptr) {
+        munmap(const_cast<std::uint8_t*>(data), size);
+    }
+}
+
+const std::uint8_t* MappedFile::getData() const {
+    return data;
+}
+
+std::size_t MappedFile::getSize() const {
+    return size;
+}
+
+}
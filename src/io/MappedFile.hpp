@@ -0,0 +1,31 @@
+#ifndef MAPPEDFILE_HPP
+#define MAPPEDFILE_HPP
+
+#include "IoException.hpp"
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace wotmin2d {
+
+/**
+ * A file mapped read-only into memory. The contents stay valid for as long as
+ * the object lives.
+ */
+class MappedFile {
+    public:
+    MappedFile(const std::string& path);
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile();
+    const std::uint8_t* getData() const;
+    std::size_t getSize() const;
+    private:
+    const std::uint8_t* data;
+    std::size_t size;
+};
+
+}
+
+#endif
@@ -0,0 +1,292 @@
+#include "Recording.hpp"
+
+#include <memory>
+#include <cstring>
+
+namespace wotmin2d {
+
+constexpr std::size_t Recording::block_size;
+constexpr char Recording::magic[8];
+constexpr char Recording::index_magic[8];
+constexpr std::uint32_t Recording::version;
+
+Recording::Recording(const BinaryReader& reader, const Scenario& scenario,
+                     std::chrono::milliseconds tick_duration) :
+    reader(reader),
+    scenario(scenario),
+    tick_duration(tick_duration),
+    events_offset(reader.getOffset()),
+    events_end(reader.getSize()),
+    keyframes(),
+    tick_count(0),
+    complete(false) {}
+
+// Layout (all values in host byte order):
+// header, u32 tick duration in milliseconds, the scenario (see Scenario),
+// padding to 8 bytes, then blocks of 24 bytes each:
+//     u64 tick, u8 type, u8 player id, u16 padding,
+//     i32 position x, i32 position y, f32 difference
+// Blocks of a command type describe the command. A keyframe block (type 0xfe)
+// stores the size of the snapshot following it in x (low half) and y (high
+// half), the snapshot (see SnapshotFile) is padded to 8 bytes. The last block
+// of a complete recording has type 0xff and the total number of ticks as its
+// tick. It's followed by the index:
+//     u64 number of keyframes, then per keyframe u64 tick, u64 offset
+//     u64 offset of the index, u64 tick count, index magic
+Recording Recording::load(const std::string& path) {
+    BinaryReader reader(std::make_shared<const MappedFile>(path));
+    reader.readHeader(magic, version);
+    std::chrono::milliseconds tick_duration(reader.read<std::uint32_t>());
+    Scenario scenario = Scenario::read(reader);
+    reader.align(8);
+    Recording recording(reader, scenario, tick_duration);
+    if (!recording.readIndex()) {
+        recording.scan();
+    }
+    return recording;
+}
+
+// Reads the index at the end of a complete recording. Returns false if there
+// is none.
+bool Recording::readIndex() {
+    const std::size_t trailer_size = 16 + sizeof(index_magic);
+    if (reader.getSize() < events_offset + trailer_size) {
+        return false;
+    }
+    BinaryReader index = reader;
+    index.seek(reader.getSize() - trailer_size);
+    std::uint64_t index_offset = index.read<std::uint64_t>();
+    std::uint64_t index_tick_count = index.read<std::uint64_t>();
+    if (std::memcmp(index.readBytes(sizeof(index_magic)), index_magic,
+                    sizeof(index_magic)) != 0) {
+        return false;
+    }
+    if (index_offset < events_offset + block_size
+        || index_offset > reader.getSize() - trailer_size) {
+        throw IoException("Recording has an invalid index.");
+    }
+    index.seek(index_offset);
+    std::uint64_t keyframe_count = index.read<std::uint64_t>();
+    if (keyframe_count > index.getRemaining() / 16) {
+        throw IoException("Recording has an invalid index.");
+    }
+    keyframes.reserve(keyframe_count);
+    for (std::uint64_t i = 0; i < keyframe_count; i++) {
+        std::uint64_t tick = index.read<std::uint64_t>();
+        std::uint64_t offset = index.read<std::uint64_t>();
+        if (offset < events_offset || offset + block_size > index_offset) {
+            throw IoException("Recording has an invalid index.");
+        }
+        keyframes.emplace_back(tick, offset);
+    }
+    // The end block is right before the index.
+    events_end = index_offset - block_size;
+    tick_count = index_tick_count;
+    complete = true;
+    return true;
+}
+
+// Goes through all blocks of a recording without index to find the keyframes
+// and the last tick.
+void Recording::scan() {
+    BinaryReader blocks = reader;
+    while (blocks.getRemaining() >= block_size) {
+        std::size_t offset = blocks.getOffset();
+        std::uint64_t tick = blocks.read<std::uint64_t>();
+        std::uint8_t type = blocks.read<std::uint8_t>();
+        blocks.readBytes(3);
+        std::uint64_t size = blocks.read<std::uint32_t>();
+        size |= static_cast<std::uint64_t>(blocks.read<std::uint32_t>()) << 32;
+        blocks.read<float>();
+        if (tick < tick_count) {
+            throw IoException("Recording has blocks out of order.");
+        }
+        if (type == end_block) {
+            events_end = offset;
+            tick_count = tick;
+            complete = true;
+            return;
+        }
+        if (type == keyframe_block) {
+            std::uint64_t padded_size = (size + 7) & ~7ull;
+            if (padded_size > blocks.getRemaining()) {
+                // The battle ended while the keyframe was written.
+                events_end = offset;
+                return;
+            }
+            blocks.seek(blocks.getOffset() + padded_size);
+            keyframes.emplace_back(tick, offset);
+        }
+        tick_count = tick;
+        events_end = blocks.getOffset();
+    }
+}
+
+const Scenario& Recording::getScenario() const {
+    return scenario;
+}
+
+std::chrono::milliseconds Recording::getTickDuration() const {
+    return tick_duration;
+}
+
+// Returns the number of ticks the battle lasted. For incomplete recordings,
+// this is the tick of the last command or keyframe.
+std::uint64_t Recording::getTickCount() const {
+    return tick_count;
+}
+
+bool Recording::isComplete() const {
+    return complete;
+}
+
+// Returns the offset of the first command, to start reading commands with
+// readEvent().
+std::size_t Recording::getEventsOffset() const {
+    return events_offset;
+}
+
+// Reads the command at the given offset, or the next one after it if there
+// are keyframes in between, and moves the offset past it. Returns false if
+// there are no more commands.
+bool Recording::readEvent(std::size_t& offset, Event& event) const {
+    BinaryReader blocks = reader;
+    while (offset + block_size <= events_end) {
+        blocks.seek(offset);
+        std::uint64_t tick = blocks.read<std::uint64_t>();
+        std::uint8_t type = blocks.read<std::uint8_t>();
+        Command::PlayerId player_id = blocks.read<std::uint8_t>();
+        blocks.read<std::uint16_t>();
+        int x = blocks.read<std::int32_t>();
+        int y = blocks.read<std::int32_t>();
+        float difference = blocks.read<float>();
+        offset += block_size;
+        switch (type) {
+        case static_cast<std::uint8_t>(Command::Type::select_particles):
+            event = Event(tick, Command::selectParticles(IntVector(x, y)));
+            return true;
+        case static_cast<std::uint8_t>(Command::Type::set_target):
+            event = Event(tick, Command::setTarget(player_id,
+                                                   IntVector(x, y)));
+            return true;
+        case static_cast<std::uint8_t>(Command::Type::change_selection_radius):
+            event = Event(tick, Command::changeSelectionRadius(difference));
+            return true;
+        case keyframe_block: {
+            std::uint64_t size = static_cast<std::uint32_t>(x)
+                | static_cast<std::uint64_t>(static_cast<std::uint32_t>(y))
+                  << 32;
+            offset += (size + 7) & ~7ull;
+            break;
+        }
+        default:
+            throw IoException("Unknown command in recording.");
+        }
+    }
+    return false;
+}
+
+std::vector<Recording::Event> Recording::getEvents() const {
+    std::vector<Event> events;
+    std::size_t offset = events_offset;
+    Event event(0, Command::selectParticles(IntVector(0, 0)));
+    while (readEvent(offset, event)) {
+        events.push_back(event);
+    }
+    return events;
+}
+
+const std::vector<Recording::Keyframe>& Recording::getKeyframes() const {
+    return keyframes;
+}
+
+void Recording::readKeyframe(const Keyframe& keyframe,
+                             StateSnapshot& snapshot) const {
+    BinaryReader blocks = reader;
+    blocks.seek(keyframe.second + block_size);
+    SnapshotFile::read(blocks, snapshot);
+}
+
+void Recording::writeBlock(BinaryWriter& writer, std::uint64_t tick,
+                           std::uint8_t type, const Command& command) {
+    writer.write(tick);
+    writer.write(type);
+    writer.write<std::uint8_t>(command.getPlayerId());
+    writer.write<std::uint16_t>(0);
+    writer.write<std::int32_t>(command.getPosition().getX());
+    writer.write<std::int32_t>(command.getPosition().getY());
+    writer.write(command.getDifference());
+}
+
+RecordingWriter::RecordingWriter(const std::string& path,
+                                 const Scenario& scenario,
+                                 std::chrono::milliseconds tick_duration) :
+    stream(path, std::ios::binary | std::ios::trunc),
+    writer(stream),
+    keyframes(),
+    last_tick(0),
+    finished(false) {
+    if (!stream) {
+        throw IoException("Error opening " + path + " for writing.");
+    }
+    writer.writeHeader(Recording::magic, Recording::version);
+    writer.write<std::uint32_t>(tick_duration.count());
+    scenario.write(writer);
+    writer.align(8);
+    writer.flush();
+}
+
+void RecordingWriter::write(std::uint64_t tick, const Command& command) {
+    assert(!finished && "Write to a finished recording.");
+    assert(tick >= last_tick && "Commands must be written in order.");
+    last_tick = tick;
+    Recording::writeBlock(writer, tick,
+                          static_cast<std::uint8_t>(command.getType()),
+                          command);
+    writer.flush();
+}
+
+// Writes a snapshot of the state at the given tick, before the commands of
+// that tick.
+void RecordingWriter::writeKeyframe(std::uint64_t tick,
+                                    const StateSnapshot& snapshot) {
+    assert(!finished && "Write to a finished recording.");
+    assert(tick >= last_tick && "Keyframes must be written in order.");
+    last_tick = tick;
+    std::uint64_t offset = writer.getOffset();
+    std::uint64_t size = SnapshotFile::getSize(snapshot);
+    // Smuggle the size into the position of the block.
+    Command size_command = Command::selectParticles(IntVector(
+        static_cast<std::int32_t>(static_cast<std::uint32_t>(size)),
+        static_cast<std::int32_t>(static_cast<std::uint32_t>(size >> 32))));
+    Recording::writeBlock(writer, tick, Recording::keyframe_block,
+                          size_command);
+    SnapshotFile::write(snapshot, writer);
+    assert(writer.getOffset() == offset + Recording::block_size + size
+           && "Snapshot size was computed incorrectly.");
+    writer.align(8);
+    writer.flush();
+    keyframes.emplace_back(tick, offset);
+}
+
+// Marks the recording as complete and writes the keyframe index. Nothing can be
+// written afterwards.
+void RecordingWriter::finish(std::uint64_t tick_count) {
+    assert(!finished && "Recording finished twice.");
+    assert(tick_count >= last_tick && "Recording ends before its last event.");
+    Recording::writeBlock(writer, tick_count, Recording::end_block,
+                          Command::selectParticles(IntVector(0, 0)));
+    std::uint64_t index_offset = writer.getOffset();
+    writer.write<std::uint64_t>(keyframes.size());
+    for (const Recording::Keyframe& keyframe: keyframes) {
+        writer.write<std::uint64_t>(keyframe.first);
+        writer.write<std::uint64_t>(keyframe.second);
+    }
+    writer.write(index_offset);
+    writer.write(tick_count);
+    writer.writeBytes(Recording::index_magic, sizeof(Recording::index_magic));
+    writer.flush();
+    finished = true;
+}
+
+}
@@ -0,0 +1,103 @@
+#ifndef RECORDING_HPP
+#define RECORDING_HPP
+
+#include "BinaryReader.hpp"
+#include "BinaryWriter.hpp"
+#include "IoException.hpp"
+#include "MappedFile.hpp"
+#include "Scenario.hpp"
+#include "SnapshotFile.hpp"
+#include "../game/Command.hpp"
+#include "../game/Snapshot.hpp"
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <fstream>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+namespace wotmin2d {
+
+/**
+ * The commands executed during a battle, each tagged with the number of ticks
+ * (calls to State::advance()) that happened before it, and the scenario the
+ * battle started from. Since the simulation is deterministic, this is enough to
+ * reproduce the battle.
+ *
+ * Recordings also contain keyframes, snapshots of the state taken every now
+ * and then, so that a replay can start close to any tick instead of at the
+ * beginning. A complete recording ends with an index of the keyframes, so
+ * opening it doesn't need to look at the rest of the file. The file is
+ * memory-mapped, and commands and keyframes are only read when needed.
+ *
+ * Recordings are written while the battle runs by RecordingWriter. If the
+ * battle didn't end normally, the recording is incomplete and ends with the
+ * last command or keyframe that made it to the file.
+ */
+class Recording {
+    public:
+    using Event = std::pair<std::uint64_t, Command>;
+    // Tick and offset of a keyframe in the file.
+    using Keyframe = std::pair<std::uint64_t, std::size_t>;
+    static Recording load(const std::string& path);
+    const Scenario& getScenario() const;
+    std::chrono::milliseconds getTickDuration() const;
+    std::uint64_t getTickCount() const;
+    bool isComplete() const;
+    std::size_t getEventsOffset() const;
+    bool readEvent(std::size_t& offset, Event& event) const;
+    std::vector<Event> getEvents() const;
+    const std::vector<Keyframe>& getKeyframes() const;
+    void readKeyframe(const Keyframe& keyframe,
+                      StateSnapshot& snapshot) const;
+    private:
+    friend class RecordingWriter;
+    enum BlockType : std::uint8_t { keyframe_block = 0xfe, end_block = 0xff };
+    constexpr static std::size_t block_size = 24;
+    constexpr static char magic[8] = "WM2DREC";
+    constexpr static char index_magic[8] = "WM2DIDX";
+    constexpr static std::uint32_t version = 2;
+    Recording(const BinaryReader& reader, const Scenario& scenario,
+              std::chrono::milliseconds tick_duration);
+    bool readIndex();
+    void scan();
+    static void writeBlock(BinaryWriter& writer, std::uint64_t tick,
+                           std::uint8_t type, const Command& command);
+    BinaryReader reader;
+    Scenario scenario;
+    std::chrono::milliseconds tick_duration;
+    std::size_t events_offset;
+    std::size_t events_end;
+    std::vector<Keyframe> keyframes;
+    std::uint64_t tick_count;
+    bool complete;
+};
+
+/**
+ * Appends commands and keyframes to a recording file as they happen. Every
+ * write is flushed immediately, so a crash loses at most the end marker and the
+ * index.
+ */
+class RecordingWriter {
+    public:
+    RecordingWriter(const std::string& path, const Scenario& scenario,
+                    std::chrono::milliseconds tick_duration);
+    RecordingWriter(const RecordingWriter&) = delete;
+    RecordingWriter& operator=(const RecordingWriter&) = delete;
+    void write(std::uint64_t tick, const Command& command);
+    void writeKeyframe(std::uint64_t tick, const StateSnapshot& snapshot);
+    void finish(std::uint64_t tick_count);
+    private:
+    std::ofstream stream;
+    BinaryWriter writer;
+    std::vector<Recording::Keyframe> keyframes;
+    std::uint64_t last_tick;
+    bool finished;
+};
+
+}
+
+#endif
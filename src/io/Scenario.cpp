@@ -0,0 +1,277 @@
+#include "Scenario.hpp"
+
+#include <fstream>
+
+namespace wotmin2d {
+
+constexpr char Scenario::magic[8];
+constexpr std::uint32_t Scenario::version;
+
+Scenario::BlobSetup::BlobSetup(PlayerId player_id, Kind kind,
+                               const Shape& shape, const IntVector& center,
+                               float radius) :
+    player_id(player_id),
+    kind(kind),
+    shape(shape),
+    center(center),
+    radius(radius),
+    has_target(false),
+    target(0, 0),
+    target_pressure(0.0f) {}
+
+Scenario::PlayerId Scenario::BlobSetup::getPlayerId() const {
+    return player_id;
+}
+
+Scenario::BlobSetup::Kind Scenario::BlobSetup::getKind() const {
+    return kind;
+}
+
+const Shape& Scenario::BlobSetup::getShape() const {
+    return shape;
+}
+
+const IntVector& Scenario::BlobSetup::getCenter() const {
+    return center;
+}
+
+float Scenario::BlobSetup::getRadius() const {
+    return radius;
+}
+
+bool Scenario::BlobSetup::hasTarget() const {
+    return has_target;
+}
+
+const IntVector& Scenario::BlobSetup::getTarget() const {
+    return target;
+}
+
+float Scenario::BlobSetup::getTargetPressure() const {
+    return target_pressure;
+}
+
+void Scenario::BlobSetup::setTarget(const IntVector& target,
+                                    float pressure_per_second) {
+    has_target = true;
+    this->target = target;
+    target_pressure = pressure_per_second;
+}
+
+Scenario::Scenario(unsigned int arena_width, unsigned int arena_height) :
+    arena_width(arena_width),
+    arena_height(arena_height),
+    blobs() {}
+
+Scenario Scenario::load(const std::string& path) {
+    BinaryReader reader(std::make_shared<const MappedFile>(path));
+    return read(reader);
+}
+
+// Layout (all values in host byte order):
+// header, u32 arena width, u32 arena height, u32 number of blobs, then per
+// blob:
+//     u8 player id, u8 kind, u8 has target, u8 padding,
+//     i32 target x, i32 target y, f32 target pressure per second,
+//     circle: i32 center x, i32 center y, f32 radius
+//     rectangle: i32 origin x, i32 origin y, u32 width, u32 height
+//     bitmap: i32 origin x, i32 origin y, u32 width, u32 height, padding to 8
+//         bytes, the bits, padding to 8 bytes
+Scenario Scenario::read(BinaryReader& reader) {
+    reader.readHeader(magic, version);
+    unsigned int arena_width = reader.read<std::uint32_t>();
+    unsigned int arena_height = reader.read<std::uint32_t>();
+    if (arena_width == 0 || arena_height == 0) {
+        throw IoException("Scenario has an empty arena.");
+    }
+    // Positions in the arena must fit an int.
+    unsigned int max_size
+        = static_cast<unsigned int>(std::numeric_limits<int>::max());
+    if (arena_width > max_size || arena_height > max_size) {
+        throw IoException("Scenario has a too large arena.");
+    }
+    Scenario scenario(arena_width, arena_height);
+    std::uint32_t blob_count = reader.read<std::uint32_t>();
+    for (std::uint32_t i = 0; i < blob_count; i++) {
+        PlayerId player_id = reader.read<std::uint8_t>();
+        std::uint8_t kind = reader.read<std::uint8_t>();
+        bool has_target = reader.read<std::uint8_t>() != 0;
+        reader.read<std::uint8_t>();
+        int target_x = reader.read<std::int32_t>();
+        int target_y = reader.read<std::int32_t>();
+        float target_pressure = reader.read<float>();
+        int x = reader.read<std::int32_t>();
+        int y = reader.read<std::int32_t>();
+        switch (static_cast<BlobSetup::Kind>(kind)) {
+        case BlobSetup::Kind::circle:
+            scenario.addCircle(player_id, IntVector(x, y),
+                               reader.read<float>());
+            break;
+        case BlobSetup::Kind::rectangle: {
+            unsigned int width = reader.read<std::uint32_t>();
+            unsigned int height = reader.read<std::uint32_t>();
+            scenario.addRectangle(player_id, IntVector(x, y), width, height);
+            break;
+        }
+        case BlobSetup::Kind::bitmap: {
+            unsigned int width = reader.read<std::uint32_t>();
+            unsigned int height = reader.read<std::uint32_t>();
+            scenario.checkSize(width, height);
+            reader.align(8);
+            std::size_t size = Shape::rowBytes(width) * height;
+            Shape shape(IntVector(x, y), width, height,
+                        reader.readShared(size));
+            reader.align(8);
+            scenario.addShape(player_id, shape);
+            break;
+        }
+        default:
+            throw IoException("Unknown blob shape in scenario.");
+        }
+        if (has_target) {
+            scenario.setTarget(player_id, IntVector(target_x, target_y),
+                               target_pressure);
+        }
+    }
+    return scenario;
+}
+
+void Scenario::save(const std::string& path) const {
+    std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+    if (!stream) {
+        throw IoException("Error opening " + path + " for writing.");
+    }
+    BinaryWriter writer(stream);
+    write(writer);
+    writer.flush();
+}
+
+void Scenario::write(BinaryWriter& writer) const {
+    writer.writeHeader(magic, version);
+    writer.write<std::uint32_t>(arena_width);
+    writer.write<std::uint32_t>(arena_height);
+    writer.write<std::uint32_t>(blobs.size());
+    for (const BlobSetup& setup: blobs) {
+        writer.write<std::uint8_t>(setup.getPlayerId());
+        writer.write(setup.getKind());
+        writer.write<std::uint8_t>(setup.hasTarget());
+        writer.write<std::uint8_t>(0);
+        writer.write<std::int32_t>(setup.getTarget().getX());
+        writer.write<std::int32_t>(setup.getTarget().getY());
+        writer.write(setup.getTargetPressure());
+        const Shape& shape = setup.getShape();
+        switch (setup.getKind()) {
+        case BlobSetup::Kind::circle:
+            writer.write<std::int32_t>(setup.getCenter().getX());
+            writer.write<std::int32_t>(setup.getCenter().getY());
+            writer.write(setup.getRadius());
+            break;
+        case BlobSetup::Kind::rectangle:
+        case BlobSetup::Kind::bitmap:
+            writer.write<std::int32_t>(shape.getOrigin().getX());
+            writer.write<std::int32_t>(shape.getOrigin().getY());
+            writer.write<std::uint32_t>(shape.getWidth());
+            writer.write<std::uint32_t>(shape.getHeight());
+            if (setup.getKind() == BlobSetup::Kind::bitmap) {
+                writer.align(8);
+                writer.writeBytes(shape.getBits(),
+                                  shape.getRowBytes() * shape.getHeight());
+                writer.align(8);
+            }
+            break;
+        }
+    }
+}
+
+// A circle may stick out of the arena, but its radius can't be larger than
+// the arena. Circles with negative radius are empty.
+void Scenario::addCircle(PlayerId player_id, const IntVector& center,
+                         float radius) {
+    if (!std::isfinite(radius)
+        || radius > static_cast<float>(std::max(arena_width, arena_height))) {
+        throw IoException("Circle of radius " + std::to_string(radius)
+                          + " doesn't fit the arena.");
+    }
+    Shape shape = radius > 0.0f ? Shape::circle(center, radius) : Shape();
+    addBlob(BlobSetup(player_id, BlobSetup::Kind::circle, shape, center,
+                      radius));
+}
+
+void Scenario::addRectangle(PlayerId player_id, const IntVector& origin,
+                            unsigned int width, unsigned int height) {
+    checkSize(width, height);
+    addBlob(BlobSetup(player_id, BlobSetup::Kind::rectangle,
+                      Shape::rectangle(origin, width, height), origin, 0.0f));
+}
+
+void Scenario::addShape(PlayerId player_id, const Shape& shape) {
+    checkSize(shape.getWidth(), shape.getHeight());
+    addBlob(BlobSetup(player_id, BlobSetup::Kind::bitmap, shape,
+                      shape.getOrigin(), 0.0f));
+}
+
+void Scenario::setTarget(PlayerId player_id, const IntVector& target,
+                         float pressure_per_second) {
+    for (BlobSetup& setup: blobs) {
+        if (setup.getPlayerId() == player_id) {
+            setup.setTarget(target, pressure_per_second);
+            return;
+        }
+    }
+    throw IoException("No blob for player "
+                      + std::to_string(static_cast<unsigned int>(player_id))
+                      + " in scenario.");
+}
+
+unsigned int Scenario::getArenaWidth() const {
+    return arena_width;
+}
+
+unsigned int Scenario::getArenaHeight() const {
+    return arena_height;
+}
+
+const std::vector<Scenario::BlobSetup>& Scenario::getBlobs() const {
+    return blobs;
+}
+
+// Throws if a blob of the given size can't fit the arena.
+void Scenario::checkSize(unsigned int width, unsigned int height) const {
+    if (width > arena_width || height > arena_height) {
+        throw IoException("Blob of " + std::to_string(width) + " by "
+                          + std::to_string(height)
+                          + " cells doesn't fit the arena.");
+    }
+}
+
+void Scenario::addBlob(const BlobSetup& setup) {
+    if (setup.getPlayerId() > StateSnapshot::max_player_id) {
+        throw IoException("Scenario has a blob for player "
+                          + std::to_string(static_cast<unsigned int>(
+                                setup.getPlayerId()))
+                          + ", but the highest player is "
+                          + std::to_string(static_cast<unsigned int>(
+                                StateSnapshot::max_player_id))
+                          + ".");
+    }
+    for (const BlobSetup& other: blobs) {
+        if (other.getPlayerId() == setup.getPlayerId()) {
+            throw IoException("Scenario has more than one blob for player "
+                              + std::to_string(static_cast<unsigned int>(
+                                    setup.getPlayerId()))
+                              + ".");
+        }
+        if (other.getShape().overlaps(setup.getShape())) {
+            throw IoException("Blobs of players "
+                              + std::to_string(static_cast<unsigned int>(
+                                    other.getPlayerId()))
+                              + " and "
+                              + std::to_string(static_cast<unsigned int>(
+                                    setup.getPlayerId()))
+                              + " overlap in scenario.");
+        }
+    }
+    blobs.push_back(setup);
+}
+
+}
@@ -0,0 +1,106 @@
+#ifndef SCENARIO_HPP
+#define SCENARIO_HPP
+
+#include "BinaryReader.hpp"
+#include "BinaryWriter.hpp"
+#include "IoException.hpp"
+#include "MappedFile.hpp"
+#include "../game/State.hpp"
+#include "../game/Shape.hpp"
+#include "../game/Vector.hpp"
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+namespace wotmin2d {
+
+/**
+ * The initial setup of a battle: the arena size and the blob of each player
+ * with its shape and optionally a target all its particles head for.
+ *
+ * Scenarios are stored in a binary file. Circles and rectangles are stored by
+ * their parameters, other shapes as raw bitmaps in the layout of Shape, which
+ * are used straight from the memory-mapped file when loading.
+ *
+ * Blobs are checked as they're added: their size must be finite and fit the
+ * arena, so a bad file can't make loading allocate huge bitmaps, and blobs of
+ * different players mustn't overlap.
+ */
+class Scenario {
+    public:
+    using PlayerId = State<>::PlayerId;
+    class BlobSetup {
+        public:
+        enum class Kind : std::uint8_t { circle = 0, rectangle = 1,
+                                         bitmap = 2 };
+        BlobSetup(PlayerId player_id, Kind kind, const Shape& shape,
+                  const IntVector& center, float radius);
+        PlayerId getPlayerId() const;
+        Kind getKind() const;
+        const Shape& getShape() const;
+        const IntVector& getCenter() const;
+        float getRadius() const;
+        bool hasTarget() const;
+        const IntVector& getTarget() const;
+        float getTargetPressure() const;
+        void setTarget(const IntVector& target, float pressure_per_second);
+        private:
+        PlayerId player_id;
+        Kind kind;
+        Shape shape;
+        IntVector center;
+        float radius;
+        bool has_target;
+        IntVector target;
+        float target_pressure;
+    };
+    Scenario(unsigned int arena_width, unsigned int arena_height);
+    static Scenario load(const std::string& path);
+    static Scenario read(BinaryReader& reader);
+    void save(const std::string& path) const;
+    void write(BinaryWriter& writer) const;
+    void addCircle(PlayerId player_id, const IntVector& center, float radius);
+    void addRectangle(PlayerId player_id, const IntVector& origin,
+                      unsigned int width, unsigned int height);
+    void addShape(PlayerId player_id, const Shape& shape);
+    void setTarget(PlayerId player_id, const IntVector& target,
+                   float pressure_per_second);
+    unsigned int getArenaWidth() const;
+    unsigned int getArenaHeight() const;
+    const std::vector<BlobSetup>& getBlobs() const;
+    template<class S>
+    void populate(S& state) const;
+    private:
+    void checkSize(unsigned int width, unsigned int height) const;
+    void addBlob(const BlobSetup& setup);
+    constexpr static char magic[8] = "WM2DSCN";
+    constexpr static std::uint32_t version = 1;
+    unsigned int arena_width;
+    unsigned int arena_height;
+    std::vector<BlobSetup> blobs;
+};
+
+// Adds the blobs of the scenario to a state of the scenario's dimensions.
+template<class S>
+void Scenario::populate(S& state) const {
+    assert(state.getWidth() == arena_width
+           && state.getHeight() == arena_height
+           && "State doesn't have the dimensions of the scenario.");
+    for (const BlobSetup& setup: blobs) {
+        state.emplaceBlob(setup.getPlayerId(), setup.getShape());
+        if (setup.hasTarget()) {
+            state.setBlobTarget(setup.getPlayerId(), setup.getTarget(),
+                                setup.getTargetPressure());
+        }
+    }
+}
+
+}
+
+#endif
@@ -0,0 +1,197 @@
+#include "SnapshotFile.hpp"
+
+#include <fstream>
+#include <memory>
+#include <type_traits>
+#include <vector>
+#include <algorithm>
+
+namespace wotmin2d {
+
+static_assert(sizeof(ParticleRecord) == 56
+              && std::is_trivially_copyable<ParticleRecord>::value,
+              "The layout of particle records is part of the file format.");
+
+constexpr char SnapshotFile::magic[8];
+constexpr std::uint32_t SnapshotFile::version;
+
+StateSnapshot SnapshotFile::load(const std::string& path) {
+    BinaryReader reader(std::make_shared<const MappedFile>(path));
+    StateSnapshot snapshot;
+    read(reader, snapshot);
+    return snapshot;
+}
+
+// Layout (all values in host byte order):
+// header, u32 arena width, u32 arena height, i32 selection center x, i32
+// selection center y, f32 selection radius, u32 number of blobs, then per
+// blob:
+//     u8 player id, 3 bytes padding, u32 number of particles, u32 number of
+//     follower indices, padding to 8 bytes, the particle records, the follower
+//     indices, padding to 8 bytes
+void SnapshotFile::read(BinaryReader& reader, StateSnapshot& snapshot) {
+    reader.readHeader(magic, version);
+    unsigned int arena_width = reader.read<std::uint32_t>();
+    unsigned int arena_height = reader.read<std::uint32_t>();
+    if (arena_width == 0 || arena_height == 0) {
+        throw IoException("Snapshot has an empty arena.");
+    }
+    snapshot.setArenaSize(arena_width, arena_height);
+    int center_x = reader.read<std::int32_t>();
+    int center_y = reader.read<std::int32_t>();
+    snapshot.setSelection(IntVector(center_x, center_y), reader.read<float>());
+    std::uint32_t blob_count = reader.read<std::uint32_t>();
+    snapshot.getBlobs().clear();
+    for (std::uint32_t i = 0; i < blob_count; i++) {
+        StateSnapshot::PlayerId player_id = reader.read<std::uint8_t>();
+        reader.readBytes(3);
+        if (player_id > StateSnapshot::max_player_id) {
+            throw IoException("Snapshot has a blob for player "
+                              + std::to_string(
+                                    static_cast<unsigned int>(player_id))
+                              + ", but the highest player is "
+                              + std::to_string(static_cast<unsigned int>(
+                                    StateSnapshot::max_player_id))
+                              + ".");
+        }
+        if (snapshot.getBlobs().count(player_id) > 0) {
+            throw IoException("Snapshot has more than one blob for player "
+                              + std::to_string(
+                                    static_cast<unsigned int>(player_id))
+                              + ".");
+        }
+        readBlob(reader, arena_width, arena_height,
+                 snapshot.getBlobs()[player_id]);
+    }
+}
+
+// Reads the records of a blob and checks that all of them are within the
+// arena, at distinct positions, and only refer to particles of the blob, and
+// that neighbors are next to each other and refer to each other. So a corrupt
+// file can't make the restored blob point into nowhere or put two particles in
+// one cell.
+void SnapshotFile::readBlob(BinaryReader& reader, unsigned int arena_width,
+                            unsigned int arena_height, BlobSnapshot& blob) {
+    std::uint32_t particle_count = reader.read<std::uint32_t>();
+    std::uint32_t follower_count = reader.read<std::uint32_t>();
+    reader.align(8);
+    // Check the sizes before allocating for them.
+    if (static_cast<std::uint64_t>(particle_count) * sizeof(ParticleRecord)
+        + static_cast<std::uint64_t>(follower_count) * sizeof(std::uint32_t)
+        > reader.getRemaining()) {
+        throw IoException("Snapshot is truncated.");
+    }
+    std::vector<ParticleRecord>& records = blob.getParticles();
+    std::vector<std::uint32_t>& followers = blob.getFollowers();
+    records.resize(particle_count);
+    followers.resize(follower_count);
+    reader.readArray(records.data(), records.size());
+    reader.readArray(followers.data(), followers.size());
+    reader.align(8);
+    for (const ParticleRecord& record: records) {
+        if (record.x < 0 || record.y < 0
+            || static_cast<unsigned int>(record.x) >= arena_width
+            || static_cast<unsigned int>(record.y) >= arena_height) {
+            throw IoException("Snapshot has a particle outside the arena.");
+        }
+        for (std::uint32_t neighbor: record.neighbors) {
+            if (neighbor != ParticleRecord::no_particle
+                && neighbor >= particle_count) {
+                throw IoException("Snapshot has an invalid neighbor.");
+            }
+        }
+        if (record.followers_begin > record.followers_end
+            || record.followers_end > follower_count) {
+            throw IoException("Snapshot has an invalid follower range.");
+        }
+    }
+    for (std::uint32_t follower: followers) {
+        if (follower >= particle_count) {
+            throw IoException("Snapshot has an invalid follower.");
+        }
+    }
+    // Positions are within the arena, so they fit 32 bits each.
+    std::vector<std::uint64_t> positions;
+    positions.reserve(particle_count);
+    for (const ParticleRecord& record: records) {
+        positions.push_back(static_cast<std::uint64_t>(record.y) << 32
+                            | static_cast<std::uint32_t>(record.x));
+    }
+    std::sort(positions.begin(), positions.end());
+    if (std::adjacent_find(positions.begin(), positions.end())
+        != positions.end()) {
+        throw IoException("Snapshot has more than one particle in a cell.");
+    }
+    for (std::uint32_t i = 0; i < particle_count; i++) {
+        const ParticleRecord& record = records[i];
+        for (Direction direction: Direction::all()) {
+            std::uint32_t neighbor
+                = record.neighbors[static_cast<Direction::val_t>(direction)];
+            if (neighbor == ParticleRecord::no_particle) {
+                continue;
+            }
+            const ParticleRecord& other = records[neighbor];
+            IntVector offset = IntVector(other.x, other.y)
+                               - IntVector(record.x, record.y);
+            if (offset != direction.vector()
+                || other.neighbors[static_cast<Direction::val_t>(
+                       direction.opposite())] != i) {
+                throw IoException("Snapshot has neighbors that don't match.");
+            }
+        }
+    }
+}
+
+void SnapshotFile::save(const StateSnapshot& snapshot,
+                        const std::string& path) {
+    std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+    if (!stream) {
+        throw IoException("Error opening " + path + " for writing.");
+    }
+    BinaryWriter writer(stream);
+    write(snapshot, writer);
+    writer.flush();
+}
+
+void SnapshotFile::write(const StateSnapshot& snapshot,
+                         BinaryWriter& writer) {
+    writer.writeHeader(magic, version);
+    writer.write<std::uint32_t>(snapshot.getArenaWidth());
+    writer.write<std::uint32_t>(snapshot.getArenaHeight());
+    writer.write<std::int32_t>(snapshot.getSelectionCenter().getX());
+    writer.write<std::int32_t>(snapshot.getSelectionCenter().getY());
+    writer.write(snapshot.getSelectionRadius());
+    writer.write<std::uint32_t>(snapshot.getBlobs().size());
+    const std::uint8_t padding[3] = {};
+    for (const auto& id_blob: snapshot.getBlobs()) {
+        const BlobSnapshot& blob = id_blob.second;
+        writer.write<std::uint8_t>(id_blob.first);
+        writer.writeBytes(padding, sizeof(padding));
+        writer.write<std::uint32_t>(blob.getParticles().size());
+        writer.write<std::uint32_t>(blob.getFollowers().size());
+        writer.align(8);
+        writer.writeArray(blob.getParticles().data(),
+                          blob.getParticles().size());
+        writer.writeArray(blob.getFollowers().data(),
+                          blob.getFollowers().size());
+        writer.align(8);
+    }
+}
+
+// Returns the number of bytes write() produces for the snapshot, if it starts
+// at an offset that is a multiple of 8.
+std::uint64_t SnapshotFile::getSize(const StateSnapshot& snapshot) {
+    auto aligned = [](std::uint64_t offset) { return (offset + 7) & ~7ull; };
+    // Header, arena size, selection and number of blobs.
+    std::uint64_t size = 16 + 24;
+    for (const auto& id_blob: snapshot.getBlobs()) {
+        size = aligned(size + 12);
+        size += id_blob.second.getParticles().size() * sizeof(ParticleRecord)
+                + id_blob.second.getFollowers().size()
+                  * sizeof(std::uint32_t);
+        size = aligned(size);
+    }
+    return size;
+}
+
+}
@@ -0,0 +1,39 @@
+#ifndef SNAPSHOTFILE_HPP
+#define SNAPSHOTFILE_HPP
+
+#include "BinaryReader.hpp"
+#include "BinaryWriter.hpp"
+#include "IoException.hpp"
+#include "MappedFile.hpp"
+#include "../game/Snapshot.hpp"
+#include "../game/Direction.hpp"
+#include "../game/Vector.hpp"
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace wotmin2d {
+
+/**
+ * Stores state snapshots in a binary file. The particle records and follower
+ * indices of each blob are written as they are in memory, so both saving and
+ * loading are a few sequential block copies per blob.
+ */
+class SnapshotFile {
+    public:
+    static StateSnapshot load(const std::string& path);
+    static void read(BinaryReader& reader, StateSnapshot& snapshot);
+    static void save(const StateSnapshot& snapshot, const std::string& path);
+    static void write(const StateSnapshot& snapshot, BinaryWriter& writer);
+    static std::uint64_t getSize(const StateSnapshot& snapshot);
+    private:
+    static void readBlob(BinaryReader& reader, unsigned int arena_width,
+                         unsigned int arena_height, BlobSnapshot& blob);
+    constexpr static char magic[8] = "WM2DSNP";
+    constexpr static std::uint32_t version = 1;
+};
+
+}
+
+#endif
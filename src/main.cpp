@@ -1,9 +1,131 @@
 #include "Battle.hpp"
+#include "Replay.hpp"
+#include "io/Scenario.hpp"
+#include "io/SnapshotFile.hpp"
+#include "io/Recording.hpp"
+#include "io/IoException.hpp"
 
 #include <iostream>
+#include <memory>
+#include <string>
+#include <stdexcept>
+#include <chrono>
+#include <cstdint>
 #include <SDL.h>
 
-int main(int, char**) {
+namespace {
+
+wotmin2d::Scenario defaultScenario() {
+    wotmin2d::Scenario scenario(100, 100);
+    scenario.addCircle(0, wotmin2d::IntVector(20, 20), 10.0f);
+    scenario.addCircle(1, wotmin2d::IntVector(80, 80), 10.0f);
+    return scenario;
+}
+
+// Runs a recorded battle without display, starting at the given tick, and
+// reports how long it took.
+int replay(const std::string& path, std::uint64_t start_tick) {
+    using std::chrono::steady_clock;
+    wotmin2d::Recording recording = wotmin2d::Recording::load(path);
+    if (!recording.isComplete()) {
+        std::cerr << "Recording is incomplete, replaying up to its last "
+                  << "command." << std::endl;
+    }
+    wotmin2d::Replay replay(recording);
+    replay.seek(start_tick);
+    std::uint64_t first_tick = replay.getTick();
+    steady_clock::time_point start_time = steady_clock::now();
+    replay.run();
+    std::chrono::duration<double> elapsed = steady_clock::now() - start_time;
+    std::uint64_t ticks = replay.getTick() - first_tick;
+    std::cout << "Replayed ticks " << first_tick << " to " << replay.getTick()
+              << " in " << elapsed.count() << " s ("
+              << static_cast<double>(ticks) / elapsed.count()
+              << " ticks/s)." << std::endl;
+    for (const auto& id_blob: replay.getState().getBlobs()) {
+        std::cout << "  blob " << static_cast<unsigned int>(id_blob.first)
+                  << ": " << id_blob.second.getParticles().size()
+                  << " particles" << std::endl;
+    }
+    return 0;
+}
+
+}
+
+// Usage: WoTMin2D [display options]
+//                 [--record recording file | --stream delta stream file]
+//                 [scenario file]
+//        WoTMin2D [display options] --restore snapshot file
+//        WoTMin2D --replay recording file [start tick]
+// Display options, in any order:
+//   --headless         no window, software rendering (e.g. on a server)
+//   --frames prefix    writes every frame to prefix000000.ppm and so on
+//   --shm name         publishes every frame to POSIX shared memory, e.g.
+//                      /wotmin2d (see FrameRingReader)
+//   --ticks count      stops after that many ticks
+int main(int argc, char** argv) {
+    wotmin2d::Scenario scenario = defaultScenario();
+    std::unique_ptr<wotmin2d::StateSnapshot> snapshot;
+    std::unique_ptr<wotmin2d::RecordingWriter> recorder;
+    std::string stream_path;
+    bool headless = false;
+    std::string frames_path;
+    std::string frame_ring_name;
+    std::uint64_t tick_limit = 0;
+    try {
+        std::string record_path;
+        int arg = 1;
+        while (argc > arg) {
+            std::string option(argv[arg]);
+            if (option == "--headless") {
+                headless = true;
+                arg++;
+            } else if (argc > arg + 1 && option == "--frames") {
+                frames_path = argv[arg + 1];
+                arg += 2;
+            } else if (argc > arg + 1 && option == "--shm") {
+                frame_ring_name = argv[arg + 1];
+                arg += 2;
+            } else if (argc > arg + 1 && option == "--ticks") {
+                tick_limit = std::stoull(argv[arg + 1]);
+                arg += 2;
+            } else {
+                break;
+            }
+        }
+        if (argc > arg + 1 && std::string(argv[arg]) == "--replay") {
+            return replay(argv[arg + 1],
+                          argc > arg + 2 ? std::stoull(argv[arg + 2]) : 0);
+        } else if (argc > arg + 1 && std::string(argv[arg]) == "--restore") {
+            snapshot.reset(new wotmin2d::StateSnapshot(
+                wotmin2d::SnapshotFile::load(argv[arg + 1])));
+            arg += 2;
+        } else if (argc > arg + 1 && std::string(argv[arg]) == "--record") {
+            record_path = argv[arg + 1];
+            arg += 2;
+        } else if (argc > arg + 1 && std::string(argv[arg]) == "--stream") {
+            stream_path = argv[arg + 1];
+            arg += 2;
+        }
+        if (argc > arg) {
+            scenario = wotmin2d::Scenario::load(argv[arg]);
+        }
+        if (!record_path.empty()) {
+            recorder.reset(new wotmin2d::RecordingWriter(
+                record_path, scenario, wotmin2d::Battle::default_tick_duration));
+        }
+    } catch (const wotmin2d::IoException& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    } catch (const std::logic_error&) {
+        std::cerr << "Invalid tick." << std::endl;
+        return 1;
+    }
+
+    if (headless) {
+        // Unless another driver was asked for, e.g. "offscreen".
+        SDL_setenv("SDL_VIDEODRIVER", "dummy", 0);
+    }
     {
         int code = SDL_Init(SDL_INIT_VIDEO | SDL_INIT_TIMER);
         if (code != 0) {
@@ -12,8 +134,38 @@ int main(int, char**) {
         }
     }
 
-    wotmin2d::Battle b(100, 100, 1000, 1000);
-    b.start();
+    std::unique_ptr<wotmin2d::Battle> b;
+    if (snapshot != nullptr) {
+        b.reset(new wotmin2d::Battle(*snapshot, 1000, 1000, headless));
+    } else {
+        b.reset(new wotmin2d::Battle(scenario, 1000, 1000, headless));
+        if (recorder != nullptr) {
+            b->record(std::move(recorder));
+        }
+    }
+    b->setTickLimit(tick_limit);
+    try {
+        if (!frames_path.empty()) {
+            b->exportFrames(frames_path);
+        }
+        if (!frame_ring_name.empty()) {
+            b->publishFrames(frame_ring_name);
+        }
+    } catch (const wotmin2d::IoException& e) {
+        std::cerr << e.what() << std::endl;
+        SDL_Quit();
+        return 1;
+    }
+    if (!stream_path.empty()) {
+        try {
+            b->stream(stream_path);
+        } catch (const wotmin2d::IoException& e) {
+            std::cerr << e.what() << std::endl;
+            SDL_Quit();
+            return 1;
+        }
+    }
+    b->start();
 
     SDL_Quit();
     return 0;
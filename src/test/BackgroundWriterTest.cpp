@@ -0,0 +1,48 @@
+#include "../io/BackgroundWriter.hpp"
+#include "../io/IoException.hpp"
+
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace wotmin2d {
+namespace test {
+
+TEST(BackgroundWriterTest, writesItemsInOrder) {
+    std::vector<int> written;
+    BackgroundWriter<int> writer(2, [&](const int& item, bool) {
+        written.push_back(item);
+    });
+    for (int i = 0; i < 10; i++) {
+        writer.enqueue(std::move(i));
+    }
+    writer.flush();
+    std::vector<int> expected = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+    EXPECT_EQ(expected, written);
+}
+
+TEST(BackgroundWriterTest, reusesWrittenItems) {
+    BackgroundWriter<std::vector<int>> writer(2,
+        [](const std::vector<int>&, bool) {});
+    EXPECT_TRUE(writer.takeSpare().empty());
+    writer.enqueue(std::vector<int>(100, 1));
+    writer.flush();
+    EXPECT_GE(writer.takeSpare().capacity(), 100u);
+}
+
+TEST(BackgroundWriterTest, dropsItemsAfterAnError) {
+    std::vector<int> written;
+    BackgroundWriter<int> writer(2, [&](const int& item, bool) {
+        if (item == 1) {
+            throw IoException("Disk full.");
+        }
+        written.push_back(item);
+    });
+    writer.enqueue(0);
+    writer.enqueue(1);
+    EXPECT_THROW(writer.flush(), IoException);
+    EXPECT_THROW(writer.enqueue(2), IoException);
+    EXPECT_EQ(std::vector<int>{ 0 }, written);
+}
+
+}
+}
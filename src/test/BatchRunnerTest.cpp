@@ -0,0 +1,139 @@
+#include "../BatchRunner.hpp"
+#include "../game/State.hpp"
+#include "../game/Shape.hpp"
+#include "../game/Vector.hpp"
+#include "../Config.hpp"
+
+#include <gtest/gtest.h>
+#include <vector>
+#include <cstddef>
+
+namespace wotmin2d {
+namespace test {
+
+struct HeavyDamageConfig : Config {
+    constexpr static int particle_damage = 50;
+};
+
+class BatchRunnerTest : public ::testing::Test {
+    protected:
+    BatchRunnerTest() :
+        settings() {
+        settings.arena_width = 50;
+        settings.arena_height = 50;
+        settings.min_radius = 3.0f;
+        settings.max_radius = 6.0f;
+        settings.max_ticks = 600;
+        settings.seed = 7;
+    }
+    BatchRunner::Settings settings;
+};
+
+TEST_F(BatchRunnerTest, placesBlobsApart) {
+    BatchRunner runner(settings);
+    for (std::uint64_t trial = 0; trial < 20; trial++) {
+        State<> state(50, 50);
+        runner.makeScenario(trial).populate(state);
+        ASSERT_EQ(2, state.getBlobs().size());
+        for (const auto& id_blob: state.getBlobs()) {
+            EXPECT_FALSE(id_blob.second.getParticles().empty());
+        }
+    }
+}
+
+TEST_F(BatchRunnerTest, keepsBlobSizeInTightArena) {
+    settings.arena_width = 30;
+    settings.arena_height = 30;
+    settings.min_radius = 5.0f;
+    settings.max_radius = 5.0f;
+    ASSERT_TRUE(BatchRunner::fitsArena(settings));
+    BatchRunner runner(settings);
+    std::size_t circle_size = Shape::circle(IntVector(10, 10), 5.0f).count();
+    for (std::uint64_t trial = 0; trial < 50; trial++) {
+        State<> state(30, 30);
+        runner.makeScenario(trial).populate(state);
+        ASSERT_EQ(2, state.getBlobs().size());
+        for (const auto& id_blob: state.getBlobs()) {
+            EXPECT_EQ(circle_size, id_blob.second.getParticles().size());
+        }
+    }
+}
+
+TEST_F(BatchRunnerTest, rejectsBlobsTooLargeForArena) {
+    EXPECT_TRUE(BatchRunner::fitsArena(settings));
+    settings.arena_width = 20;
+    settings.arena_height = 20;
+    settings.min_radius = 25.0f;
+    settings.max_radius = 30.0f;
+    EXPECT_FALSE(BatchRunner::fitsArena(settings));
+    settings.min_radius = 3.0f;
+    settings.max_radius = 6.0f;
+    EXPECT_FALSE(BatchRunner::fitsArena(settings));
+}
+
+TEST_F(BatchRunnerTest, resultsDoNotDependOnThreads) {
+    BatchRunner runner(settings);
+    std::vector<BatchRunner::TrialResult> serial = runner.run(6, 1);
+    std::vector<BatchRunner::TrialResult> parallel = runner.run(6, 3);
+    ASSERT_EQ(6, serial.size());
+    ASSERT_EQ(6, parallel.size());
+    for (std::size_t i = 0; i < serial.size(); i++) {
+        EXPECT_EQ(i, parallel[i].trial);
+        EXPECT_EQ(serial[i].ticks, parallel[i].ticks);
+        EXPECT_EQ(serial[i].decided, parallel[i].decided);
+        EXPECT_EQ(serial[i].surviving_particles,
+                  parallel[i].surviving_particles);
+    }
+}
+
+TEST_F(BatchRunnerTest, blobsFight) {
+    BatchRunner runner(settings);
+    BatchRunner::TrialResult result = runner.runTrial(0);
+    std::size_t lost = 0;
+    for (const auto& id_count: result.initial_particles) {
+        lost += id_count.second - result.surviving_particles.at(id_count.first);
+    }
+    EXPECT_GT(lost, 0);
+}
+
+TEST_F(BatchRunnerTest, runsWithConfigPolicy) {
+    settings.max_ticks = 2000;
+    BatchRunner runner(settings);
+    BatchRunner::TrialResult normal = runner.runTrial(0);
+    BatchRunner::TrialResult heavy = runner.runTrial<HeavyDamageConfig>(0);
+    ASSERT_TRUE(normal.decided);
+    ASSERT_TRUE(heavy.decided);
+    EXPECT_EQ(normal.initial_particles, heavy.initial_particles);
+    EXPECT_LT(heavy.ticks, normal.ticks);
+}
+
+TEST_F(BatchRunnerTest, aggregatesResults) {
+    std::vector<BatchRunner::TrialResult> results(3);
+    results[0].ticks = 100;
+    results[0].decided = true;
+    results[0].initial_particles = {{0, 10}, {1, 20}};
+    results[0].surviving_particles = {{0, 0}, {1, 5}};
+    results[1].ticks = 300;
+    results[1].decided = true;
+    results[1].initial_particles = {{0, 10}, {1, 20}};
+    results[1].surviving_particles = {{0, 4}, {1, 0}};
+    results[2].ticks = 1000;
+    results[2].decided = false;
+    results[2].initial_particles = {{0, 10}, {1, 20}};
+    results[2].surviving_particles = {{0, 2}, {1, 1}};
+    BatchStatistics statistics(results);
+    EXPECT_EQ(3, statistics.getTrialCount());
+    EXPECT_EQ(2, statistics.getDecidedCount());
+    EXPECT_EQ(1, statistics.getWins(0));
+    EXPECT_EQ(1, statistics.getWins(1));
+    EXPECT_EQ(0, statistics.getWins(2));
+    EXPECT_DOUBLE_EQ(200.0, statistics.getMeanDecisionTicks());
+    EXPECT_EQ(100, statistics.getMinDecisionTicks());
+    EXPECT_EQ(300, statistics.getMaxDecisionTicks());
+    EXPECT_DOUBLE_EQ(2.0, statistics.getMeanSurvivors(0));
+    EXPECT_DOUBLE_EQ(8.0, statistics.getMeanLost(0));
+    EXPECT_DOUBLE_EQ(18.0, statistics.getMeanLost(1));
+}
+
+}
+}
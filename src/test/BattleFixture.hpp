@@ -0,0 +1,42 @@
+#ifndef BATTLEFIXTURE_HPP
+#define BATTLEFIXTURE_HPP
+
+#include "../game/Snapshot.hpp"
+#include "../game/State.hpp"
+#include "../game/Vector.hpp"
+#include "../io/Scenario.hpp"
+
+#include <gtest/gtest.h>
+
+namespace wotmin2d {
+namespace test {
+
+/**
+ * Two round blobs in opposite corners of the arena, each heading past the
+ * other, so that they meet in the middle after a few dozen ticks of 50 ms.
+ */
+class BattleFixture : public ::testing::Test {
+    protected:
+    BattleFixture() :
+        state(width, height) {
+        Scenario scenario(width, height);
+        scenario.addCircle(0, IntVector(20, 20), 8.0f);
+        scenario.addCircle(1, IntVector(40, 40), 8.0f);
+        scenario.setTarget(0, IntVector(45, 45), 30.0f);
+        scenario.setTarget(1, IntVector(15, 15), 30.0f);
+        scenario.populate(state);
+    }
+    static StateSnapshot snapshot(const State<>& state) {
+        StateSnapshot snapshot;
+        state.snapshot(snapshot);
+        return snapshot;
+    }
+    static const unsigned int width = 60;
+    static const unsigned int height = 60;
+    State<> state;
+};
+
+}
+}
+
+#endif
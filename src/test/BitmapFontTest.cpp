@@ -0,0 +1,41 @@
+#include "../display/BitmapFont.hpp"
+
+#include <gtest/gtest.h>
+
+namespace wotmin2d {
+namespace test {
+
+TEST(BitmapFontTest, drawsGlyphsFromTheTopLeft) {
+    const BitmapFont::Glyph& one = BitmapFont::getGlyph('1');
+    // The top of the stem.
+    EXPECT_TRUE(BitmapFont::isSet(one, 2, 0));
+    EXPECT_FALSE(BitmapFont::isSet(one, 0, 0));
+    // The foot spans three columns.
+    EXPECT_TRUE(BitmapFont::isSet(one, 1, 6));
+    EXPECT_TRUE(BitmapFont::isSet(one, 3, 6));
+    EXPECT_FALSE(BitmapFont::isSet(one, 4, 6));
+}
+
+TEST(BitmapFontTest, showsLowerCaseAsUpperCase) {
+    EXPECT_EQ(BitmapFont::getGlyph('M'), BitmapFont::getGlyph('m'));
+    EXPECT_NE(BitmapFont::getGlyph('M'), BitmapFont::getGlyph('N'));
+}
+
+TEST(BitmapFontTest, showsUnknownCharactersAsQuestionMarks) {
+    EXPECT_EQ(BitmapFont::getGlyph('?'), BitmapFont::getGlyph('~'));
+    EXPECT_EQ(BitmapFont::getGlyph('?'), BitmapFont::getGlyph('\n'));
+    for (unsigned int y = 0; y < BitmapFont::glyph_height; y++) {
+        for (unsigned int x = 0; x < BitmapFont::glyph_width; x++) {
+            EXPECT_FALSE(BitmapFont::isSet(BitmapFont::getGlyph(' '), x, y));
+        }
+    }
+}
+
+TEST(BitmapFontTest, measuresTextWithoutTrailingGap) {
+    EXPECT_EQ(0u, BitmapFont::getWidth(""));
+    EXPECT_EQ(5u, BitmapFont::getWidth("A"));
+    EXPECT_EQ(17u, BitmapFont::getWidth("ABC"));
+}
+
+}
+}
@@ -1,5 +1,7 @@
 #include "../game/BlobState.hpp"
 #include "../game/Particle.hpp"
+#include "../game/MemoryUsage.hpp"
+#include "../game/Shape.hpp"
 #include "mock/MockParticle.hpp"
 #include "../game/Vector.hpp"
 #include "../Config.hpp"
@@ -9,6 +11,8 @@
 #include <chrono>
 #include <algorithm>
 #include <unordered_set>
+#include <cstddef>
+#include <vector>
 
 namespace wotmin2d {
 namespace test {
@@ -62,6 +66,68 @@ TEST_F(BlobStateTest, addsParticles) {
                             [=](P* p) { return p->getPosition() == pos2; }));
 }
 
+TEST_F(BlobStateTest, addsParticlesOfShape) {
+    Shape shape = Shape::circle(IntVector(5, 5), 2.0f);
+    real_state.addParticles(shape);
+    EXPECT_EQ(shape.count(), real_state.getParticles().size());
+    for (int x = 0; x < 10; x++) {
+        for (int y = 0; y < 10; y++) {
+            IntVector position(x, y);
+            Particle* particle = real_state.getParticleAt(position);
+            if (shape.contains(position)) {
+                ASSERT_NE(nullptr, particle);
+                EXPECT_EQ(position, particle->getPosition());
+            } else {
+                EXPECT_EQ(nullptr, particle);
+            }
+        }
+    }
+}
+
+TEST_F(BlobStateTest, setsNeighborsWithinShape) {
+    std::vector<bool> mask = { true, true, false,
+                               false, true, true };
+    real_state.addParticles(Shape::fromMask(IntVector(0, 0), 3, 2, mask));
+    Particle* bottom_left = real_state.getParticleAt(IntVector(0, 0));
+    Particle* bottom_middle = real_state.getParticleAt(IntVector(1, 0));
+    Particle* top_middle = real_state.getParticleAt(IntVector(1, 1));
+    Particle* top_right = real_state.getParticleAt(IntVector(2, 1));
+    EXPECT_EQ(bottom_middle, bottom_left->getNeighbor(Direction::east()));
+    EXPECT_EQ(bottom_left, bottom_middle->getNeighbor(Direction::west()));
+    EXPECT_EQ(top_middle, bottom_middle->getNeighbor(Direction::north()));
+    EXPECT_EQ(bottom_middle, top_middle->getNeighbor(Direction::south()));
+    EXPECT_EQ(top_right, top_middle->getNeighbor(Direction::east()));
+    EXPECT_EQ(top_middle, top_right->getNeighbor(Direction::west()));
+    EXPECT_EQ(nullptr, bottom_left->getNeighbor(Direction::north()));
+    EXPECT_EQ(nullptr, bottom_middle->getNeighbor(Direction::east()));
+    EXPECT_EQ(nullptr, top_right->getNeighbor(Direction::south()));
+    EXPECT_EQ(nullptr, top_middle->getNeighbor(Direction::west()));
+}
+
+TEST_F(BlobStateTest, setsNeighborsBetweenShapeAndExistingParticles) {
+    real_state.addParticle(IntVector(1, 2));
+    real_state.addParticle(IntVector(0, 0));
+    real_state.addParticles(Shape::rectangle(IntVector(1, 0), 2, 2));
+    Particle* above = real_state.getParticleAt(IntVector(1, 2));
+    Particle* left = real_state.getParticleAt(IntVector(0, 0));
+    Particle* top_left = real_state.getParticleAt(IntVector(1, 1));
+    Particle* bottom_left = real_state.getParticleAt(IntVector(1, 0));
+    EXPECT_EQ(top_left, above->getNeighbor(Direction::south()));
+    EXPECT_EQ(above, top_left->getNeighbor(Direction::north()));
+    EXPECT_EQ(bottom_left, left->getNeighbor(Direction::east()));
+    EXPECT_EQ(left, bottom_left->getNeighbor(Direction::west()));
+}
+
+TEST_F(BlobStateTest, addsShapeParticlesToMobilityIndex) {
+    real_state.addParticle(IntVector(10, 10));
+    Particle* mover = realParticleAt(IntVector(10, 10));
+    mover->setTarget(IntVector(15, 10),
+                     2.0f * Config::min_directed_movement_pressure);
+    real_state.advanceParticles(one_second);
+    real_state.addParticles(Shape::rectangle(IntVector(0, 0), 3, 3));
+    EXPECT_EQ(mover, real_state.getHighestMobilityParticle());
+}
+
 TEST_F(BlobStateTest, advancesAllParticles) {
     IntVector pos1(0, 0);
     IntVector pos2(0, 1);
@@ -569,5 +635,73 @@ TEST_F(BlobStateTest, calculatesParticleStrength) {
     EXPECT_EQ((2 * so + 1) * (2 * so + 1), state.getParticleStrength(*center));
 }
 
+TEST_F(BlobStateTest, breaksMobilityTiesByPosition) {
+    real_state.addParticle(IntVector(5, 5));
+    real_state.addParticle(IntVector(1, 7));
+    real_state.addParticle(IntVector(3, 2));
+    real_state.addParticle(IntVector(0, 2));
+    // None of them can move, so the lowest row comes first, then the leftmost
+    // particle in it, whatever order they were added in.
+    EXPECT_EQ(IntVector(0, 2),
+              real_state.getHighestMobilityParticle()->getPosition());
+}
+
+TEST_F(BlobStateTest, keepsMobilityIndexCurrentWhenAdvancing) {
+    real_state.addParticles(Shape::rectangle(IntVector(0, 0), 4, 3));
+    for (Particle* particle: real_state.getParticles()) {
+        particle->setTarget(IntVector(20, 20),
+                            1.0f + particle->getPosition().getX());
+    }
+    // Leaders push their followers when advancing, so those have to be put
+    // in their new place too.
+    real_state.addParticleFollowers(*realParticleAt(IntVector(3, 1)),
+                                    { realParticleAt(IntVector(2, 1)),
+                                      realParticleAt(IntVector(3, 0)) });
+    for (int i = 0; i < 3; i++) {
+        real_state.advanceParticles(one_second);
+    }
+    float highest = -1.0f;
+    for (Particle* particle: real_state.getParticles()) {
+        float mobility = particle->canMove()
+            ? particle->getPressure().squaredNorm() : -1.0f;
+        EXPECT_EQ(mobility, particle->getMobility());
+        highest = std::max(highest, mobility);
+    }
+    EXPECT_LT(0.0f, highest);
+    EXPECT_EQ(highest,
+              real_state.getHighestMobilityParticle()->getMobility());
+}
+
+TEST_F(BlobStateTest, reportsNoMemoryUsageForParticlesWhenEmpty) {
+    MemoryUsage usage = real_state.getMemoryUsage();
+    EXPECT_EQ(0, usage.getParticleCount());
+    EXPECT_EQ(0, usage.getRelationBytes());
+    EXPECT_EQ(0.0f, usage.getBytesPerParticle());
+}
+
+TEST_F(BlobStateTest, reportsMemoryUsageOfParticles) {
+    real_state.addParticle(IntVector(0, 0));
+    real_state.addParticle(IntVector(0, 1));
+    real_state.addParticle(IntVector(5, 7));
+    MemoryUsage usage = real_state.getMemoryUsage();
+    EXPECT_EQ(3, usage.getParticleCount());
+    EXPECT_GE(usage.getParticleBytes(), 3 * sizeof(Particle));
+    EXPECT_GT(usage.getParticleSetBytes(), 0);
+    EXPECT_GT(usage.getParticleMapBytes(), 0);
+    EXPECT_EQ(usage.getParticleBytes() + usage.getRelationBytes()
+              + usage.getParticleSetBytes() + usage.getParticleMapBytes(),
+              usage.getTotalBytes());
+}
+
+TEST_F(BlobStateTest, reportsMemoryUsageOfFollowers) {
+    real_state.addParticle(IntVector(0, 0));
+    real_state.addParticle(IntVector(0, 1));
+    std::size_t bytes_before = real_state.getMemoryUsage().getRelationBytes();
+    Particle* leader = realParticleAt(IntVector(0, 0));
+    Particle* follower = realParticleAt(IntVector(0, 1));
+    real_state.addParticleFollowers(*leader, { follower });
+    EXPECT_GT(real_state.getMemoryUsage().getRelationBytes(), bytes_before);
+}
+
 }
 }
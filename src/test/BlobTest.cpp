@@ -3,6 +3,7 @@
 #include "../game/BlobState.hpp"
 #include "../game/Blob.hpp"
 #include "../game/Vector.hpp"
+#include "../game/Shape.hpp"
 #include "TestData.hpp"
 
 #include <gtest/gtest.h>
@@ -33,6 +34,7 @@ using ::testing::AnyNumber;
 using ::testing::Ne;
 using ::testing::InSequence;
 using ::testing::DoDefault;
+using ::testing::SaveArg;
 
 using P = NiceMockParticle;
 using B = NiceMockBlobState;
@@ -53,6 +55,7 @@ class BlobTest : public ::testing::Test {
 
 TEST_F(BlobTest, normalConstructorDoesntAddParticles) {
     EXPECT_CALL(*state, addParticle(_)).Times(0);
+    EXPECT_CALL(*state, addParticles(_)).Times(0);
     Blob<P, B> blob(state);
 }
 
@@ -61,6 +64,11 @@ TEST_F(BlobTest, circleConstructorAddsParticles) {
     FloatVector center_float = static_cast<FloatVector>(center);
     float radius = 3.0f;
     int radius_ceil = static_cast<int>(std::ceil(radius) + 1);
+    Shape shape;
+    EXPECT_CALL(*state, addParticle(_)).Times(0);
+    EXPECT_CALL(*state, addParticles(_)).WillOnce(SaveArg<0>(&shape));
+    Blob<P, B> blob(center, radius, td.width, td.height,
+                                 state);
     for (int x = center.getX() - radius_ceil; x < center.getX() + radius_ceil;
          x++)
     {
@@ -70,20 +78,23 @@ TEST_F(BlobTest, circleConstructorAddsParticles) {
             IntVector position(x, y);
             FloatVector position_float = static_cast<FloatVector>(position);
             if ((center_float - position_float).norm() <= radius) {
-                EXPECT_CALL(*state, addParticle(position)).Times(1);
+                EXPECT_TRUE(shape.contains(position)) << position;
             } else {
-                EXPECT_CALL(*state, addParticle(position)).Times(0);
+                EXPECT_FALSE(shape.contains(position)) << position;
             }
         }
     }
-    Blob<P, B> blob(center, radius, td.width, td.height,
-                                 state);
 }
 
 TEST_F(BlobTest, circleConstructorDoesntAddParticlesWithNegativeCoordinates) {
     IntVector center(1, 1);
     float radius = 3.0f;
     int radius_ceil = static_cast<int>(std::ceil(radius) + 1);
+    Shape shape;
+    EXPECT_CALL(*state, addParticles(_)).WillOnce(SaveArg<0>(&shape));
+    Blob<P, B> blob(center, radius, td.width, td.height,
+                                 state);
+    EXPECT_TRUE(shape.contains(IntVector(0, 0)));
     for (int x = center.getX() - radius_ceil; x < center.getX() + radius_ceil;
          x++)
     {
@@ -92,14 +103,10 @@ TEST_F(BlobTest, circleConstructorDoesntAddParticlesWithNegativeCoordinates) {
         {
             IntVector position(x, y);
             if (x < 0 || y < 0) {
-                EXPECT_CALL(*state, addParticle(position)).Times(0);
-            } else {
-                EXPECT_CALL(*state, addParticle(position)).Times(AnyNumber());
+                EXPECT_FALSE(shape.contains(position)) << position;
             }
         }
     }
-    Blob<P, B> blob(center, radius, td.width, td.height,
-                                 state);
 }
 
 TEST_F(BlobTest, circleConstructorDoesntAddParticlesOutOfBounds) {
@@ -108,6 +115,11 @@ TEST_F(BlobTest, circleConstructorDoesntAddParticlesOutOfBounds) {
     int radius_ceil = static_cast<int>(std::ceil(radius) + 1);
     int max_x = td.width - 1;
     int max_y = td.height - 1;
+    Shape shape;
+    EXPECT_CALL(*state, addParticles(_)).WillOnce(SaveArg<0>(&shape));
+    Blob<P, B> blob(center, radius, td.width, td.height,
+                                 state);
+    EXPECT_TRUE(shape.contains(IntVector(max_x, max_y)));
     for (int x = center.getX() - radius_ceil; x < center.getX() + radius_ceil;
          x++)
     {
@@ -116,21 +128,40 @@ TEST_F(BlobTest, circleConstructorDoesntAddParticlesOutOfBounds) {
         {
             IntVector position(x, y);
             if (x > max_x || y > max_y) {
-                EXPECT_CALL(*state, addParticle(position)).Times(0);
-            } else {
-                EXPECT_CALL(*state, addParticle(position)).Times(AnyNumber());
+                EXPECT_FALSE(shape.contains(position)) << position;
             }
         }
     }
-    Blob<P, B> blob(center, radius, td.width, td.height,
-                                 state);
 }
 
 TEST_F(BlobTest, circleConstructorDoesntAddParticlesIfCenterIsOutOfBounds) {
     IntVector center(td.width + 4, td.height + 4);
     float radius = 3.0f;
+    Shape shape;
     EXPECT_CALL(*state, addParticle(_)).Times(0);
+    EXPECT_CALL(*state, addParticles(_))
+        .Times(AtMost(1))
+        .WillRepeatedly(SaveArg<0>(&shape));
     Blob<P, B> blob(center, radius, td.width, td.height, state);
+    EXPECT_TRUE(shape.empty());
+}
+
+TEST_F(BlobTest, shapeConstructorAddsClippedShape) {
+    Shape shape = Shape::rectangle(IntVector(-2, 3), 5, 4);
+    Shape added;
+    EXPECT_CALL(*state, addParticles(_)).WillOnce(SaveArg<0>(&added));
+    Blob<P, B> blob(shape, td.width, td.height, state);
+    EXPECT_EQ(Shape::rectangle(IntVector(0, 3), 3, 4), added);
+}
+
+TEST_F(BlobTest, setsTargetOfAllParticles) {
+    td.makeParticles({ td.lineA, td.block }, { td.inside });
+    IntVector target(20, 20);
+    for (P* particle: td.particles) {
+        EXPECT_CALL(*particle, setTarget(target, 3.0f)).Times(1);
+    }
+    Blob<P, B> blob(state);
+    blob.setTarget(target, 3.0f);
 }
 
 TEST_F(BlobTest, advancesParticles) {
@@ -0,0 +1,76 @@
+#include "BattleFixture.hpp"
+#include "../game/CheckpointRing.hpp"
+#include "../game/Snapshot.hpp"
+#include "../game/State.hpp"
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <chrono>
+
+namespace wotmin2d {
+namespace test {
+
+class CheckpointRingTest : public BattleFixture {
+    protected:
+    CheckpointRingTest() :
+        checkpoints(3, 10),
+        tick(0) {
+    }
+    void run(std::uint64_t ticks) {
+        for (std::uint64_t i = 0; i < ticks; i++) {
+            state.advance(std::chrono::milliseconds(50));
+            tick++;
+            if (checkpoints.isDue(tick)) {
+                checkpoints.save(tick, state);
+            }
+        }
+    }
+    CheckpointRing checkpoints;
+    std::uint64_t tick;
+};
+
+TEST_F(CheckpointRingTest, keepsMostRecentCheckpoints) {
+    run(45);
+    EXPECT_EQ(3, checkpoints.getSize());
+    EXPECT_EQ(20, checkpoints.getOldestTick());
+    EXPECT_EQ(40, checkpoints.getNewestTick());
+    EXPECT_EQ(nullptr, checkpoints.find(19));
+    ASSERT_NE(nullptr, checkpoints.find(39));
+    EXPECT_EQ(*checkpoints.find(30), *checkpoints.find(39));
+}
+
+TEST_F(CheckpointRingTest, rewindsToCheckpoint) {
+    run(30);
+    StateSnapshot at_30 = snapshot(state);
+    run(15);
+    std::uint64_t rewound_tick = 37;
+    ASSERT_TRUE(checkpoints.rewind(rewound_tick, state));
+    EXPECT_EQ(30, rewound_tick);
+    EXPECT_EQ(at_30, snapshot(state));
+    // Later checkpoints are gone, the simulation continues from here.
+    EXPECT_EQ(30, checkpoints.getNewestTick());
+}
+
+TEST_F(CheckpointRingTest, continuesIdenticallyAfterRewind) {
+    run(20);
+    run(15);
+    StateSnapshot at_35 = snapshot(state);
+    tick = 25;
+    ASSERT_TRUE(checkpoints.rewind(tick, state));
+    EXPECT_EQ(20, tick);
+    run(15);
+    EXPECT_EQ(at_35, snapshot(state));
+    EXPECT_EQ(30, checkpoints.getNewestTick());
+}
+
+TEST_F(CheckpointRingTest, refusesToRewindPastOldestCheckpoint) {
+    run(50);
+    StateSnapshot at_50 = snapshot(state);
+    std::uint64_t rewound_tick = 25;
+    EXPECT_FALSE(checkpoints.rewind(rewound_tick, state));
+    EXPECT_EQ(25, rewound_tick);
+    EXPECT_EQ(at_50, snapshot(state));
+}
+
+}
+}
@@ -0,0 +1,62 @@
+#include "../game/CircleMask.hpp"
+#include "../game/Shape.hpp"
+#include "../game/Vector.hpp"
+
+#include <gtest/gtest.h>
+#include <set>
+#include <utility>
+
+namespace wotmin2d {
+namespace test {
+
+TEST(CircleMaskTest, negativeRadiusIsEmpty) {
+    CircleMask mask(-1.0f);
+    EXPECT_TRUE(mask.empty());
+    EXPECT_EQ(0u, mask.count());
+    EXPECT_TRUE(mask.getOutline().empty());
+    EXPECT_FALSE(mask.contains(IntVector(0, 0)));
+    EXPECT_TRUE(CircleMask().empty());
+}
+
+TEST(CircleMaskTest, containsCellsWithinRadius) {
+    for (float radius: { 0.0f, 0.5f, 1.0f, 1.9f, 2.5f, 5.0f, 7.3f }) {
+        CircleMask mask(radius);
+        int squared_radius = static_cast<int>(radius * radius);
+        for (int y = -10; y <= 10; y++) {
+            for (int x = -10; x <= 10; x++) {
+                IntVector offset(x, y);
+                EXPECT_EQ(offset.squaredNorm() <= squared_radius,
+                          mask.contains(offset))
+                    << "radius " << radius << ", offset " << offset;
+            }
+        }
+        EXPECT_EQ(Shape::circle(IntVector(0, 0), radius).count(),
+                  mask.count()) << "radius " << radius;
+    }
+}
+
+TEST(CircleMaskTest, outlinesTheBorderOnce) {
+    CircleMask mask(4.5f);
+    std::set<std::pair<int, int>> cells;
+    for (const IntVector& offset: mask.getOutline()) {
+        EXPECT_TRUE(mask.contains(offset)) << offset;
+        cells.emplace(offset.getX(), offset.getY());
+    }
+    EXPECT_EQ(mask.getOutline().size(), cells.size());
+    EXPECT_EQ(1u, cells.count({ 0, 4 }));
+    EXPECT_EQ(1u, cells.count({ -4, 0 }));
+    EXPECT_EQ(0u, cells.count({ 0, 0 }));
+    EXPECT_EQ(1u, CircleMask(0.0f).getOutline().size());
+}
+
+TEST(CircleMaskTest, onlyRebuildsForNewRadius) {
+    CircleMask mask(3.0f);
+    EXPECT_FALSE(mask.update(3.0f));
+    EXPECT_TRUE(mask.update(1.0f));
+    EXPECT_EQ(1.0f, mask.getRadius());
+    EXPECT_EQ(1, mask.getExtent());
+    EXPECT_EQ(5u, mask.count());
+}
+
+}
+}
@@ -0,0 +1,179 @@
+#include "../display/DebugSnapshot.hpp"
+#include "../display/Viewport.hpp"
+#include "../game/State.hpp"
+#include "../game/Vector.hpp"
+#include "../io/Scenario.hpp"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+
+namespace wotmin2d {
+namespace test {
+
+class DebugSnapshotTest : public ::testing::Test {
+    protected:
+    DebugSnapshotTest() :
+        state(40, 30),
+        viewport(40, 30, 40, 30),
+        snapshot() {
+        Scenario scenario(40, 30);
+        scenario.addCircle(0, IntVector(10, 10), 4.0f);
+        scenario.addCircle(1, IntVector(30, 20), 4.0f);
+        scenario.setTarget(0, IntVector(35, 25), 30.0f);
+        scenario.populate(state);
+        for (int i = 0; i < 5; i++) {
+            state.advance(std::chrono::milliseconds(50));
+        }
+    }
+    std::size_t countParticles() const {
+        std::size_t count = 0;
+        for (const auto& id_blob: state.getBlobs()) {
+            count += id_blob.second.getParticles().size();
+        }
+        return count;
+    }
+    State<> state;
+    Viewport viewport;
+    DebugSnapshot snapshot;
+};
+
+TEST_F(DebugSnapshotTest, capturesNothingWithoutLayers) {
+    snapshot.capture(state, viewport, 0, 7);
+    EXPECT_EQ(0u, snapshot.getLayers());
+    EXPECT_EQ(7u, snapshot.getTick());
+    EXPECT_TRUE(snapshot.getLinks().empty());
+}
+
+TEST_F(DebugSnapshotTest, countsParticlesInBlocks) {
+    snapshot.capture(state, viewport, DebugSnapshot::pressure_layer, 0);
+    ASSERT_EQ(0, viewport.getZoom());
+    // Blocks of 8 pixels are 8 cells at this zoom.
+    ASSERT_EQ(8u, snapshot.getBlockCells());
+    ASSERT_EQ(5u, snapshot.getColumns());
+    ASSERT_EQ(4u, snapshot.getRows());
+    std::size_t total = 0;
+    for (unsigned int row = 0; row < 4; row++) {
+        for (unsigned int column = 0; column < 5; column++) {
+            std::uint32_t expected = 0;
+            FloatVector pressure(0.0f, 0.0f);
+            for (const auto& id_blob: state.getBlobs()) {
+                for (const Particle* particle: id_blob.second.getParticles()) {
+                    const IntVector& position = particle->getPosition();
+                    if (position.getX() / 8 == static_cast<int>(column)
+                        && position.getY() / 8 == static_cast<int>(row)) {
+                        expected++;
+                        pressure += particle->getPressure();
+                    }
+                }
+            }
+            const DebugSnapshot::Block& block
+                = snapshot.getBlock(column, row);
+            EXPECT_EQ(expected, block.particles);
+            if (expected > 0) {
+                pressure /= static_cast<float>(expected);
+                EXPECT_NEAR(pressure.getX(), block.pressure.getX(), 1e-4f);
+                EXPECT_NEAR(pressure.getY(), block.pressure.getY(), 1e-4f);
+                EXPECT_LE(block.pressure.norm(),
+                          snapshot.getMaxPressure() + 1e-4f);
+            }
+            total += block.particles;
+        }
+    }
+    EXPECT_EQ(countParticles(), total);
+}
+
+TEST_F(DebugSnapshotTest, capturesStrengthOfBlocks) {
+    snapshot.capture(state, viewport, DebugSnapshot::strength_layer, 0);
+    // A particle counts the 9 by 9 cells around it.
+    EXPECT_EQ(81, snapshot.getMaxStrength());
+    const DebugSnapshot::Block& center = snapshot.getBlock(1, 1);
+    ASSERT_GT(center.particles, 0u);
+    EXPECT_GT(center.strength, 0);
+    EXPECT_LE(center.strength, snapshot.getMaxStrength());
+    const DebugSnapshot::Block& empty = snapshot.getBlock(4, 0);
+    EXPECT_EQ(0u, empty.particles);
+    EXPECT_EQ(0, empty.strength);
+}
+
+TEST_F(DebugSnapshotTest, linksFollowersToLeaders) {
+    snapshot.capture(state, viewport, DebugSnapshot::leadership_layer, 0);
+    std::size_t links = 0;
+    for (const auto& id_blob: state.getBlobs()) {
+        for (const Particle* particle: id_blob.second.getParticles()) {
+            links += particle->getConstLeaders().size();
+        }
+    }
+    ASSERT_GT(links, 0u);
+    ASSERT_LT(links, DebugSnapshot::max_links);
+    EXPECT_EQ(links, snapshot.getLinks().size());
+    for (const DebugSnapshot::Link& link: snapshot.getLinks()) {
+        const Particle* follower
+            = state.getBlobs().at(0).getParticleAt(link.follower);
+        ASSERT_NE(nullptr, follower);
+        const Particle* leader
+            = state.getBlobs().at(0).getParticleAt(link.leader);
+        EXPECT_EQ(1u, follower->getConstLeaders().count(
+            const_cast<Particle*>(leader)));
+    }
+}
+
+TEST_F(DebugSnapshotTest, onlyCapturesVisibleParticles) {
+    // Zoomed in twice, the 20 by 15 cells at the bottom left are visible,
+    // each 4 pixels wide, so blocks are 2 cells.
+    viewport = Viewport(40, 30, 80, 60);
+    viewport.pan(IntVector(-8, -8));
+    viewport.zoom(1, IntVector(0, 59));
+    ASSERT_EQ(IntVector(0, 0), viewport.getOrigin());
+    snapshot.capture(state, viewport, DebugSnapshot::pressure_layer, 0);
+    ASSERT_EQ(2u, snapshot.getBlockCells());
+    std::size_t visible = 0;
+    for (const auto& id_blob: state.getBlobs()) {
+        for (const Particle* particle: id_blob.second.getParticles()) {
+            const IntVector& position = particle->getPosition();
+            if (position.getX() < 20 && position.getY() < 15) {
+                visible++;
+            }
+        }
+    }
+    std::size_t captured = 0;
+    for (unsigned int row = 0; row < snapshot.getRows(); row++) {
+        for (unsigned int column = 0; column < snapshot.getColumns();
+             column++) {
+            captured += snapshot.getBlock(column, row).particles;
+        }
+    }
+    EXPECT_EQ(visible, captured);
+}
+
+TEST_F(DebugSnapshotTest, looksUpCellsOfLargeBlobs) {
+    // 600 particles, of which the 300 in the visible 20 by 15 cells are
+    // looked up cell by cell.
+    State<> large_state(40, 30);
+    Scenario scenario(40, 30);
+    scenario.addRectangle(0, IntVector(0, 0), 30, 20);
+    scenario.populate(large_state);
+    viewport = Viewport(40, 30, 80, 60);
+    viewport.pan(IntVector(-8, -8));
+    viewport.zoom(1, IntVector(0, 59));
+    ASSERT_EQ(IntVector(0, 0), viewport.getOrigin());
+    snapshot.capture(large_state, viewport, DebugSnapshot::pressure_layer, 0);
+    ASSERT_EQ(2u, snapshot.getBlockCells());
+    ASSERT_EQ(10u, snapshot.getColumns());
+    ASSERT_EQ(8u, snapshot.getRows());
+    std::size_t captured = 0;
+    for (unsigned int row = 0; row < snapshot.getRows(); row++) {
+        for (unsigned int column = 0; column < snapshot.getColumns();
+             column++) {
+            std::uint32_t particles = snapshot.getBlock(column, row).particles;
+            // The top row of blocks is only half visible.
+            EXPECT_EQ(row == 7 ? 2u : 4u, particles);
+            captured += particles;
+        }
+    }
+    EXPECT_EQ(300u, captured);
+}
+
+}
+}
@@ -0,0 +1,137 @@
+#include "BattleFixture.hpp"
+#include "../io/DeltaStream.hpp"
+#include "../game/ChangeLog.hpp"
+#include "../game/Snapshot.hpp"
+#include "../game/State.hpp"
+#include "../game/Vector.hpp"
+
+#include <gtest/gtest.h>
+#include <string>
+#include <map>
+#include <unordered_map>
+#include <cstdio>
+#include <cstdint>
+#include <chrono>
+
+namespace wotmin2d {
+namespace test {
+
+class DeltaStreamTest : public BattleFixture {
+    protected:
+    using Particles
+        = std::unordered_map<IntVector, unsigned int, IntVector::Hash>;
+    DeltaStreamTest() :
+        path(::testing::TempDir() + "DeltaStreamTest.delta") {
+    }
+    ~DeltaStreamTest() {
+        std::remove(path.c_str());
+    }
+    // Runs the battle while streaming it and returns the number of ticks.
+    std::uint64_t streamBattle() {
+        DeltaStreamWriter writer(path, snapshot(state));
+        state.setChangeLogging(true);
+        std::uint64_t tick = 0;
+        for (; tick < 150; tick++) {
+            state.advance(std::chrono::milliseconds(50));
+            writer.writeTick(tick + 1, state);
+        }
+        writer.flush();
+        return tick;
+    }
+    static void apply(const std::vector<ChangeLog::Change>& changes,
+                      Particles& particles) {
+        for (const ChangeLog::Change& change: changes) {
+            auto iter = particles.find(change.getPosition());
+            ASSERT_NE(particles.end(), iter);
+            switch (change.getType()) {
+            case ChangeLog::Change::Type::move: {
+                unsigned int health = iter->second;
+                particles.erase(iter);
+                IntVector to = change.getPosition()
+                               + change.getDirection().vector();
+                ASSERT_TRUE(particles.emplace(to, health).second);
+                break;
+            }
+            case ChangeLog::Change::Type::damage:
+                iter->second = change.getHealth();
+                break;
+            case ChangeLog::Change::Type::death:
+                particles.erase(iter);
+                break;
+            }
+        }
+    }
+    std::string path;
+};
+
+TEST_F(DeltaStreamTest, reconstructsBattle) {
+    std::uint64_t tick_count = streamBattle();
+    DeltaStreamReader reader(path);
+    std::map<StateSnapshot::PlayerId, Particles> particles;
+    for (const auto& id_blob: reader.getInitialState().getBlobs()) {
+        for (const ParticleRecord& record: id_blob.second.getParticles()) {
+            particles[id_blob.first].emplace(IntVector(record.x, record.y),
+                                             record.health);
+        }
+    }
+    std::uint64_t tick = 0;
+    std::uint64_t last_tick = 0;
+    std::size_t deaths = 0;
+    DeltaStreamReader::TickChanges changes;
+    while (reader.readTick(tick, changes)) {
+        EXPECT_GT(tick, last_tick);
+        last_tick = tick;
+        for (const auto& id_changes: changes) {
+            ASSERT_EQ(1, particles.count(id_changes.first));
+            apply(id_changes.second, particles.at(id_changes.first));
+            for (const ChangeLog::Change& change: id_changes.second) {
+                if (change.getType() == ChangeLog::Change::Type::death) {
+                    deaths++;
+                }
+            }
+        }
+    }
+    EXPECT_LE(last_tick, tick_count);
+    // The blobs have to have met for this test to mean something.
+    EXPECT_GT(deaths, 0);
+    ASSERT_EQ(state.getBlobs().size(), particles.size());
+    for (const auto& id_blob: state.getBlobs()) {
+        const Particles& reconstructed = particles.at(id_blob.first);
+        ASSERT_EQ(id_blob.second.getParticles().size(), reconstructed.size());
+        for (const auto& position_health: reconstructed) {
+            const Particle* particle
+                = id_blob.second.getParticleAt(position_health.first);
+            ASSERT_NE(nullptr, particle);
+            EXPECT_EQ(particle->getHealth(), position_health.second);
+        }
+    }
+}
+
+TEST_F(DeltaStreamTest, logsNothingByDefault) {
+    for (int i = 0; i < 20; i++) {
+        state.advance(std::chrono::milliseconds(50));
+    }
+    for (const auto& id_blob: state.getBlobs()) {
+        EXPECT_TRUE(id_blob.second.getChanges().getChanges().empty());
+    }
+}
+
+TEST_F(DeltaStreamTest, clearsChangesEveryTick) {
+    State<> other(width, height);
+    other.restore(snapshot(state));
+    state.setChangeLogging(true);
+    state.advance(std::chrono::milliseconds(50));
+    other.advance(std::chrono::milliseconds(50));
+    other.setChangeLogging(true);
+    state.advance(std::chrono::milliseconds(50));
+    other.advance(std::chrono::milliseconds(50));
+    for (const auto& id_blob: state.getBlobs()) {
+        const ChangeLog& changes = id_blob.second.getChanges();
+        EXPECT_FALSE(changes.getChanges().empty());
+        EXPECT_EQ(other.getBlobs().at(id_blob.first).getChanges().getChanges(),
+                  changes.getChanges());
+    }
+}
+
+}
+}
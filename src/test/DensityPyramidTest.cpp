@@ -0,0 +1,119 @@
+#include "../game/DensityPyramid.hpp"
+#include "../game/State.hpp"
+#include "../game/Vector.hpp"
+#include "../io/Scenario.hpp"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace wotmin2d {
+namespace test {
+
+TEST(DensityPyramidTest, countsParticlesAtEachLevel) {
+    DensityPyramid pyramid;
+    pyramid.reset(1000, 600);
+    pyramid.add(IntVector(0, 0));
+    pyramid.add(IntVector(1, 1));
+    pyramid.add(IntVector(300, 5));
+    EXPECT_EQ(2u, pyramid.getCount(1, 0, 0));
+    EXPECT_EQ(1u, pyramid.getCount(1, 150, 2));
+    EXPECT_EQ(2u, pyramid.getCount(8, 0, 0));
+    EXPECT_EQ(1u, pyramid.getCount(8, 1, 0));
+    EXPECT_EQ(0u, pyramid.getCount(8, 0, 1));
+}
+
+TEST(DensityPyramidTest, movesParticlesBetweenBlocks) {
+    DensityPyramid pyramid;
+    pyramid.reset(64, 64);
+    pyramid.add(IntVector(3, 3));
+    // Crosses the border of the blocks of 4 but not those of 8.
+    pyramid.move(IntVector(3, 3), IntVector(4, 3));
+    EXPECT_EQ(0u, pyramid.getCount(2, 0, 0));
+    EXPECT_EQ(1u, pyramid.getCount(2, 1, 0));
+    EXPECT_EQ(1u, pyramid.getCount(3, 0, 0));
+    pyramid.move(IntVector(4, 3), IntVector(4, 2));
+    EXPECT_EQ(1u, pyramid.getCount(1, 2, 1));
+    pyramid.remove(IntVector(4, 2));
+    for (unsigned int level = 1; level <= DensityPyramid::levels; level++) {
+        EXPECT_EQ(0u, pyramid.getCount(level, 0, 0));
+    }
+}
+
+TEST(DensityPyramidTest, coversPartialBlocksAtEdges) {
+    DensityPyramid pyramid;
+    pyramid.reset(10, 5);
+    EXPECT_EQ(3u, pyramid.getColumns(2));
+    EXPECT_EQ(2u, pyramid.getRows(2));
+    EXPECT_EQ(16u, pyramid.getArea(2, 0, 0));
+    EXPECT_EQ(8u, pyramid.getArea(2, 2, 0));
+    EXPECT_EQ(2u, pyramid.getArea(2, 2, 1));
+    EXPECT_EQ(50u, pyramid.getArea(DensityPyramid::levels, 0, 0));
+}
+
+TEST(DensityPyramidTest, countsFullBlocksInNarrowCounts) {
+    DensityPyramid pyramid;
+    pyramid.reset(256, 256);
+    for (int y = 0; y < 256; y++) {
+        for (int x = 0; x < 256; x++) {
+            pyramid.add(IntVector(x, y));
+        }
+    }
+    for (unsigned int level = 1; level <= DensityPyramid::levels; level++) {
+        EXPECT_EQ(1u << (2 * level), pyramid.getCount(level, 0, 0));
+    }
+    pyramid.remove(IntVector(0, 0));
+    EXPECT_EQ(255u, pyramid.getCount(4, 0, 0));
+    EXPECT_EQ(65535u, pyramid.getCount(8, 0, 0));
+    // About a third of a byte per cell.
+    EXPECT_LT(pyramid.getMemoryUsage(), 256u * 256u * 2u / 5u);
+}
+
+TEST(DensityPyramidTest, doesNothingUntilReset) {
+    DensityPyramid pyramid;
+    EXPECT_FALSE(pyramid.isEnabled());
+    pyramid.add(IntVector(3, 3));
+    pyramid.move(IntVector(3, 3), IntVector(4, 3));
+    EXPECT_EQ(0u, pyramid.getMemoryUsage());
+    pyramid.reset(8, 8);
+    EXPECT_TRUE(pyramid.isEnabled());
+    EXPECT_EQ(0u, pyramid.getCount(1, 1, 1));
+}
+
+TEST(DensityPyramidTest, followsParticlesOfABattle) {
+    State<> state(60, 40);
+    Scenario scenario(60, 40);
+    scenario.addCircle(0, IntVector(15, 20), 8.0f);
+    scenario.addCircle(1, IntVector(45, 20), 8.0f);
+    scenario.setTarget(0, IntVector(50, 20), 30.0f);
+    scenario.setTarget(1, IntVector(10, 20), 30.0f);
+    scenario.populate(state);
+    state.setDensityTracking(true);
+    for (int i = 0; i < 100; i++) {
+        state.advance(std::chrono::milliseconds(50));
+    }
+    for (const auto& id_blob: state.getBlobs()) {
+        const DensityPyramid& pyramid = id_blob.second.getDensity();
+        for (unsigned int level = 1; level <= DensityPyramid::levels;
+             level++) {
+            unsigned int columns = pyramid.getColumns(level);
+            std::vector<std::uint32_t> expected(
+                columns * pyramid.getRows(level), 0);
+            for (const auto* particle: id_blob.second.getParticles()) {
+                const IntVector& position = particle->getPosition();
+                expected[(position.getY() >> level) * columns
+                         + (position.getX() >> level)]++;
+            }
+            for (unsigned int row = 0; row < pyramid.getRows(level); row++) {
+                for (unsigned int column = 0; column < columns; column++) {
+                    EXPECT_EQ(expected[row * columns + column],
+                              pyramid.getCount(level, column, row));
+                }
+            }
+        }
+    }
+}
+
+}
+}
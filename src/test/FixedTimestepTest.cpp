@@ -0,0 +1,83 @@
+#include "../FixedTimestep.hpp"
+
+#include <gtest/gtest.h>
+#include <chrono>
+
+namespace wotmin2d {
+namespace test {
+
+class FixedTimestepTest : public ::testing::Test {
+    protected:
+    using Clock = FixedTimestep::Clock;
+    FixedTimestepTest() :
+        timestep(std::chrono::milliseconds(50), std::chrono::milliseconds(20),
+                 4),
+        start() {
+        timestep.start(start);
+    }
+    Clock::time_point at(int milliseconds) const {
+        return start + std::chrono::milliseconds(milliseconds);
+    }
+    FixedTimestep timestep;
+    Clock::time_point start;
+};
+
+TEST_F(FixedTimestepTest, paysOutWholeTicks) {
+    EXPECT_EQ(0, timestep.advance(at(49)));
+    EXPECT_EQ(1, timestep.advance(at(50)));
+    EXPECT_EQ(0, timestep.advance(at(99)));
+    EXPECT_EQ(1, timestep.advance(at(120)));
+    EXPECT_FLOAT_EQ(0.4f, timestep.getInterpolation());
+}
+
+TEST_F(FixedTimestepTest, doesNotDrift) {
+    unsigned int ticks = 0;
+    // Frames of 30 ms don't divide the tick duration.
+    for (int time = 30; time <= 3000; time += 30) {
+        ticks += timestep.advance(at(time));
+    }
+    EXPECT_EQ(60, ticks);
+}
+
+TEST_F(FixedTimestepTest, catchesUpInBoundedBursts) {
+    // A spike of 300 ms: 6 ticks are due, 4 are allowed at once.
+    EXPECT_EQ(4, timestep.advance(at(300)));
+    EXPECT_EQ(2, timestep.advance(at(310)));
+    EXPECT_EQ(0, timestep.getDroppedTicks());
+}
+
+TEST_F(FixedTimestepTest, dropsExcessiveBacklog) {
+    // 20 ticks are due, 4 run now, 4 are kept, the rest is dropped.
+    EXPECT_EQ(4, timestep.advance(at(1000)));
+    EXPECT_EQ(12, timestep.getDroppedTicks());
+    EXPECT_EQ(4, timestep.advance(at(1000)));
+    EXPECT_EQ(0, timestep.advance(at(1000)));
+    EXPECT_EQ(1, timestep.advance(at(1050)));
+}
+
+TEST_F(FixedTimestepTest, rendersAtOwnRate) {
+    EXPECT_TRUE(timestep.isRenderDue(at(0)));
+    timestep.rendered(at(0));
+    EXPECT_FALSE(timestep.isRenderDue(at(19)));
+    EXPECT_TRUE(timestep.isRenderDue(at(20)));
+    timestep.rendered(at(21));
+    EXPECT_TRUE(timestep.isRenderDue(at(40)));
+    EXPECT_EQ(0u, timestep.getSkippedRenders());
+    // Late renders are skipped, not queued.
+    timestep.rendered(at(100));
+    EXPECT_FALSE(timestep.isRenderDue(at(119)));
+    EXPECT_TRUE(timestep.isRenderDue(at(120)));
+    // The ones due at 60, 80 and 100.
+    EXPECT_EQ(3u, timestep.getSkippedRenders());
+}
+
+TEST_F(FixedTimestepTest, wakesUpForNextTickOrRender) {
+    timestep.rendered(at(0));
+    EXPECT_EQ(at(20), timestep.getNextWakeUp());
+    timestep.advance(at(45));
+    timestep.rendered(at(45));
+    EXPECT_EQ(at(50), timestep.getNextWakeUp());
+}
+
+}
+}
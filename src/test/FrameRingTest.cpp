@@ -0,0 +1,84 @@
+#include "../io/FrameRing.hpp"
+#include "../io/IoException.hpp"
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <unistd.h>
+
+namespace wotmin2d {
+namespace test {
+
+class FrameRingTest : public ::testing::Test {
+    protected:
+    FrameRingTest() :
+        name("/wotmin2d-test-" + std::to_string(getpid())) {}
+    // Writes a frame whose pixels all have the given value.
+    static void writeFrame(FrameRingWriter& writer, unsigned int width,
+                           unsigned int height, std::uint8_t value) {
+        std::uint8_t* pixels = writer.beginFrame(width, height);
+        ASSERT_NE(nullptr, pixels);
+        std::fill(pixels, pixels + width * height * 3, value);
+        writer.endFrame();
+    }
+    // Returns the pixels of the frame, or nothing if it couldn't be read.
+    static std::vector<std::uint8_t> readFrame(const FrameRingReader& reader,
+                                               std::uint64_t frame) {
+        std::vector<std::uint8_t> copy;
+        bool valid = reader.readFrame(frame,
+            [&](const std::uint8_t* pixels, unsigned int width,
+                unsigned int height) {
+                copy.assign(pixels, pixels + width * height * 3);
+            });
+        return valid ? copy : std::vector<std::uint8_t>();
+    }
+    std::string name;
+};
+
+TEST_F(FrameRingTest, readsPublishedFrames) {
+    FrameRingWriter writer(name, 4, 3);
+    FrameRingReader reader(name);
+    EXPECT_EQ(0u, reader.getLatestFrame());
+    writeFrame(writer, 4, 3, 7);
+    writeFrame(writer, 2, 2, 9);
+    ASSERT_EQ(2u, reader.getLatestFrame());
+    EXPECT_EQ(std::vector<std::uint8_t>(36, 7), readFrame(reader, 1));
+    EXPECT_EQ(std::vector<std::uint8_t>(12, 9), readFrame(reader, 2));
+}
+
+TEST_F(FrameRingTest, skipsFramesThatWereOverwritten) {
+    FrameRingWriter writer(name, 2, 2, 2);
+    FrameRingReader reader(name);
+    for (std::uint8_t value = 1; value <= 3; value++) {
+        writeFrame(writer, 2, 2, value);
+    }
+    EXPECT_TRUE(readFrame(reader, 1).empty());
+    EXPECT_EQ(std::vector<std::uint8_t>(12, 3), readFrame(reader, 3));
+    EXPECT_TRUE(readFrame(reader, 4).empty());
+}
+
+TEST_F(FrameRingTest, skipsFrameBeingWritten) {
+    FrameRingWriter writer(name, 2, 2, 1);
+    FrameRingReader reader(name);
+    writeFrame(writer, 2, 2, 1);
+    writer.beginFrame(2, 2);
+    EXPECT_TRUE(readFrame(reader, 1).empty());
+    writer.endFrame();
+    EXPECT_EQ(2u, reader.getLatestFrame());
+    EXPECT_FALSE(readFrame(reader, 2).empty());
+}
+
+TEST_F(FrameRingTest, refusesFramesLargerThanTheSlots) {
+    FrameRingWriter writer(name, 2, 2);
+    EXPECT_EQ(nullptr, writer.beginFrame(3, 2));
+    EXPECT_EQ(0u, writer.getFrameCount());
+}
+
+TEST_F(FrameRingTest, throwsIfRingDoesntExist) {
+    EXPECT_THROW(FrameRingReader reader(name), IoException);
+}
+
+}
+}
@@ -0,0 +1,64 @@
+#include "../io/FrameWriter.hpp"
+#include "../io/IoException.hpp"
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iterator>
+#include <cstdio>
+#include <cstdint>
+
+namespace wotmin2d {
+namespace test {
+
+class FrameWriterTest : public ::testing::Test {
+    protected:
+    FrameWriterTest() :
+        prefix(::testing::TempDir() + "FrameWriterTest") {}
+    ~FrameWriterTest() {
+        for (std::uint64_t frame = 0; frame < 3; frame++) {
+            std::remove(FrameWriter::framePath(prefix, frame).c_str());
+        }
+    }
+    std::string read(std::uint64_t frame) const {
+        std::ifstream stream(FrameWriter::framePath(prefix, frame),
+                             std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(stream),
+                           std::istreambuf_iterator<char>());
+    }
+    std::string prefix;
+};
+
+TEST_F(FrameWriterTest, numbersFrames) {
+    EXPECT_EQ("frames/battle000042.ppm",
+              FrameWriter::framePath("frames/battle", 42));
+}
+
+TEST_F(FrameWriterTest, writesFramesAsPpm) {
+    FrameWriter writer(prefix);
+    writer.writeFrame({ 1, 2, 3, 4, 5, 6 }, 2, 1);
+    writer.writeFrame({ 7, 8, 9 }, 1, 1);
+    writer.flush();
+    EXPECT_EQ(2u, writer.getFrameCount());
+    EXPECT_EQ(std::string("P6\n2 1\n255\n\x01\x02\x03\x04\x05\x06"), read(0));
+    EXPECT_EQ(std::string("P6\n1 1\n255\n\x07\x08\x09"), read(1));
+}
+
+TEST_F(FrameWriterTest, reusesBuffersOfWrittenFrames) {
+    FrameWriter writer(prefix);
+    EXPECT_TRUE(writer.takeBuffer().empty());
+    std::vector<std::uint8_t> pixels(300, 0);
+    writer.writeFrame(std::move(pixels), 10, 10);
+    writer.flush();
+    EXPECT_GE(writer.takeBuffer().capacity(), 300u);
+}
+
+TEST_F(FrameWriterTest, reportsErrorsOfTheBackgroundThread) {
+    FrameWriter writer(::testing::TempDir() + "missing/directory/frame");
+    writer.writeFrame({ 1, 2, 3 }, 1, 1);
+    EXPECT_THROW(writer.flush(), IoException);
+}
+
+}
+}
@@ -0,0 +1,42 @@
+#include "../LatencyStatistics.hpp"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <sstream>
+
+namespace wotmin2d {
+namespace test {
+
+using std::chrono::milliseconds;
+
+TEST(LatencyStatisticsTest, startsEmpty) {
+    LatencyStatistics statistics;
+    EXPECT_EQ(0u, statistics.getCount());
+    EXPECT_EQ(LatencyStatistics::Duration::zero(), statistics.getMean());
+    EXPECT_EQ(LatencyStatistics::Duration::zero(), statistics.getMax());
+}
+
+TEST(LatencyStatisticsTest, tracksMeanAndMax) {
+    LatencyStatistics statistics;
+    statistics.add(milliseconds(10));
+    statistics.add(milliseconds(30));
+    statistics.add(milliseconds(20));
+    EXPECT_EQ(3u, statistics.getCount());
+    EXPECT_EQ(milliseconds(20), statistics.getMean());
+    EXPECT_EQ(milliseconds(30), statistics.getMax());
+    std::ostringstream stream;
+    stream << statistics;
+    EXPECT_EQ("3 samples, mean 20 ms, max 30 ms", stream.str());
+}
+
+TEST(LatencyStatisticsTest, clampsNegativeLatencies) {
+    LatencyStatistics statistics;
+    statistics.add(milliseconds(-5));
+    statistics.add(milliseconds(10));
+    EXPECT_EQ(milliseconds(5), statistics.getMean());
+    statistics.clear();
+    EXPECT_EQ(0u, statistics.getCount());
+}
+
+}
+}
@@ -0,0 +1,72 @@
+#include "../game/NodePool.hpp"
+#include "../game/Vector.hpp"
+
+#include <gtest/gtest.h>
+#include <unordered_map>
+#include <functional>
+#include <utility>
+#include <cstdint>
+
+namespace wotmin2d {
+namespace test {
+
+TEST(NodePoolTest, reusesFreedNodes) {
+    NodePool pool;
+    void* first = pool.allocate(24);
+    pool.deallocate(first, 24);
+    void* second = pool.allocate(24);
+    EXPECT_EQ(first, second);
+    pool.deallocate(second, 24);
+}
+
+TEST(NodePoolTest, keepsNodesOfDifferentSizesApart) {
+    NodePool pool;
+    void* small = pool.allocate(16);
+    pool.deallocate(small, 16);
+    void* large = pool.allocate(48);
+    EXPECT_NE(small, large);
+    EXPECT_EQ(small, pool.allocate(16));
+}
+
+TEST(NodePoolTest, alignsNodes) {
+    NodePool pool;
+    for (int i = 0; i < 10; i++) {
+        void* node = pool.allocate(sizeof(std::uint64_t));
+        EXPECT_EQ(0, reinterpret_cast<std::uintptr_t>(node)
+                     % alignof(std::uint64_t));
+    }
+}
+
+TEST(NodePoolTest, takesOnlySingleObjectsFromPool) {
+    NodePool pool;
+    NodeAllocator<std::uint64_t> allocator(pool);
+    std::uint64_t* array = allocator.allocate(4);
+    EXPECT_EQ(0, pool.getCapacity());
+    allocator.deallocate(array, 4);
+    std::uint64_t* single = allocator.allocate(1);
+    EXPECT_LT(0, pool.getCapacity());
+    allocator.deallocate(single, 1);
+}
+
+TEST(NodePoolTest, reusesNodesOfRefilledContainer) {
+    using Map = std::unordered_map<
+        IntVector, int, IntVector::Hash, std::equal_to<IntVector>,
+        NodeAllocator<std::pair<const IntVector, int>>
+    >;
+    NodePool pool;
+    Map map(0, IntVector::Hash(), std::equal_to<IntVector>(),
+            Map::allocator_type(pool));
+    for (int i = 0; i < 1000; i++) {
+        map.emplace(IntVector(i, 0), i);
+    }
+    std::size_t capacity = pool.getCapacity();
+    map.clear();
+    for (int i = 0; i < 1000; i++) {
+        map.emplace(IntVector(0, i), i);
+    }
+    EXPECT_EQ(capacity, pool.getCapacity());
+    EXPECT_EQ(1000, map.size());
+}
+
+}
+}
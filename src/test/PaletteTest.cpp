@@ -0,0 +1,37 @@
+#include "../display/Palette.hpp"
+
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <cstdint>
+#include <set>
+
+namespace wotmin2d {
+namespace test {
+
+TEST(PaletteTest, keepsColorsOfFirstPlayers) {
+    Palette palette;
+    EXPECT_EQ(Palette::background, palette.getColor(0));
+    EXPECT_EQ((Palette::Color{ 0x00, 0x00, 0xff }), palette.getColor(1));
+    EXPECT_EQ((Palette::Color{ 0xff, 0x00, 0x00 }), palette.getColor(2));
+}
+
+TEST(PaletteTest, givesPlayersDistinctColors) {
+    Palette palette;
+    std::set<Palette::Color> colors;
+    for (std::size_t i = 0; i < 32; i++) {
+        colors.insert(palette.getColor(static_cast<std::uint8_t>(i)));
+    }
+    EXPECT_EQ(32u, colors.size());
+    EXPECT_EQ(0u, colors.count(Palette::Color{ 0x00, 0x00, 0x00 }));
+}
+
+TEST(PaletteTest, blendsLinearly) {
+    Palette::Color from = { 0, 100, 200 };
+    Palette::Color to = { 200, 100, 0 };
+    EXPECT_EQ(from, Palette::blend(from, to, 0.0f));
+    EXPECT_EQ((Palette::Color{ 100, 100, 100 }),
+              Palette::blend(from, to, 0.5f));
+}
+
+}
+}
@@ -0,0 +1,59 @@
+#include "../game/ParticlePool.hpp"
+#include "../game/Particle.hpp"
+#include "../game/Vector.hpp"
+
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace wotmin2d {
+namespace test {
+
+TEST(ParticlePoolTest, createsParticles) {
+    ParticlePool<Particle> pool;
+    Particle* particle = pool.create(IntVector(3, 4));
+    EXPECT_EQ(IntVector(3, 4), particle->getPosition());
+    pool.destroy(particle);
+}
+
+TEST(ParticlePoolTest, reusesSlotsOfDestroyedParticles) {
+    ParticlePool<Particle> pool;
+    Particle* first = pool.create(IntVector(0, 0));
+    pool.destroy(first);
+    Particle* second = pool.create(IntVector(1, 1));
+    EXPECT_EQ(first, second);
+    pool.destroy(second);
+}
+
+TEST(ParticlePoolTest, createsReservedParticlesContiguously) {
+    ParticlePool<Particle> pool;
+    pool.reserve(1000);
+    std::size_t capacity = pool.getCapacity();
+    EXPECT_GE(capacity, 1000);
+    std::vector<Particle*> particles;
+    for (int i = 0; i < 1000; i++) {
+        particles.push_back(pool.create(IntVector(i, 0)));
+    }
+    EXPECT_EQ(capacity, pool.getCapacity());
+    for (std::size_t i = 1; i < particles.size(); i++) {
+        EXPECT_EQ(particles[i - 1] + 1, particles[i]);
+    }
+    for (Particle* particle: particles) {
+        pool.destroy(particle);
+    }
+}
+
+TEST(ParticlePoolTest, growsWhenFull) {
+    ParticlePool<Particle> pool;
+    std::vector<Particle*> particles;
+    for (int i = 0; i < 2000; i++) {
+        particles.push_back(pool.create(IntVector(i, 0)));
+    }
+    EXPECT_GE(pool.getCapacity(), 2000);
+    EXPECT_GE(pool.getMemoryUsage(), 2000 * sizeof(Particle));
+    for (Particle* particle: particles) {
+        pool.destroy(particle);
+    }
+}
+
+}
+}
@@ -38,9 +38,17 @@ class ParticleTest : public ::testing::Test {
     void callKillPressure(Particle& particle, Direction direction) {
         particle.killPressureInDirection({}, direction);
     }
-    void callDamage(Particle& particle, unsigned int amount) {
+    template<class P>
+    void callDamage(P& particle, unsigned int amount) {
         particle.damage({}, amount);
     }
+    void callUpdateMobility(Particle& particle) {
+        particle.updateMobility({});
+    }
+};
+
+struct FragileConfig : Config {
+    constexpr static unsigned int particle_health = 7;
 };
 
 TEST_F(ParticleTest, hasNeighbors) {
@@ -149,6 +157,17 @@ TEST_F(ParticleTest, wantsToMoveAfterAdvancing) {
     EXPECT_GT(p.getPressure().dot(FloatVector(1.0f, 0.0f)), 0.0f);
 }
 
+TEST_F(ParticleTest, cachesMobilityUntilUpdated) {
+    Particle p(start_position);
+    EXPECT_EQ(-1.0f, p.getMobility());
+    p.setTarget(start_position + IntVector(5, 0), 1.0f);
+    callAdvance(p, one_second);
+    ASSERT_TRUE(p.canMove());
+    EXPECT_EQ(-1.0f, p.getMobility());
+    callUpdateMobility(p);
+    EXPECT_FLOAT_EQ(p.getPressure().squaredNorm(), p.getMobility());
+}
+
 TEST_F(ParticleTest, canChangeDirection) {
     Particle p(start_position);
     p.setTarget(start_position + IntVector(5, 0), 1.0f);
@@ -429,5 +448,15 @@ TEST_F(ParticleTest, takesNoMoreDamageOnceHealthReachesZero) {
     EXPECT_EQ(0, p.getHealth());
 }
 
+TEST_F(ParticleTest, usesConfigPolicy) {
+    const unsigned int health = Config::particle_health;
+    BasicParticle<FragileConfig> fragile(td.inside);
+    Particle p(td.inside);
+    EXPECT_EQ(7, fragile.getHealth());
+    EXPECT_EQ(health, p.getHealth());
+    callDamage(fragile, 5);
+    EXPECT_EQ(2, fragile.getHealth());
+}
+
 }
 }
@@ -0,0 +1,52 @@
+#include "../display/PerformanceSnapshot.hpp"
+#include "../game/State.hpp"
+#include "../game/Vector.hpp"
+#include "../io/Scenario.hpp"
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstddef>
+
+namespace wotmin2d {
+namespace test {
+
+TEST(PerformanceSnapshotTest, countsParticlesByPlayerId) {
+    State<> state(40, 30);
+    Scenario scenario(40, 30);
+    scenario.addCircle(3, IntVector(30, 20), 2.0f);
+    scenario.addCircle(1, IntVector(10, 10), 4.0f);
+    scenario.populate(state);
+    PerformanceSnapshot performance;
+    performance.countParticles(state);
+    ASSERT_EQ(2u, performance.player_count);
+    EXPECT_EQ(1u, performance.players[0]);
+    EXPECT_EQ(3u, performance.players[1]);
+    EXPECT_EQ(state.getBlobs().at(1).getParticles().size(),
+              performance.particles[0]);
+    EXPECT_EQ(state.getBlobs().at(3).getParticles().size(),
+              performance.particles[1]);
+}
+
+TEST(PerformanceSnapshotTest, keepsPlayersWithLowestIds) {
+    State<> state(100, 10);
+    Scenario scenario(100, 10);
+    std::size_t players = PerformanceSnapshot::max_players + 2;
+    for (std::size_t i = 0; i < players; i++) {
+        // From the highest id down, so that every player is inserted first.
+        std::uint8_t player = static_cast<std::uint8_t>(players - 1 - i);
+        scenario.addCircle(player,
+                           IntVector(5 + 9 * static_cast<int>(player), 5),
+                           1.0f);
+    }
+    scenario.populate(state);
+    PerformanceSnapshot performance;
+    performance.countParticles(state);
+    ASSERT_EQ(PerformanceSnapshot::max_players, performance.player_count);
+    for (std::size_t i = 0; i < PerformanceSnapshot::max_players; i++) {
+        EXPECT_EQ(i, performance.players[i]);
+        EXPECT_LT(0u, performance.particles[i]);
+    }
+}
+
+}
+}
@@ -0,0 +1,326 @@
+#include "../display/RenderSnapshot.hpp"
+#include "../display/Viewport.hpp"
+#include "../game/State.hpp"
+#include "../game/Vector.hpp"
+#include "../io/Scenario.hpp"
+#include "../WorkerPool.hpp"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+namespace wotmin2d {
+namespace test {
+
+class RenderSnapshotTest : public ::testing::Test {
+    protected:
+    RenderSnapshotTest() :
+        state(40, 30),
+        viewport(40, 30, 40, 30),
+        snapshot(),
+        history() {
+        Scenario scenario(40, 30);
+        scenario.addCircle(0, IntVector(10, 10), 4.0f);
+        scenario.addCircle(1, IntVector(30, 20), 4.0f);
+        scenario.setTarget(0, IntVector(35, 25), 30.0f);
+        scenario.populate(state);
+    }
+    void capture(std::uint64_t tick) {
+        snapshot.capture(state, viewport, tick, RenderSnapshot::Clock::now(),
+                         history);
+    }
+    State<> state;
+    Viewport viewport;
+    RenderSnapshot snapshot;
+    RenderSnapshot::History history;
+};
+
+TEST_F(RenderSnapshotTest, storesOwnerOfEachCell) {
+    capture(0);
+    ASSERT_EQ(40u, snapshot.getWidth());
+    ASSERT_EQ(30u, snapshot.getHeight());
+    std::size_t occupied = 0;
+    for (unsigned int y = 0; y < 30; y++) {
+        for (unsigned int x = 0; x < 40; x++) {
+            IntVector position(x, y);
+            std::uint8_t cell = snapshot.getSample(x, y);
+            if (state.getBlobs().at(0).getParticleAt(position) != nullptr) {
+                EXPECT_EQ(1, cell);
+            } else if (state.getBlobs().at(1).getParticleAt(position)
+                       != nullptr) {
+                EXPECT_EQ(2, cell);
+            } else {
+                EXPECT_EQ(RenderSnapshot::empty, cell);
+            }
+            if (cell != RenderSnapshot::empty) {
+                occupied++;
+            }
+        }
+    }
+    EXPECT_EQ(state.getBlobs().at(0).getParticles().size()
+              + state.getBlobs().at(1).getParticles().size(), occupied);
+    EXPECT_FLOAT_EQ(state.getSelectionRadius(),
+                    snapshot.getSelectionRadius());
+}
+
+TEST_F(RenderSnapshotTest, capturesOnlyVisibleCells) {
+    // Zoomed in twice, the 20 by 15 cells at the bottom left are visible,
+    // each as a sample of 4 by 4 pixels.
+    viewport = Viewport(40, 30, 80, 60);
+    viewport.pan(IntVector(-8, -8));
+    ASSERT_EQ(1, viewport.getZoom());
+    ASSERT_EQ(IntVector(0, 0), viewport.getOrigin());
+    viewport.zoom(1, IntVector(0, 59));
+    capture(0);
+    ASSERT_EQ(IntVector(0, 0), viewport.getOrigin());
+    ASSERT_EQ(20u, snapshot.getWidth());
+    ASSERT_EQ(15u, snapshot.getHeight());
+    for (unsigned int y = 0; y < 15; y++) {
+        for (unsigned int x = 0; x < 20; x++) {
+            IntVector cell(x, y);
+            std::uint8_t expected = RenderSnapshot::empty;
+            if (state.getBlobs().at(0).getParticleAt(cell) != nullptr) {
+                expected = 1;
+            }
+            EXPECT_EQ(expected, snapshot.getSample(x, y));
+        }
+    }
+}
+
+// Fewer visible cells than particles, so cells are looked up one by one.
+TEST_F(RenderSnapshotTest, looksUpCellsWhenZoomedFarIn) {
+    viewport = Viewport(40, 30, 80, 60);
+    viewport.zoom(Viewport::max_zoom, IntVector(20, 40));
+    capture(0);
+    ASSERT_LT(snapshot.getWidth() * snapshot.getHeight(),
+              state.getBlobs().at(0).getParticles().size());
+    for (unsigned int y = 0; y < snapshot.getHeight(); y++) {
+        for (unsigned int x = 0; x < snapshot.getWidth(); x++) {
+            IntVector cell = viewport.getOrigin() + IntVector(x, y);
+            bool occupied
+                = state.getBlobs().at(0).getParticleAt(cell) != nullptr;
+            EXPECT_EQ(occupied ? 1 : RenderSnapshot::empty,
+                      snapshot.getSample(x, y));
+        }
+    }
+}
+
+TEST_F(RenderSnapshotTest, samplesSeveralCellsWhenZoomedOut) {
+    viewport = Viewport(40, 30, 10, 10);
+    ASSERT_EQ(-2, viewport.getZoom());
+    capture(0);
+    ASSERT_EQ(10u, snapshot.getWidth());
+    // The blob around (10, 10) covers the sample of cells (8..11, 8..11),
+    // which starts at the origin of the centered arena.
+    IntVector offset = IntVector(8, 8) - viewport.getOrigin();
+    EXPECT_EQ(1, snapshot.getSample(offset.getX() / 4, offset.getY() / 4));
+}
+
+TEST_F(RenderSnapshotTest, shadesDensitiesWhenZoomedOut) {
+    state.setDensityTracking(true);
+    viewport = Viewport(40, 30, 10, 10);
+    capture(0);
+    ASSERT_TRUE(snapshot.isShaded());
+    // Count the particles of each player in each sample like the pyramid.
+    std::vector<std::uint32_t> counts[2];
+    for (std::uint8_t player = 0; player < 2; player++) {
+        counts[player].assign(100, 0);
+        for (const auto* particle: state.getBlobs().at(player).getParticles()) {
+            IntVector offset = particle->getPosition() - viewport.getOrigin();
+            counts[player][(offset.getY() / 4) * 10 + offset.getX() / 4]++;
+        }
+    }
+    for (unsigned int y = 0; y < 10; y++) {
+        for (unsigned int x = 0; x < 10; x++) {
+            std::uint32_t first = counts[0][y * 10 + x];
+            std::uint32_t second = counts[1][y * 10 + x];
+            if (first == 0 && second == 0) {
+                EXPECT_EQ(RenderSnapshot::empty, snapshot.getSample(x, y));
+                continue;
+            }
+            std::uint32_t count = std::max(first, second);
+            EXPECT_EQ(first >= second ? 1 : 2, snapshot.getSample(x, y));
+            // The samples with particles cover 16 cells of the arena.
+            EXPECT_EQ((count * RenderSnapshot::shade_levels - 1) / 16,
+                      snapshot.getShade(x, y));
+        }
+    }
+}
+
+TEST_F(RenderSnapshotTest, isOnlyShadedWhenTrackingDensity) {
+    viewport = Viewport(40, 30, 10, 10);
+    capture(0);
+    EXPECT_FALSE(snapshot.isShaded());
+    state.setDensityTracking(true);
+    viewport = Viewport(40, 30, 40, 30);
+    capture(1);
+    EXPECT_FALSE(snapshot.isShaded());
+}
+
+TEST_F(RenderSnapshotTest, capturesSameWithAnyNumberOfThreads) {
+    State<> large_state(300, 200);
+    Scenario scenario(300, 200);
+    scenario.addCircle(0, IntVector(60, 50), 40.0f);
+    scenario.addCircle(1, IntVector(200, 140), 50.0f);
+    scenario.addCircle(2, IntVector(250, 40), 3.0f);
+    scenario.populate(large_state);
+    // The same pool runs the bands of every capture.
+    WorkerPool workers(4);
+    auto compare = [&](const Viewport& view) {
+        RenderSnapshot::History single_history;
+        RenderSnapshot::History banded_history;
+        RenderSnapshot single;
+        RenderSnapshot banded;
+        RenderSnapshot::Clock::time_point now = RenderSnapshot::Clock::now();
+        single.capture(large_state, view, 0, now, single_history);
+        banded.capture(large_state, view, 0, now, banded_history, &workers);
+        EXPECT_EQ(single.getSamples(), banded.getSamples());
+        EXPECT_EQ(single.getShades(), banded.getShades());
+    };
+    // Going through the particles.
+    Viewport view(300, 200, 300, 200);
+    compare(view);
+    // Zoomed in, cells are looked up for the large blobs.
+    view.zoom(2, IntVector(100, 100));
+    compare(view);
+    // Several cells per sample.
+    compare(Viewport(300, 200, 150, 100));
+    // Going through the particles, with the blobs overlapping in samples.
+    large_state.emplaceBlob(3, IntVector(100, 70), 15.0f);
+    compare(Viewport(300, 200, 75, 50));
+    large_state.setDensityTracking(true);
+    compare(Viewport(300, 200, 150, 100));
+}
+
+TEST_F(RenderSnapshotTest, firstCaptureHasNoMovement) {
+    capture(0);
+    EXPECT_EQ(snapshot.getSamples(), snapshot.getPreviousSamples());
+}
+
+TEST_F(RenderSnapshotTest, keepsCellsOfPreviousCapture) {
+    capture(0);
+    std::vector<std::uint8_t> before = snapshot.getSamples();
+    state.advance(std::chrono::milliseconds(50));
+    // A different snapshot, as when going through a triple buffer.
+    RenderSnapshot next;
+    next.capture(state, viewport, 1, RenderSnapshot::Clock::now(), history);
+    EXPECT_EQ(1u, next.getTick());
+    EXPECT_EQ(snapshot.getSequence() + 1, next.getSequence());
+    EXPECT_EQ(before, next.getPreviousSamples());
+    EXPECT_NE(before, next.getSamples());
+    EXPECT_EQ(next.getSamples(), history.samples);
+}
+
+TEST_F(RenderSnapshotTest, marksTilesWithChangedCells) {
+    capture(0);
+    // 40 by 30 cells are 2 by 1 tiles.
+    ASSERT_EQ(2u, snapshot.getTileColumns());
+    ASSERT_EQ(1u, snapshot.getTileRows());
+    EXPECT_TRUE(snapshot.isTileDirty(0, 0));
+    EXPECT_TRUE(snapshot.isTileDirty(1, 0));
+    capture(0);
+    EXPECT_FALSE(snapshot.isTileDirty(0, 0));
+    EXPECT_FALSE(snapshot.isTileDirty(1, 0));
+    // Only the blob on the left moves.
+    state.advance(std::chrono::milliseconds(50));
+    capture(1);
+    bool left_changed = false;
+    bool right_changed = false;
+    for (unsigned int y = 0; y < 30; y++) {
+        for (unsigned int x = 0; x < 40; x++) {
+            if (snapshot.getSample(x, y) != snapshot.getPreviousSample(x, y)) {
+                (x < RenderSnapshot::tile_size ? left_changed : right_changed)
+                    = true;
+            }
+        }
+    }
+    EXPECT_EQ(left_changed, snapshot.isTileDirty(0, 0));
+    EXPECT_EQ(right_changed, snapshot.isTileDirty(1, 0));
+    EXPECT_TRUE(left_changed);
+}
+
+TEST_F(RenderSnapshotTest, fillsChangedTilesLikeFullCapture) {
+    State<> large_state(300, 200);
+    Scenario scenario(300, 200);
+    scenario.addCircle(0, IntVector(100, 100), 30.0f);
+    scenario.addCircle(1, IntVector(170, 100), 30.0f);
+    scenario.setTarget(0, IntVector(250, 100), 30.0f);
+    scenario.setTarget(1, IntVector(20, 100), 30.0f);
+    scenario.populate(large_state);
+    large_state.setChangeLogging(true);
+    large_state.setDensityTracking(true);
+    auto follow = [&](const Viewport& view) {
+        RenderSnapshot::History updated_history;
+        RenderSnapshot updated;
+        RenderSnapshot::Clock::time_point now = RenderSnapshot::Clock::now();
+        std::uint64_t tick = 0;
+        updated.capture(large_state, view, tick, now, updated_history);
+        for (int i = 0; i < 10; i++) {
+            large_state.advance(std::chrono::milliseconds(50));
+            tick++;
+            // Without the sizes of the blobs, the history can't be updated
+            // and everything is filled again.
+            RenderSnapshot::History full_history = updated_history;
+            full_history.blob_sizes.clear();
+            RenderSnapshot full;
+            full.capture(large_state, view, tick, now, full_history);
+            updated.capture(large_state, view, tick, now, updated_history);
+            ASSERT_EQ(full.getSamples(), updated.getSamples()) << i;
+            ASSERT_EQ(full.getShades(), updated.getShades()) << i;
+            ASSERT_EQ(full.getPreviousSamples(),
+                      updated.getPreviousSamples()) << i;
+            for (unsigned int row = 0; row < full.getTileRows(); row++) {
+                for (unsigned int column = 0; column < full.getTileColumns();
+                     column++) {
+                    EXPECT_EQ(full.isTileDirty(column, row),
+                              updated.isTileDirty(column, row));
+                }
+            }
+        }
+    };
+    Viewport view(300, 200, 300, 200);
+    follow(view);
+    view.zoom(2, IntVector(135, 100));
+    follow(view);
+    // Shaded from the density pyramids.
+    follow(Viewport(300, 200, 150, 100));
+}
+
+TEST_F(RenderSnapshotTest, fillsEverythingWhenChangesArentLogged) {
+    capture(0);
+    state.advance(std::chrono::milliseconds(50));
+    // Without a log of the move, nothing would be filled again.
+    capture(1);
+    EXPECT_TRUE(snapshot.isTileDirty(0, 0));
+    RenderSnapshot::History fresh_history;
+    RenderSnapshot full;
+    full.capture(state, viewport, 1, RenderSnapshot::Clock::now(),
+                 fresh_history);
+    EXPECT_EQ(full.getSamples(), snapshot.getSamples());
+}
+
+TEST_F(RenderSnapshotTest, fillsEverythingAfterRestore) {
+    state.setChangeLogging(true);
+    StateSnapshot earlier;
+    state.snapshot(earlier);
+    for (int i = 0; i < 3; i++) {
+        state.advance(std::chrono::milliseconds(50));
+    }
+    capture(0);
+    // Rewinding keeps the sizes of the blobs, but none of the moves back are
+    // logged.
+    state.restore(earlier);
+    capture(1);
+    EXPECT_TRUE(snapshot.isTileDirty(0, 0));
+    EXPECT_NE(snapshot.getPreviousSamples(), snapshot.getSamples());
+    RenderSnapshot::History fresh_history;
+    RenderSnapshot full;
+    full.capture(state, viewport, 1, RenderSnapshot::Clock::now(),
+                 fresh_history);
+    EXPECT_EQ(full.getSamples(), snapshot.getSamples());
+}
+
+}
+}
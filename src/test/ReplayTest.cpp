@@ -0,0 +1,212 @@
+#include "../Replay.hpp"
+#include "../io/Recording.hpp"
+#include "../io/Scenario.hpp"
+#include "../game/State.hpp"
+#include "../game/Snapshot.hpp"
+#include "../game/Command.hpp"
+#include "../game/Vector.hpp"
+
+#include <gtest/gtest.h>
+#include <string>
+#include <fstream>
+#include <iterator>
+#include <cstdio>
+#include <chrono>
+
+namespace wotmin2d {
+namespace test {
+
+class ReplayTest : public ::testing::Test {
+    protected:
+    ReplayTest() :
+        path(::testing::TempDir() + "ReplayTest.recording"),
+        scenario(80, 80),
+        tick_duration(50) {
+        scenario.addCircle(0, IntVector(20, 20), 9.0f);
+        scenario.addCircle(1, IntVector(55, 55), 9.0f);
+        scenario.setTarget(1, IntVector(20, 20), 20.0f);
+    }
+    ~ReplayTest() {
+        std::remove(path.c_str());
+    }
+    // Runs the scenario for the given number of ticks, executing commands at
+    // ticks 0, 10 and 25 and recording them if there's a writer, with a
+    // keyframe every keyframe_interval ticks.
+    StateSnapshot play(std::uint64_t tick_count, RecordingWriter* writer,
+                       std::uint64_t keyframe_interval = 0) {
+        State<> state(scenario.getArenaWidth(), scenario.getArenaHeight());
+        scenario.populate(state);
+        for (std::uint64_t tick = 0; ; tick++) {
+            if (writer != nullptr && keyframe_interval > 0 && tick > 0
+                && tick % keyframe_interval == 0) {
+                StateSnapshot keyframe;
+                state.snapshot(keyframe);
+                writer->writeKeyframe(tick, keyframe);
+            }
+            for (const Command& command: commandsAt(tick)) {
+                state.execute(command);
+                if (writer != nullptr) {
+                    writer->write(tick, command);
+                }
+            }
+            if (tick == tick_count) {
+                break;
+            }
+            state.advance(tick_duration);
+        }
+        if (writer != nullptr) {
+            writer->finish(tick_count);
+        }
+        StateSnapshot snapshot;
+        state.snapshot(snapshot);
+        return snapshot;
+    }
+    std::vector<Command> commandsAt(std::uint64_t tick) {
+        switch (tick) {
+        case 0:
+            return { Command::selectParticles(IntVector(20, 20)),
+                     Command::changeSelectionRadius(4.0f),
+                     Command::setTarget(0, IntVector(60, 60)) };
+        case 10:
+            return { Command::setTarget(0, IntVector(70, 10)) };
+        case 25:
+            return { Command::selectParticles(IntVector(50, 50)),
+                     Command::setTarget(1, IntVector(5, 75)) };
+        default:
+            return {};
+        }
+    }
+    void truncate(std::size_t count) {
+        std::string contents;
+        {
+            std::ifstream stream(path, std::ios::binary);
+            contents.assign(std::istreambuf_iterator<char>(stream),
+                            std::istreambuf_iterator<char>());
+        }
+        std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+        stream << contents.substr(0, contents.size() - count);
+    }
+    std::string path;
+    Scenario scenario;
+    std::chrono::milliseconds tick_duration;
+};
+
+TEST_F(ReplayTest, recordsCommands) {
+    {
+        RecordingWriter writer(path, scenario, tick_duration);
+        play(40, &writer);
+    }
+    Recording recording = Recording::load(path);
+    EXPECT_TRUE(recording.isComplete());
+    EXPECT_EQ(40, recording.getTickCount());
+    EXPECT_EQ(tick_duration, recording.getTickDuration());
+    EXPECT_EQ(2, recording.getScenario().getBlobs().size());
+    ASSERT_EQ(6, recording.getEvents().size());
+    EXPECT_EQ(0, recording.getEvents()[2].first);
+    EXPECT_EQ(Command::setTarget(0, IntVector(60, 60)),
+              recording.getEvents()[2].second);
+    EXPECT_EQ(10, recording.getEvents()[3].first);
+    EXPECT_EQ(25, recording.getEvents()[5].first);
+    EXPECT_EQ(Command::setTarget(1, IntVector(5, 75)),
+              recording.getEvents()[5].second);
+}
+
+TEST_F(ReplayTest, loadsIncompleteRecordings) {
+    {
+        RecordingWriter writer(path, scenario, tick_duration);
+        play(40, &writer);
+    }
+    // Cut off the index (one u64 for zero keyframes and a 24 byte trailer),
+    // the end marker and half of the last command.
+    truncate(8 + 24 + 24 + 12);
+    Recording recording = Recording::load(path);
+    EXPECT_FALSE(recording.isComplete());
+    EXPECT_EQ(5, recording.getEvents().size());
+    EXPECT_EQ(25, recording.getTickCount());
+}
+
+TEST_F(ReplayTest, reproducesBattle) {
+    StateSnapshot expected;
+    {
+        RecordingWriter writer(path, scenario, tick_duration);
+        expected = play(40, &writer);
+    }
+    Recording recording = Recording::load(path);
+    Replay replay(recording);
+    replay.run();
+    EXPECT_TRUE(replay.isFinished());
+    EXPECT_EQ(40, replay.getTick());
+    StateSnapshot replayed;
+    replay.getState().snapshot(replayed);
+    EXPECT_EQ(expected, replayed);
+}
+
+TEST_F(ReplayTest, stopsAtTick) {
+    StateSnapshot expected = play(17, nullptr);
+    {
+        RecordingWriter writer(path, scenario, tick_duration);
+        play(40, &writer);
+    }
+    Recording recording = Recording::load(path);
+    Replay replay(recording);
+    replay.runUntil(17);
+    EXPECT_EQ(17, replay.getTick());
+    EXPECT_FALSE(replay.isFinished());
+    StateSnapshot replayed;
+    replay.getState().snapshot(replayed);
+    EXPECT_EQ(expected, replayed);
+}
+
+TEST_F(ReplayTest, indexesKeyframes) {
+    {
+        RecordingWriter writer(path, scenario, tick_duration);
+        play(40, &writer, 8);
+    }
+    Recording recording = Recording::load(path);
+    EXPECT_TRUE(recording.isComplete());
+    ASSERT_EQ(5, recording.getKeyframes().size());
+    EXPECT_EQ(8, recording.getKeyframes()[0].first);
+    EXPECT_EQ(40, recording.getKeyframes()[4].first);
+    // Keyframes don't show up as commands.
+    EXPECT_EQ(6, recording.getEvents().size());
+    StateSnapshot keyframe;
+    recording.readKeyframe(recording.getKeyframes()[1], keyframe);
+    EXPECT_EQ(play(16, nullptr), keyframe);
+}
+
+TEST_F(ReplayTest, seeksToTick) {
+    {
+        RecordingWriter writer(path, scenario, tick_duration);
+        play(40, &writer, 8);
+    }
+    Recording recording = Recording::load(path);
+    Replay replay(recording);
+    for (std::uint64_t tick: { 30, 12, 16, 0, 5, 40 }) {
+        replay.seek(tick);
+        EXPECT_EQ(tick, replay.getTick());
+        StateSnapshot replayed;
+        replay.getState().snapshot(replayed);
+        EXPECT_EQ(play(tick, nullptr), replayed) << "at tick " << tick;
+    }
+}
+
+TEST_F(ReplayTest, findsKeyframesWithoutIndex) {
+    {
+        RecordingWriter writer(path, scenario, tick_duration);
+        play(40, &writer, 8);
+    }
+    // Cut off the index with five keyframes and the end marker.
+    truncate(8 + 5 * 16 + 24 + 24);
+    Recording recording = Recording::load(path);
+    EXPECT_FALSE(recording.isComplete());
+    ASSERT_EQ(5, recording.getKeyframes().size());
+    EXPECT_EQ(40, recording.getTickCount());
+    Replay replay(recording);
+    replay.seek(26);
+    StateSnapshot replayed;
+    replay.getState().snapshot(replayed);
+    EXPECT_EQ(play(26, nullptr), replayed);
+}
+
+}
+}
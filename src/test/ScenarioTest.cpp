@@ -0,0 +1,183 @@
+#include "../io/Scenario.hpp"
+#include "../io/IoException.hpp"
+#include "../game/State.hpp"
+#include "../game/Shape.hpp"
+#include "../game/Vector.hpp"
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdio>
+#include <chrono>
+#include <iterator>
+#include <limits>
+#include <cstdint>
+#include <cstddef>
+
+namespace wotmin2d {
+namespace test {
+
+class ScenarioTest : public ::testing::Test {
+    protected:
+    ScenarioTest() :
+        path(::testing::TempDir() + "ScenarioTest.scenario") {}
+    ~ScenarioTest() {
+        std::remove(path.c_str());
+    }
+    // Overwrites bytes of the saved file, counting from its end.
+    template<class T>
+    void patchFromEnd(std::size_t offset, T value) {
+        std::fstream stream(path, std::ios::binary | std::ios::in
+                                  | std::ios::out);
+        stream.seekp(-static_cast<std::streamoff>(offset), std::ios::end);
+        stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+    std::string path;
+};
+
+TEST_F(ScenarioTest, savesAndLoadsArena) {
+    Scenario scenario(123, 45);
+    scenario.save(path);
+    Scenario loaded = Scenario::load(path);
+    EXPECT_EQ(123, loaded.getArenaWidth());
+    EXPECT_EQ(45, loaded.getArenaHeight());
+    EXPECT_TRUE(loaded.getBlobs().empty());
+}
+
+TEST_F(ScenarioTest, savesAndLoadsBlobs) {
+    Scenario scenario(50, 50);
+    scenario.addCircle(0, IntVector(10, 10), 4.5f);
+    scenario.addRectangle(3, IntVector(30, 30), 5, 7);
+    std::vector<bool> mask = { true, false, true, false, true,
+                               false, true, false, true, false,
+                               true, true, true, true, true };
+    Shape bitmap = Shape::fromMask(IntVector(1, 40), 5, 3, mask);
+    scenario.addShape(7, bitmap);
+    scenario.setTarget(3, IntVector(0, 1), 12.5f);
+    scenario.save(path);
+    Scenario loaded = Scenario::load(path);
+    ASSERT_EQ(3, loaded.getBlobs().size());
+    const Scenario::BlobSetup& circle = loaded.getBlobs()[0];
+    EXPECT_EQ(0, circle.getPlayerId());
+    EXPECT_EQ(Scenario::BlobSetup::Kind::circle, circle.getKind());
+    EXPECT_EQ(Shape::circle(IntVector(10, 10), 4.5f), circle.getShape());
+    EXPECT_FALSE(circle.hasTarget());
+    const Scenario::BlobSetup& rectangle = loaded.getBlobs()[1];
+    EXPECT_EQ(3, rectangle.getPlayerId());
+    EXPECT_EQ(Shape::rectangle(IntVector(30, 30), 5, 7),
+              rectangle.getShape());
+    EXPECT_TRUE(rectangle.hasTarget());
+    EXPECT_EQ(IntVector(0, 1), rectangle.getTarget());
+    EXPECT_EQ(12.5f, rectangle.getTargetPressure());
+    const Scenario::BlobSetup& shape = loaded.getBlobs()[2];
+    EXPECT_EQ(7, shape.getPlayerId());
+    EXPECT_EQ(bitmap, shape.getShape());
+}
+
+TEST_F(ScenarioTest, rejectsOtherFiles) {
+    {
+        std::ofstream stream(path);
+        stream << "definitely not a scenario";
+    }
+    EXPECT_THROW(Scenario::load(path), IoException);
+}
+
+TEST_F(ScenarioTest, rejectsTruncatedFiles) {
+    Scenario scenario(50, 50);
+    scenario.addCircle(0, IntVector(10, 10), 4.5f);
+    scenario.save(path);
+    std::string contents;
+    {
+        std::ifstream stream(path, std::ios::binary);
+        contents.assign(std::istreambuf_iterator<char>(stream),
+                        std::istreambuf_iterator<char>());
+    }
+    {
+        std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+        stream.write(contents.data(), contents.size() - 3);
+    }
+    EXPECT_THROW(Scenario::load(path), IoException);
+}
+
+TEST_F(ScenarioTest, rejectsMultipleBlobsForOnePlayer) {
+    Scenario scenario(50, 50);
+    scenario.addCircle(0, IntVector(10, 10), 4.5f);
+    EXPECT_THROW(scenario.addRectangle(0, IntVector(30, 30), 2, 2),
+                 IoException);
+}
+
+TEST_F(ScenarioTest, rejectsNonFiniteRadius) {
+    Scenario scenario(50, 50);
+    EXPECT_THROW(scenario.addCircle(0, IntVector(10, 10),
+                                    std::numeric_limits<float>::quiet_NaN()),
+                 IoException);
+    EXPECT_THROW(scenario.addCircle(0, IntVector(10, 10),
+                                    std::numeric_limits<float>::infinity()),
+                 IoException);
+    scenario.addCircle(0, IntVector(10, 10), 4.5f);
+    scenario.save(path);
+    // The radius is the last field of a circle.
+    patchFromEnd(4, std::numeric_limits<float>::quiet_NaN());
+    EXPECT_THROW(Scenario::load(path), IoException);
+}
+
+TEST_F(ScenarioTest, rejectsBlobsLargerThanArena) {
+    Scenario scenario(50, 40);
+    EXPECT_THROW(scenario.addCircle(0, IntVector(10, 10), 51.0f),
+                 IoException);
+    EXPECT_THROW(scenario.addRectangle(0, IntVector(0, 0), 10, 41),
+                 IoException);
+    EXPECT_THROW(scenario.addShape(0, Shape::rectangle(IntVector(0, 0), 51,
+                                                       1)),
+                 IoException);
+    // Sticking out of the arena is fine, the blob is clipped.
+    scenario.addRectangle(0, IntVector(45, 35), 50, 40);
+    scenario.save(path);
+    // Width and height are the last fields of a rectangle.
+    patchFromEnd(8, std::numeric_limits<std::uint32_t>::max());
+    EXPECT_THROW(Scenario::load(path), IoException);
+}
+
+TEST_F(ScenarioTest, rejectsOverlappingBlobs) {
+    Scenario scenario(50, 50);
+    scenario.addCircle(0, IntVector(10, 10), 4.5f);
+    EXPECT_THROW(scenario.addRectangle(1, IntVector(14, 10), 3, 3),
+                 IoException);
+    // Touching isn't overlapping.
+    scenario.addRectangle(1, IntVector(15, 10), 3, 3);
+    EXPECT_EQ(2, scenario.getBlobs().size());
+}
+
+TEST_F(ScenarioTest, rejectsPlayersWithoutOwnerValue) {
+    Scenario scenario(50, 50);
+    // One more would wrap to the owner value of empty cells.
+    scenario.addCircle(254, IntVector(10, 10), 4.5f);
+    EXPECT_THROW(scenario.addCircle(255, IntVector(30, 30), 4.5f),
+                 IoException);
+}
+
+TEST_F(ScenarioTest, populatesState) {
+    Scenario scenario(50, 50);
+    scenario.addCircle(0, IntVector(10, 10), 3.0f);
+    scenario.addRectangle(1, IntVector(45, 45), 10, 10);
+    scenario.setTarget(1, IntVector(0, 0), 5.0f);
+    State<> state(50, 50);
+    scenario.populate(state);
+    ASSERT_EQ(2, state.getBlobs().size());
+    EXPECT_EQ(Shape::circle(IntVector(10, 10), 3.0f).count(),
+              state.getBlobs().at(0).getParticles().size());
+    EXPECT_EQ(25, state.getBlobs().at(1).getParticles().size());
+    state.advance(std::chrono::milliseconds(1000));
+    bool moved = false;
+    for (const Particle* particle: state.getBlobs().at(1).getParticles()) {
+        if (particle->getPosition().getX() < 45
+            || particle->getPosition().getY() < 45) {
+            moved = true;
+        }
+    }
+    EXPECT_TRUE(moved);
+}
+
+}
+}
@@ -0,0 +1,105 @@
+#include "../game/Shape.hpp"
+#include "../game/Vector.hpp"
+
+#include <gtest/gtest.h>
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+namespace wotmin2d {
+namespace test {
+
+TEST(ShapeTest, defaultShapeIsEmpty) {
+    Shape shape;
+    EXPECT_TRUE(shape.empty());
+    EXPECT_EQ(0, shape.count());
+    EXPECT_FALSE(shape.contains(IntVector(0, 0)));
+}
+
+TEST(ShapeTest, makesRectangles) {
+    Shape shape = Shape::rectangle(IntVector(2, 3), 10, 2);
+    EXPECT_EQ(20, shape.count());
+    EXPECT_TRUE(shape.contains(IntVector(2, 3)));
+    EXPECT_TRUE(shape.contains(IntVector(11, 4)));
+    EXPECT_FALSE(shape.contains(IntVector(1, 3)));
+    EXPECT_FALSE(shape.contains(IntVector(12, 3)));
+    EXPECT_FALSE(shape.contains(IntVector(2, 5)));
+}
+
+TEST(ShapeTest, makesCircles) {
+    IntVector center(5, 5);
+    float radius = 2.0f;
+    Shape shape = Shape::circle(center, radius);
+    for (int x = 0; x < 10; x++) {
+        for (int y = 0; y < 10; y++) {
+            IntVector position(x, y);
+            bool inside = (position - center).squaredNorm()
+                          <= radius * radius;
+            EXPECT_EQ(inside, shape.contains(position)) << position;
+        }
+    }
+    EXPECT_EQ(13, shape.count());
+}
+
+TEST(ShapeTest, makesCirclesWithZeroRadius) {
+    Shape shape = Shape::circle(IntVector(3, 4), 0.0f);
+    EXPECT_EQ(1, shape.count());
+    EXPECT_TRUE(shape.contains(IntVector(3, 4)));
+}
+
+TEST(ShapeTest, makesShapesFromMasks) {
+    std::vector<bool> mask = { true, false, false,
+                               false, true, true };
+    Shape shape = Shape::fromMask(IntVector(1, 1), 3, 2, mask);
+    EXPECT_EQ(3, shape.count());
+    EXPECT_TRUE(shape.contains(IntVector(1, 1)));
+    EXPECT_FALSE(shape.contains(IntVector(2, 1)));
+    EXPECT_TRUE(shape.contains(IntVector(2, 2)));
+    EXPECT_TRUE(shape.contains(IntVector(3, 2)));
+}
+
+TEST(ShapeTest, readsExternalBits) {
+    // Rows of a shape 10 wide take two bytes each.
+    std::shared_ptr<const std::uint8_t> bits(
+        new std::uint8_t[4] { 0x01, 0x02, 0x00, 0x00 },
+        std::default_delete<const std::uint8_t[]>());
+    Shape shape(IntVector(0, 0), 10, 2, bits);
+    EXPECT_EQ(2, shape.count());
+    EXPECT_TRUE(shape.isSet(0, 0));
+    EXPECT_TRUE(shape.isSet(9, 0));
+    EXPECT_FALSE(shape.isSet(8, 0));
+    EXPECT_FALSE(shape.isSet(0, 1));
+}
+
+TEST(ShapeTest, ignoresPaddingBitsWhenCounting) {
+    // A shape 3 wide uses the low 3 bits of each row's byte.
+    std::shared_ptr<const std::uint8_t> bits(
+        new std::uint8_t[2] { 0xff, 0xf9 },
+        std::default_delete<const std::uint8_t[]>());
+    Shape shape(IntVector(0, 0), 3, 2, bits);
+    EXPECT_EQ(4, shape.count());
+    EXPECT_FALSE(shape.empty());
+    std::shared_ptr<const std::uint8_t> padding(
+        new std::uint8_t[1] { 0xf8 },
+        std::default_delete<const std::uint8_t[]>());
+    EXPECT_TRUE(Shape(IntVector(0, 0), 3, 1, padding).empty());
+}
+
+TEST(ShapeTest, clipsToArena) {
+    Shape shape = Shape::rectangle(IntVector(-3, -1), 6, 4);
+    Shape clipped = shape.clipped(2, 10);
+    EXPECT_EQ(Shape::rectangle(IntVector(0, 0), 2, 3), clipped);
+}
+
+TEST(ShapeTest, clipsShapesEntirelyOutsideToEmpty) {
+    Shape shape = Shape::circle(IntVector(30, 30), 2.0f);
+    EXPECT_TRUE(shape.clipped(20, 20).empty());
+}
+
+TEST(ShapeTest, doesntChangeShapesInsideWhenClipping) {
+    Shape shape = Shape::circle(IntVector(5, 5), 3.0f);
+    EXPECT_EQ(shape, shape.clipped(20, 20));
+}
+
+}
+}
@@ -0,0 +1,218 @@
+#include "../io/SnapshotFile.hpp"
+#include "../io/Scenario.hpp"
+#include "../io/IoException.hpp"
+#include "../game/Snapshot.hpp"
+#include "../game/State.hpp"
+#include "../game/Direction.hpp"
+#include "../game/Vector.hpp"
+#include "../game/MemoryUsage.hpp"
+
+#include <gtest/gtest.h>
+#include <string>
+#include <cstdio>
+#include <chrono>
+#include <vector>
+#include <cstdint>
+#include <map>
+
+namespace wotmin2d {
+namespace test {
+
+class SnapshotTest : public ::testing::Test {
+    protected:
+    SnapshotTest() :
+        path(::testing::TempDir() + "SnapshotTest.snapshot"),
+        state(60, 60) {
+        Scenario scenario(60, 60);
+        scenario.addCircle(0, IntVector(15, 15), 8.0f);
+        scenario.addRectangle(4, IntVector(35, 35), 12, 9);
+        scenario.setTarget(0, IntVector(50, 50), 30.0f);
+        scenario.setTarget(4, IntVector(5, 5), 30.0f);
+        scenario.populate(state);
+        state.selectParticles(IntVector(15, 15));
+        state.setTarget(0, IntVector(40, 10));
+        for (int i = 0; i < 20; i++) {
+            state.advance(std::chrono::milliseconds(50));
+        }
+    }
+    ~SnapshotTest() {
+        std::remove(path.c_str());
+    }
+    std::string path;
+    State<> state;
+};
+
+TEST_F(SnapshotTest, recordsAllParticles) {
+    StateSnapshot snapshot;
+    state.snapshot(snapshot);
+    EXPECT_EQ(60, snapshot.getArenaWidth());
+    EXPECT_EQ(60, snapshot.getArenaHeight());
+    EXPECT_EQ(IntVector(15, 15), snapshot.getSelectionCenter());
+    ASSERT_EQ(2, snapshot.getBlobs().size());
+    for (const auto& id_blob: state.getBlobs()) {
+        const BlobSnapshot& blob = snapshot.getBlobs().at(id_blob.first);
+        ASSERT_EQ(id_blob.second.getParticles().size(),
+                  blob.getParticles().size());
+        for (const ParticleRecord& record: blob.getParticles()) {
+            const Particle* particle = id_blob.second.getParticleAt(
+                IntVector(record.x, record.y));
+            ASSERT_NE(nullptr, particle);
+            EXPECT_EQ(particle->getPressure(),
+                      FloatVector(record.pressure_x, record.pressure_y));
+            EXPECT_EQ(particle->getHealth(), record.health);
+            EXPECT_EQ(particle->getTarget(),
+                      IntVector(record.target_x, record.target_y));
+        }
+    }
+}
+
+TEST_F(SnapshotTest, restoresState) {
+    StateSnapshot snapshot;
+    state.snapshot(snapshot);
+    State<> restored(60, 60);
+    restored.restore(snapshot);
+    StateSnapshot restored_snapshot;
+    restored.snapshot(restored_snapshot);
+    EXPECT_EQ(snapshot, restored_snapshot);
+    EXPECT_EQ(state.getSelectionRadius(), restored.getSelectionRadius());
+    for (const auto& id_blob: restored.getBlobs()) {
+        const Particle* highest
+            = id_blob.second.getHighestMobilityParticle();
+        const Particle* original
+            = state.getBlobs().at(id_blob.first).getHighestMobilityParticle();
+        ASSERT_NE(nullptr, highest);
+        EXPECT_EQ(original->getPosition(), highest->getPosition());
+        for (const Particle* particle: id_blob.second.getParticles()) {
+            for (Direction direction: Direction::all()) {
+                const Particle* neighbor
+                    = particle->getConstNeighbor(direction);
+                EXPECT_EQ(id_blob.second.getParticleAt(
+                              particle->getPosition() + direction.vector()),
+                          neighbor);
+            }
+        }
+    }
+}
+
+TEST_F(SnapshotTest, restoredStateContinuesIdentically) {
+    StateSnapshot snapshot;
+    state.snapshot(snapshot);
+    State<> restored(60, 60);
+    restored.restore(snapshot);
+    for (int i = 0; i < 30; i++) {
+        state.advance(std::chrono::milliseconds(50));
+        restored.advance(std::chrono::milliseconds(50));
+    }
+    StateSnapshot expected;
+    state.snapshot(expected);
+    StateSnapshot continued;
+    restored.snapshot(continued);
+    EXPECT_EQ(expected, continued);
+}
+
+TEST_F(SnapshotTest, restoreReplacesExistingBlobs) {
+    StateSnapshot snapshot;
+    state.snapshot(snapshot);
+    State<> restored(60, 60);
+    restored.emplaceBlob(9, IntVector(30, 30), 3.0f);
+    restored.restore(snapshot);
+    EXPECT_EQ(0, restored.getBlobs().count(9));
+    EXPECT_EQ(2, restored.getBlobs().size());
+}
+
+TEST_F(SnapshotTest, restoringAgainReusesMemory) {
+    StateSnapshot snapshot;
+    state.snapshot(snapshot);
+    state.restore(snapshot);
+    std::map<State<>::PlayerId, MemoryUsage> before = state.getMemoryUsage();
+    for (int i = 0; i < 5; i++) {
+        state.advance(std::chrono::milliseconds(50));
+    }
+    state.restore(snapshot);
+    std::map<State<>::PlayerId, MemoryUsage> after = state.getMemoryUsage();
+    ASSERT_EQ(before.size(), after.size());
+    for (const auto& id_usage: before) {
+        const MemoryUsage& usage = after.at(id_usage.first);
+        EXPECT_EQ(id_usage.second.getParticleBytes(),
+                  usage.getParticleBytes());
+        EXPECT_EQ(id_usage.second.getParticleSetBytes(),
+                  usage.getParticleSetBytes());
+        EXPECT_EQ(id_usage.second.getParticleMapBytes(),
+                  usage.getParticleMapBytes());
+    }
+}
+
+TEST_F(SnapshotTest, savesAndLoadsSnapshots) {
+    StateSnapshot snapshot;
+    state.snapshot(snapshot);
+    SnapshotFile::save(snapshot, path);
+    StateSnapshot loaded = SnapshotFile::load(path);
+    EXPECT_EQ(snapshot, loaded);
+    EXPECT_EQ(snapshot.getParticleCount(), loaded.getParticleCount());
+}
+
+TEST_F(SnapshotTest, rejectsInvalidRelations) {
+    StateSnapshot snapshot;
+    state.snapshot(snapshot);
+    BlobSnapshot& blob = snapshot.getBlobs().at(0);
+    blob.getParticles()[0].neighbors[0] = blob.getParticles().size();
+    SnapshotFile::save(snapshot, path);
+    EXPECT_THROW(SnapshotFile::load(path), IoException);
+}
+
+TEST_F(SnapshotTest, rejectsParticlesInSameCell) {
+    StateSnapshot snapshot;
+    state.snapshot(snapshot);
+    std::vector<ParticleRecord>& records
+        = snapshot.getBlobs().at(4).getParticles();
+    ASSERT_LT(1u, records.size());
+    records[1].x = records[0].x;
+    records[1].y = records[0].y;
+    SnapshotFile::save(snapshot, path);
+    EXPECT_THROW(SnapshotFile::load(path), IoException);
+}
+
+TEST_F(SnapshotTest, rejectsOneSidedNeighbors) {
+    StateSnapshot snapshot;
+    state.snapshot(snapshot);
+    std::vector<ParticleRecord>& records
+        = snapshot.getBlobs().at(4).getParticles();
+    // Forget the link back from the first particle with a neighbor.
+    bool unlinked = false;
+    for (ParticleRecord& record: records) {
+        for (Direction direction: Direction::all()) {
+            std::uint32_t neighbor
+                = record.neighbors[static_cast<Direction::val_t>(direction)];
+            if (!unlinked && neighbor != ParticleRecord::no_particle) {
+                records[neighbor].neighbors[static_cast<Direction::val_t>(
+                    direction.opposite())] = ParticleRecord::no_particle;
+                unlinked = true;
+            }
+        }
+    }
+    ASSERT_TRUE(unlinked);
+    SnapshotFile::save(snapshot, path);
+    EXPECT_THROW(SnapshotFile::load(path), IoException);
+}
+
+TEST_F(SnapshotTest, rejectsPlayersWithoutOwnerValue) {
+    StateSnapshot snapshot;
+    state.snapshot(snapshot);
+    std::map<StateSnapshot::PlayerId, BlobSnapshot>& blobs
+        = snapshot.getBlobs();
+    blobs[255] = blobs.at(4);
+    blobs.erase(4);
+    SnapshotFile::save(snapshot, path);
+    EXPECT_THROW(SnapshotFile::load(path), IoException);
+}
+
+TEST_F(SnapshotTest, rejectsParticlesOutsideArena) {
+    StateSnapshot snapshot;
+    state.snapshot(snapshot);
+    snapshot.getBlobs().at(4).getParticles()[0].x = 60;
+    SnapshotFile::save(snapshot, path);
+    EXPECT_THROW(SnapshotFile::load(path), IoException);
+}
+
+}
+}
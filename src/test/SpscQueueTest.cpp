@@ -0,0 +1,67 @@
+#include "../SpscQueue.hpp"
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+namespace wotmin2d {
+namespace test {
+
+TEST(SpscQueueTest, popsInOrder) {
+    SpscQueue<int> queue(4);
+    EXPECT_TRUE(queue.push(1));
+    EXPECT_TRUE(queue.push(2));
+    int value = 0;
+    EXPECT_TRUE(queue.pop(value));
+    EXPECT_EQ(1, value);
+    EXPECT_TRUE(queue.push(3));
+    EXPECT_TRUE(queue.pop(value));
+    EXPECT_EQ(2, value);
+    EXPECT_TRUE(queue.pop(value));
+    EXPECT_EQ(3, value);
+    EXPECT_FALSE(queue.pop(value));
+    EXPECT_EQ(3, value);
+}
+
+TEST(SpscQueueTest, refusesWhenFull) {
+    SpscQueue<std::unique_ptr<int>> queue(2);
+    EXPECT_TRUE(queue.push(std::unique_ptr<int>(new int(1))));
+    EXPECT_TRUE(queue.push(std::unique_ptr<int>(new int(2))));
+    std::unique_ptr<int> third(new int(3));
+    EXPECT_FALSE(queue.push(std::move(third)));
+    ASSERT_NE(nullptr, third);
+    std::unique_ptr<int> value;
+    EXPECT_TRUE(queue.pop(value));
+    EXPECT_EQ(1, *value);
+    EXPECT_TRUE(queue.push(std::move(third)));
+}
+
+TEST(SpscQueueTest, passesValuesBetweenThreads) {
+    const std::uint32_t count = 100000;
+    SpscQueue<std::uint32_t> queue(16);
+    std::thread producer([&queue, count]() {
+        for (std::uint32_t i = 0; i < count; i++) {
+            std::uint32_t value = i;
+            while (!queue.push(std::move(value))) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    std::uint32_t expected = 0;
+    bool in_order = true;
+    while (expected < count) {
+        std::uint32_t value;
+        if (queue.pop(value)) {
+            in_order = in_order && value == expected;
+            expected++;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    EXPECT_TRUE(in_order);
+}
+
+}
+}
@@ -0,0 +1,82 @@
+#include "BattleFixture.hpp"
+#include "../game/StateFork.hpp"
+#include "../game/State.hpp"
+#include "../game/Snapshot.hpp"
+#include "../game/Vector.hpp"
+
+#include <gtest/gtest.h>
+#include <chrono>
+
+namespace wotmin2d {
+namespace test {
+
+class StateForkTest : public BattleFixture {
+    protected:
+    StateForkTest() :
+        fork(width, height),
+        tick_duration(50) {
+        for (int i = 0; i < 10; i++) {
+            state.advance(tick_duration);
+        }
+    }
+    StateFork<> fork;
+    std::chrono::milliseconds tick_duration;
+};
+
+TEST_F(StateForkTest, copiesState) {
+    fork.reset(state);
+    EXPECT_EQ(snapshot(state), snapshot(fork.getState()));
+}
+
+TEST_F(StateForkTest, copiesSnapshotIntoManyForks) {
+    StateSnapshot source = snapshot(state);
+    StateFork<> other_fork(width, height);
+    fork.reset(source);
+    other_fork.reset(source);
+    fork.getState().setBlobTarget(0, IntVector(0, 59), 50.0f);
+    fork.advance(tick_duration, 5);
+    other_fork.advance(tick_duration, 5);
+    EXPECT_NE(snapshot(fork.getState()), snapshot(other_fork.getState()));
+    other_fork.reset(source);
+    EXPECT_EQ(snapshot(state), snapshot(other_fork.getState()));
+}
+
+TEST_F(StateForkTest, doesNotChangeOriginal) {
+    StateSnapshot original = snapshot(state);
+    fork.reset(state);
+    fork.getState().setBlobTarget(0, IntVector(0, 59), 50.0f);
+    fork.advance(tick_duration, 20);
+    EXPECT_EQ(original, snapshot(state));
+    EXPECT_NE(original, snapshot(fork.getState()));
+}
+
+TEST_F(StateForkTest, predictsOriginal) {
+    fork.reset(state);
+    fork.advance(tick_duration, 30);
+    for (int i = 0; i < 30; i++) {
+        state.advance(tick_duration);
+    }
+    EXPECT_EQ(snapshot(state), snapshot(fork.getState()));
+}
+
+TEST_F(StateForkTest, reusesMemoryWhenReset) {
+    fork.reset(state);
+    fork.advance(tick_duration, 5);
+    fork.reset(state);
+    std::size_t pool_bytes = 0;
+    for (const auto& id_usage: fork.getState().getMemoryUsage()) {
+        pool_bytes += id_usage.second.getParticleBytes();
+    }
+    for (int i = 0; i < 5; i++) {
+        fork.reset(state);
+        fork.advance(tick_duration, 5);
+    }
+    std::size_t reset_pool_bytes = 0;
+    for (const auto& id_usage: fork.getState().getMemoryUsage()) {
+        reset_pool_bytes += id_usage.second.getParticleBytes();
+    }
+    EXPECT_EQ(pool_bytes, reset_pool_bytes);
+}
+
+}
+}
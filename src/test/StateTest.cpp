@@ -15,6 +15,7 @@ using mock::NiceMockBlob;
 
 using ::testing::_;
 using ::testing::Return;
+using ::testing::DoAll;
 using ::testing::ReturnRefOfCopy;
 using ::testing::Ref;
 using ::testing::AnyNumber;
@@ -31,6 +32,7 @@ ACTION_P2(KillPressureInDirection, particle, direction) {
 
 ACTION_P2(MoveParticle, particle, direction) {
     particle->move({}, direction);
+    return true;
 }
 
 class StateTest : public ::testing::Test {
@@ -128,6 +130,31 @@ TEST_F(StateTest, letsBlobMoveSingleParticlesMultipleTimes) {
     state.advance(time_delta);
 }
 
+TEST_F(StateTest, countsMovesInProfile) {
+    td.makeParticles({}, { td.inSouthWestCorner });
+    state.emplaceBlob(0, IntVector(0, 0), 2);
+    B& blob = const_cast<B&>(state.getBlobs().at(0));
+    P* particle = td.particles[0];
+    ON_CALL(blob, getHighestMobilityParticle())
+        .WillByDefault(Return(particle));
+    ON_CALL(*particle, getPressureDirection())
+        .WillByDefault(Return(Direction::north()));
+    EXPECT_CALL(*particle, canMove())
+        .Times(AnyNumber())
+        .WillOnce(Return(true))
+        .WillOnce(Return(true))
+        .WillOnce(Return(true))
+        .WillRepeatedly(Return(false));
+    // The second one collides with a neighbor instead.
+    EXPECT_CALL(blob, handleParticle(Ref(*particle), Direction::north()))
+        .WillOnce(Return(true))
+        .WillOnce(Return(false))
+        .WillOnce(Return(true));
+    state.advance(time_delta);
+    EXPECT_EQ(2u, state.getProfile().moves);
+    EXPECT_EQ(0u, state.getProfile().hostile_collisions);
+}
+
 TEST_F(StateTest, letsBlobMoveParticlesIndependently) {
     td.makeParticles({}, { td.inSouthWestCorner, td.onSouthBorder });
     state.emplaceBlob(0, IntVector(0, 0), 2);
@@ -406,10 +433,12 @@ TEST_F(StateTest, doesntHandleHostileCollisionsWithinTheSameBlob) {
     left->advance({}, std::chrono::milliseconds(1000));
     EXPECT_CALL(blob, handleParticle(Ref(*right), Direction::west()))
         .Times(AnyNumber())
-        .WillRepeatedly(KillPressureInDirection(right, Direction::west()));
+        .WillRepeatedly(DoAll(KillPressureInDirection(right, Direction::west()),
+                              Return(false)));
     EXPECT_CALL(blob, handleParticle(Ref(*left), Direction::east()))
         .Times(AnyNumber())
-        .WillRepeatedly(KillPressureInDirection(left, Direction::east()));
+        .WillRepeatedly(DoAll(KillPressureInDirection(left, Direction::east()),
+                              Return(false)));
     EXPECT_CALL(blob, damageParticle(_, _)).Times(0);
     state.advance(time_delta);
 }
@@ -453,5 +482,32 @@ TEST_F(StateTest, calculatesAdvantageWhenDamagingParticles) {
     state.advance(time_delta);
 }
 
+TEST_F(StateTest, reportsMemoryUsagePerBlob) {
+    state.emplaceBlob(0, IntVector(0, 0), 2);
+    state.emplaceBlob(7, IntVector(5, 8), 4);
+    B& blob1 = const_cast<B&>(state.getBlobs().at(0));
+    B& blob2 = const_cast<B&>(state.getBlobs().at(7));
+    ON_CALL(blob1, getMemoryUsage())
+        .WillByDefault(Return(MemoryUsage(2, 20, 0, 30, 40)));
+    ON_CALL(blob2, getMemoryUsage())
+        .WillByDefault(Return(MemoryUsage(5, 50, 10, 60, 70)));
+    auto usage = state.getMemoryUsage();
+    ASSERT_EQ(2, usage.size());
+    EXPECT_EQ(2, usage.at(0).getParticleCount());
+    EXPECT_EQ(90, usage.at(0).getTotalBytes());
+    EXPECT_EQ(5, usage.at(7).getParticleCount());
+    EXPECT_EQ(190, usage.at(7).getTotalBytes());
+}
+
+TEST_F(StateTest, setsTargetOfWholeBlob) {
+    state.emplaceBlob(0, IntVector(0, 0), 2);
+    state.emplaceBlob(7, IntVector(5, 8), 4);
+    B& blob1 = const_cast<B&>(state.getBlobs().at(0));
+    B& blob2 = const_cast<B&>(state.getBlobs().at(7));
+    EXPECT_CALL(blob1, setTarget(_, _)).Times(0);
+    EXPECT_CALL(blob2, setTarget(IntVector(3, 4), 6.0f)).Times(1);
+    state.setBlobTarget(7, IntVector(3, 4), 6.0f);
+}
+
 }
 }
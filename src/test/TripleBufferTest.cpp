@@ -0,0 +1,74 @@
+#include "../TripleBuffer.hpp"
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace wotmin2d {
+namespace test {
+
+TEST(TripleBufferTest, startsWithoutValue) {
+    TripleBuffer<int> buffer;
+    EXPECT_FALSE(buffer.update());
+    EXPECT_EQ(0, buffer.getFront());
+}
+
+TEST(TripleBufferTest, readerGetsLatestValue) {
+    TripleBuffer<int> buffer;
+    buffer.getBack() = 1;
+    buffer.publish();
+    buffer.getBack() = 2;
+    buffer.publish();
+    EXPECT_TRUE(buffer.update());
+    EXPECT_EQ(2, buffer.getFront());
+    EXPECT_FALSE(buffer.update());
+    EXPECT_EQ(2, buffer.getFront());
+}
+
+TEST(TripleBufferTest, writerDoesNotTouchFront) {
+    TripleBuffer<int> buffer;
+    buffer.getBack() = 1;
+    buffer.publish();
+    ASSERT_TRUE(buffer.update());
+    for (int i = 2; i < 10; i++) {
+        buffer.getBack() = i;
+        buffer.publish();
+        EXPECT_EQ(1, buffer.getFront());
+    }
+    EXPECT_TRUE(buffer.update());
+    EXPECT_EQ(9, buffer.getFront());
+}
+
+// Every value is a vector filled with the same number, so a torn read shows
+// up as a vector with different numbers in it.
+TEST(TripleBufferTest, handsOverWholeValuesBetweenThreads) {
+    const std::uint32_t last = 20000;
+    TripleBuffer<std::vector<std::uint32_t>> buffer;
+    std::thread writer([&buffer, last]() {
+        for (std::uint32_t i = 1; i <= last; i++) {
+            buffer.getBack().assign(64, i);
+            buffer.publish();
+        }
+    });
+    std::uint32_t seen = 0;
+    bool consistent = true;
+    while (seen < last) {
+        if (!buffer.update()) {
+            std::this_thread::yield();
+            continue;
+        }
+        const std::vector<std::uint32_t>& front = buffer.getFront();
+        ASSERT_EQ(64u, front.size());
+        for (std::uint32_t value: front) {
+            consistent = consistent && value == front[0];
+        }
+        EXPECT_GT(front[0], seen);
+        seen = front[0];
+    }
+    writer.join();
+    EXPECT_TRUE(consistent);
+}
+
+}
+}
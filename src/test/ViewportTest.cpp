@@ -0,0 +1,84 @@
+#include "../display/Viewport.hpp"
+#include "../game/Vector.hpp"
+
+#include <gtest/gtest.h>
+
+namespace wotmin2d {
+namespace test {
+
+TEST(ViewportTest, fitsSmallArenaByZoomingIn) {
+    Viewport viewport(100, 50, 1000, 1000);
+    EXPECT_EQ(3, viewport.getZoom());
+    EXPECT_EQ(8u, viewport.getPixelsPerSample());
+    EXPECT_EQ(125u, viewport.getColumns());
+    // Centered: 125 samples show 100 cells.
+    EXPECT_EQ(IntVector(-12, -37), viewport.getOrigin());
+    EXPECT_EQ(IntVector(0, 0), viewport.getVisibleBegin());
+    EXPECT_EQ(IntVector(100, 50), viewport.getVisibleEnd());
+}
+
+TEST(ViewportTest, fitsLargeArenaByZoomingOut) {
+    Viewport viewport(20000, 10000, 1000, 800);
+    EXPECT_EQ(-5, viewport.getZoom());
+    EXPECT_EQ(32u, viewport.getCellsPerSample());
+    EXPECT_EQ(1000u, viewport.getColumns());
+    EXPECT_EQ(800u, viewport.getRows());
+}
+
+TEST(ViewportTest, alignsOriginToSamplesWhenZoomedOut) {
+    Viewport viewport(1000, 1000, 100, 100);
+    ASSERT_EQ(-4, viewport.getZoom());
+    // Centering would put the origin at -300.
+    EXPECT_EQ(IntVector(-304, -304), viewport.getOrigin());
+    viewport.zoom(2, IntVector(37, 51));
+    EXPECT_EQ(0, viewport.getOrigin().getX() % 4);
+    EXPECT_EQ(0, viewport.getOrigin().getY() % 4);
+}
+
+TEST(ViewportTest, convertsWindowCoordinates) {
+    Viewport viewport(100, 100, 200, 200);
+    ASSERT_EQ(1, viewport.getZoom());
+    // Window coordinates start at the top left, arena ones at the bottom left.
+    EXPECT_EQ(IntVector(0, 99), viewport.windowToArena(IntVector(0, 0)));
+    EXPECT_EQ(IntVector(5, 97), viewport.windowToArena(IntVector(11, 5)));
+    EXPECT_EQ(IntVector(99, 0), viewport.windowToArena(IntVector(250, 250)));
+}
+
+TEST(ViewportTest, convertsArenaPositionsToWindow) {
+    Viewport viewport(100, 100, 200, 200);
+    FloatVector center = viewport.arenaToWindow(FloatVector(5.5f, 97.5f));
+    EXPECT_FLOAT_EQ(11.0f, center.getX());
+    EXPECT_FLOAT_EQ(5.0f, center.getY());
+    IntVector pixel(static_cast<int>(center.getX()),
+                    static_cast<int>(center.getY()));
+    EXPECT_EQ(IntVector(5, 97), viewport.windowToArena(pixel));
+}
+
+TEST(ViewportTest, zoomsAroundAnchor) {
+    Viewport viewport(1000, 1000, 100, 100);
+    ASSERT_EQ(-4, viewport.getZoom());
+    IntVector anchor(30, 60);
+    IntVector cell = viewport.windowToArena(anchor);
+    viewport.zoom(4, anchor);
+    EXPECT_EQ(0, viewport.getZoom());
+    EXPECT_EQ(cell, viewport.windowToArena(anchor));
+    viewport.zoom(100, anchor);
+    EXPECT_EQ(Viewport::max_zoom + 0, viewport.getZoom());
+}
+
+TEST(ViewportTest, keepsLargeArenaInView) {
+    Viewport viewport(1000, 1000, 100, 100);
+    viewport.zoom(4, IntVector(0, 99));
+    EXPECT_EQ(IntVector(0, 0), viewport.getOrigin());
+    viewport.pan(IntVector(-1, -1));
+    EXPECT_EQ(IntVector(0, 0), viewport.getOrigin());
+    viewport.pan(IntVector(1, 2));
+    EXPECT_EQ(IntVector(12, 24), viewport.getOrigin());
+    for (int i = 0; i < 100; i++) {
+        viewport.pan(IntVector(1, 1));
+    }
+    EXPECT_EQ(IntVector(900, 900), viewport.getOrigin());
+}
+
+}
+}
@@ -0,0 +1,50 @@
+#include "../WorkerPool.hpp"
+
+#include <gtest/gtest.h>
+#include <vector>
+#include <atomic>
+#include <thread>
+
+namespace wotmin2d {
+namespace test {
+
+TEST(WorkerPoolTest, runsEveryTaskOnce) {
+    WorkerPool pool(4);
+    EXPECT_EQ(4u, pool.getThreadCount());
+    std::vector<std::atomic<int>> calls(100);
+    for (std::atomic<int>& count: calls) {
+        count = 0;
+    }
+    pool.run(100, [&](unsigned int index) { calls[index]++; });
+    for (const std::atomic<int>& count: calls) {
+        EXPECT_EQ(1, count);
+    }
+}
+
+TEST(WorkerPoolTest, runsManyBatches) {
+    WorkerPool pool(3);
+    std::atomic<unsigned int> total(0);
+    for (unsigned int batch = 0; batch < 1000; batch++) {
+        pool.run(3, [&](unsigned int index) { total += index + 1; });
+        ASSERT_EQ((batch + 1) * 6, total);
+    }
+}
+
+TEST(WorkerPoolTest, runsOnCallerWithOneThread) {
+    WorkerPool pool(1);
+    EXPECT_EQ(1u, pool.getThreadCount());
+    std::thread::id caller = std::this_thread::get_id();
+    pool.run(5, [&](unsigned int) {
+        EXPECT_EQ(caller, std::this_thread::get_id());
+    });
+}
+
+TEST(WorkerPoolTest, doesNothingWithoutTasks) {
+    WorkerPool pool(2);
+    bool called = false;
+    pool.run(0, [&](unsigned int) { called = true; });
+    EXPECT_FALSE(called);
+}
+
+}
+}
@@ -4,6 +4,8 @@
 #include "../../game/Direction.hpp"
 #include "../../game/Blob.hpp"
 #include "../../game/BlobState.hpp"
+#include "../../game/MemoryUsage.hpp"
+#include "../../game/CircleMask.hpp"
 #include "MockParticle.hpp"
 
 #include <gmock/gmock.h>
@@ -26,12 +28,16 @@ class MockBlob {
     MOCK_CONST_METHOD0(getHighestMobilityParticle, P*());
     MOCK_METHOD4(setTarget, void(const IntVector& target,
                                  float pressure_per_second,
-                                 const IntVector& center, float radius));
+                                 const IntVector& center,
+                                 const CircleMask& selection));
+    MOCK_METHOD2(setTarget, void(const IntVector& target,
+                                 float pressure_per_second));
     MOCK_METHOD2(collideParticleWithWall,
                  void(P& particle, Direction collision_direction));
     MOCK_METHOD2(handleParticle,
-                 void(P& particle, Direction collision_direction));
+                 bool(P& particle, Direction collision_direction));
     MOCK_CONST_METHOD1(getParticleStrength, int(const P& particle));
+    MOCK_CONST_METHOD0(getMemoryUsage, MemoryUsage());
 };
 
 // Subclass NiceMock to allow copying. This is necessary to allow them to be
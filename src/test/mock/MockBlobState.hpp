@@ -2,6 +2,7 @@
 #define MOCKBLOBSTATE_HPP
 
 #include "../../game/Direction.hpp"
+#include "../../game/Shape.hpp"
 #include "MockParticle.hpp"
 
 #include <gmock/gmock.h>
@@ -24,6 +25,7 @@ class MockBlobState {
     }
     MOCK_CONST_METHOD0(getParticles, const std::vector<P*>&());
     MOCK_METHOD1(addParticle, void(const IntVector& position));
+    MOCK_METHOD1(addParticles, void(const Shape& shape));
     MOCK_METHOD2(moveParticle, void(const P& particle,
                                     Direction movement_direction));
     MOCK_METHOD3(collideParticles, void(P& first, P& second,
@@ -24,6 +24,7 @@ using ::testing::ReturnRefOfCopy;
 
 class MockParticle {
     public:
+    using Config = wotmin2d::Config;
     class BlobStateKey {};
     MockParticle(IntVector position) :
         real_particle(position),
@@ -57,6 +58,8 @@ class MockParticle {
                                   &MockParticle::callKillPressureInDirection));
         ON_CALL(*this, canMove())
             .WillByDefault(Invoke(&real_particle, &Particle::canMove));
+        ON_CALL(*this, getMobility())
+            .WillByDefault(Invoke(this, &MockParticle::callGetMobility));
         ON_CALL(*this, getFollowers(_))
             .WillByDefault(
                 ReturnRefOfCopy(std::unordered_set<NiceMockParticle*>())
@@ -93,6 +96,8 @@ class MockParticle {
     MOCK_METHOD2(killPressureInDirection, void(BlobStateKey,
                                                Direction direction));
     MOCK_CONST_METHOD0(canMove, bool());
+    MOCK_CONST_METHOD0(getMobility, float());
+    MOCK_METHOD1(updateMobility, void(BlobStateKey));
     MOCK_METHOD2(addFollowers, void(BlobStateKey,
                                     const std::vector<NiceMockParticle*>&
                                         new_followers));
@@ -132,6 +137,12 @@ class MockParticle {
     void callKillPressureInDirection(BlobStateKey, Direction direction) {
         real_particle.killPressureInDirection({}, direction);
     }
+    // Computed from the real particle on every call instead of being cached.
+    // Doesn't go through the mocked canMove(), whose calls tests count.
+    float callGetMobility() const {
+        return real_particle.canMove()
+            ? real_particle.getPressure().squaredNorm() : -1.0f;
+    }
     void callDamage(BlobStateKey, unsigned int amount) {
         real_particle.damage({}, amount);
     }